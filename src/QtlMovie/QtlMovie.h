@@ -56,8 +56,6 @@
 #define QTL_TRANSCODE_SECONDS                  0  //!< Number of seconds to transcode if not complete video.
 #define QTL_KEEP_INTERMEDIATE_FILES        false  //!< Keep intermediate transcoding files.
 #define QTL_FFMPEG_PROBE_SECONDS             200  //!< Initial probe size in media playout seconds for ffprobe / ffmpeg.
-#define QTL_FFPROBE_DVD_DIVISOR_2              5  //!< On DVD's, a second shorter ffprobe is run.
-#define QTL_FFPROBE_DVD_DIVISOR_3             20  //!< On DVD's, a third shorter ffprobe is run.
 #define QTL_SRT_USE_VIDEO_SIZE_HINT        false  //!< Check if the insertion of SRT/SSA/ASS subtitles shall use the original video size as a hint.
 #define QTL_CHAPTER_MINUTES                    5  //!< Duration of chapters to create.
 #define QTL_DVD_REMUX_AFTER_TRANSCODE       true  //!< If audio/video must be remuxed after transcode for DVD output.
@@ -79,6 +77,7 @@
 #define QTL_CAPITALIZE_CC                  false  //!< Capitalize US Closed Captions (suppress ALL CAPS).
 #define QTL_DVD_EXTRACT_DIR_TREE            true  //!< Recreate directory tree when extracting DVD.
 #define QTL_DVD_MAX_SPEED                   true  //!< Set DVD read speed to maximum.
+#define QTL_DVD_KEY_CACHE                   true  //!< Keep DVD encryption keys in a persistent cache.
 #define QTL_CLEANUP_SUBTITLES               true  //!< Cleanup SRT/SSA/ASS subtitles files before burning.
 #define QTL_SRT_HTML_TAGS                   true  //!< Add HTML tags in SRT subtitles when converting from SSA/ASS.
 #define QTL_DOWNGRADE_SSA_TO_SRT           false  //!< Downgrade SSA/ASS subtitles to SRT before burning?
@@ -87,6 +86,9 @@
 #define QTL_DVD_ANGLE                          1  //!< Default angle to extract in a DVD program chain.
 #define QTL_DVD_BURNING_SPEED                  0  //!< DVD burning speed as Nx, 0 means use current/default speed.
 #define QTL_FFMPEG_LOW_PRIORITY             true  //!< Run FFmpeg processes at a lower priority.
+#define QTL_MAX_CONCURRENT_JOBS                1  //!< Maximum number of concurrent transcoding jobs in batch mode.
+#define QTL_MAX_PARALLEL_ACTIONS               2  //!< Maximum number of concurrent independent actions in a transcoding job.
+#define QTL_MEDIA_CACHE_SIZE                1000  //!< Maximum number of files in the media analysis cache, 0 to disable.
 
 //
 // Transcoding presets.
@@ -132,6 +134,15 @@
 //!
 #define QTL_DVD_ISO_MAX_SIZE (Q_UINT64_C(4700000000))
 
+//!
+//! Suffix of the bad sector map file of a DVD ISO image.
+//!
+//! When a DVD ISO image is extracted, the unreadable sectors are replaced
+//! by zeroes and their list is saved in a file with the same name as the
+//! image plus this suffix. A later extraction can retry only these sectors.
+//!
+#define QTL_DVD_BAD_SECTOR_MAP_SUFFIX ".badsectors"
+
 //!
 //! Log level for FFmpeg.
 //!
@@ -161,10 +172,37 @@
 #define QTL_FFMPEG_LOGLEVEL  "warning"
 
 //!
-//! Number of MPEG Transport Stream packets to read at a time when
-//! searching for Teletext subtitles.
+//! Number of MPEG Transport Stream packets to read at a time in the
+//! demux thread when analyzing TS files (Teletext search or extraction).
+//!
+#define QTL_TS_PACKETS_CHUNK 1000
+
+//!
+//! Maximum number of concurrent analyses of input files on the same storage device.
+//! The global number of concurrent analyses is limited by the number of processors.
+//!
+#define QTL_MAX_ANALYSES_PER_DEVICE 2
+
+//!
+//! Maximum number of threads to give to one FFmpeg encoding process.
+//! Most encoders do not scale beyond that, remaining processors are better
+//! used by other concurrent jobs in batch mode.
+//!
+#define QTL_MAX_FFMPEG_THREADS 8
+
+//!
+//! Expected costs of actions in a transcoding job, used to weight the job progress.
+//! The costs are relative to each other and are only rough estimates.
+//!
+#define QTL_ACTION_COST_FILE      1  //!< Processing of a small file (subtitles, cleanup).
+#define QTL_ACTION_COST_MEDIA     5  //!< Processing which reads or writes the complete media.
+#define QTL_ACTION_COST_ENCODING 20  //!< Video encoding of the complete media.
+
+//!
+//! Number of bytes at the beginning and at the end of an input file which are
+//! hashed to identify the file in the media analysis cache.
 //!
-#define QTL_TS_PACKETS_CHUNK 100
+#define QTL_MEDIA_CACHE_HASH_SIZE (2 * 1024 * 1024)
 
 //!
 //! Number of bytes to read at a time when processing files in event loop.
@@ -181,4 +219,16 @@
 //!
 #define QTL_AUDIO_FILTER_VARREF "{" QTL_AUDIO_FILTER_VARNAME "}"
 
+//!
+//! Name of the "Job Variable" (see @link QtlMovieJob::setVariable() @endlink) for the
+//! FFmpeg "-threads" option of video encoders. Resolved when each process starts
+//! since the number of threads depends on the number of concurrent encodings.
+//!
+#define QTL_FFMPEG_THREADS_VARNAME "FFMPEGTHREADS"
+
+//!
+//! Reference to the "Job Variable" (see @link QtlMovieJob::setVariable() @endlink) for FFmpeg threads.
+//!
+#define QTL_FFMPEG_THREADS_VARREF "{" QTL_FFMPEG_THREADS_VARNAME "}"
+
 #endif // QTLMOVIE_H
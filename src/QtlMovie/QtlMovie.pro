@@ -54,6 +54,7 @@ SOURCES += main.cpp \
     QtlMovieFFmpegProcess.cpp \
     QtlMovieAboutMediaTools.cpp \
     QtlMovieProcess.cpp \
+    QtlMovieProcessDataPull.cpp \
     QtlMovieJob.cpp \
     QtlMovieAction.cpp \
     QtlMovieDvdAuthorProcess.cpp \
@@ -81,7 +82,9 @@ SOURCES += main.cpp \
     QtlMovieConvertSubStationAlpha.cpp \
     QtlMovieNewVersion.cpp \
     QtlMovieHelp.cpp \
-    QtlMovieVersion.cpp
+    QtlMovieVersion.cpp \
+    QtlMovieAnalysisScheduler.cpp \
+    QtlMovieMediaCache.cpp
 
 HEADERS += \
     QtlMovieMainWindow.h \
@@ -97,6 +100,7 @@ HEADERS += \
     QtlMovieAboutMediaTools.h \
     QtlMovie.h \
     QtlMovieProcess.h \
+    QtlMovieProcessDataPull.h \
     QtlMovieJob.h \
     QtlMovieAction.h \
     QtlMovieDvdAuthorProcess.h \
@@ -123,7 +127,9 @@ HEADERS += \
     QtlMovieCleanupSubtitles.h \
     QtlMovieConvertSubStationAlpha.h \
     QtlMovieNewVersion.h \
-    QtlMovieHelp.h
+    QtlMovieHelp.h \
+    QtlMovieAnalysisScheduler.h \
+    QtlMovieMediaCache.h
 
 FORMS += QtlMovieMainWindow.ui \
     QtlMovieEditSettings.ui \
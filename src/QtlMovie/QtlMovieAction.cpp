@@ -31,6 +31,7 @@
 //----------------------------------------------------------------------------
 
 #include "QtlMovieAction.h"
+#include "QtlFile.h"
 
 
 
@@ -46,7 +47,11 @@ QtlMovieAction::QtlMovieAction(const QtlMovieSettings* settings, QtlLogger* log,
     _startTime(),
     _started(false),
     _completed(false),
-    _silent(false)
+    _silent(false),
+    _filesDeclared(false),
+    _inputFiles(),
+    _outputFiles(),
+    _cost(1)
 {
     Q_ASSERT(log != 0);
     Q_ASSERT(settings != 0);
@@ -84,6 +89,54 @@ void QtlMovieAction::debug(const QString& line, const QColor& color)
 }
 
 
+//----------------------------------------------------------------------------
+// Declare the files which are used by the action.
+//----------------------------------------------------------------------------
+
+void QtlMovieAction::addInputFile(const QString& fileName)
+{
+    _filesDeclared = true;
+    if (!fileName.isEmpty()) {
+        _inputFiles.insert(QtlFile::absoluteNativeFilePath(fileName));
+    }
+}
+
+void QtlMovieAction::addOutputFile(const QString& fileName)
+{
+    _filesDeclared = true;
+    if (!fileName.isEmpty()) {
+        _outputFiles.insert(QtlFile::absoluteNativeFilePath(fileName));
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Check if this action depends on another action.
+//----------------------------------------------------------------------------
+
+bool QtlMovieAction::dependsOn(const QtlMovieAction* previous) const
+{
+    // Actions without declared files are barriers. Otherwise, there is a dependency
+    // when one action writes a file which is read or written by the other one.
+    return previous != 0 &&
+            (!_filesDeclared ||
+             !previous->_filesDeclared ||
+             haveCommonFiles(_inputFiles, previous->_outputFiles) ||
+             haveCommonFiles(_outputFiles, previous->_inputFiles) ||
+             haveCommonFiles(_outputFiles, previous->_outputFiles));
+}
+
+bool QtlMovieAction::haveCommonFiles(const QSet<QString>& set1, const QSet<QString>& set2)
+{
+    foreach (const QString& file, set1) {
+        if (set2.contains(file)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+
 //----------------------------------------------------------------------------
 // Start the action.
 //----------------------------------------------------------------------------
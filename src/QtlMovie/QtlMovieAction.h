@@ -147,6 +147,57 @@ public:
         _silent = silent;
     }
 
+    //!
+    //! Declare a file which is read by the action.
+    //! When an action declares its files, a job may run it concurrently with other actions
+    //! which do not use the same files. An action which declares no file at all is executed
+    //! alone, after all previous actions and before all next ones.
+    //! @param [in] fileName File name.
+    //!
+    void addInputFile(const QString& fileName);
+
+    //!
+    //! Declare a file which is created, modified or deleted by the action.
+    //! @param [in] fileName File name.
+    //! @see addInputFile()
+    //!
+    void addOutputFile(const QString& fileName);
+
+    //!
+    //! Check if the action declared the files it uses.
+    //! @return True if addInputFile() or addOutputFile() was called at least once.
+    //!
+    bool hasDeclaredFiles() const
+    {
+        return _filesDeclared;
+    }
+
+    //!
+    //! Check if this action depends on another action which is scheduled before it.
+    //! @param [in] previous An action which is scheduled before this one.
+    //! @return True if this action cannot start before @a previous is completed.
+    //!
+    bool dependsOn(const QtlMovieAction* previous) const;
+
+    //!
+    //! Get the expected cost of the action, relatively to other actions in the same job.
+    //! @return The expected cost of the action.
+    //!
+    int cost() const
+    {
+        return _cost;
+    }
+
+    //!
+    //! Set the expected cost of the action, relatively to other actions in the same job.
+    //! This is used to weight the progress of the job. The default cost is 1.
+    //! @param [in] cost The expected cost of the action.
+    //!
+    void setCost(int cost)
+    {
+        _cost = qMax(0, cost);
+    }
+
     //!
     //! Log text.
     //! Implementation of QtlLogger.
@@ -214,13 +265,25 @@ protected:
     virtual void emitCompleted(bool success, const QString& message = QString());
 
 private:
-    const QtlMovieSettings* _settings;    //!< Application settings.
-    QtlLogger*              _log;         //!< Message logger.
-    QString                 _description; //!< Description of the operation.
-    QDateTime               _startTime;   //!< Start time.
-    bool                    _started;     //!< start() was called.
-    bool                    _completed;   //!< completed() has been signaled.
-    bool                    _silent;      //!< Do not report unimportant messages.
+    const QtlMovieSettings* _settings;      //!< Application settings.
+    QtlLogger*              _log;           //!< Message logger.
+    QString                 _description;   //!< Description of the operation.
+    QDateTime               _startTime;     //!< Start time.
+    bool                    _started;       //!< start() was called.
+    bool                    _completed;     //!< completed() has been signaled.
+    bool                    _silent;        //!< Do not report unimportant messages.
+    bool                    _filesDeclared; //!< Input or output files were declared.
+    QSet<QString>           _inputFiles;    //!< Files which are read by the action.
+    QSet<QString>           _outputFiles;   //!< Files which are written by the action.
+    int                     _cost;          //!< Expected cost of the action.
+
+    //!
+    //! Check if two sets of files have at least one file in common.
+    //! @param [in] set1 First set of files.
+    //! @param [in] set2 Second set of files.
+    //! @return True if @a set1 and @a set2 have at least one file in common.
+    //!
+    static bool haveCommonFiles(const QSet<QString>& set1, const QSet<QString>& set2);
 
     // Unaccessible operations.
     QtlMovieAction() Q_DECL_EQ_DELETE;
@@ -0,0 +1,181 @@
+//----------------------------------------------------------------------------
+//
+// Copyright (c) 2013-2017, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//
+// Define the class QtlMovieAnalysisScheduler.
+//
+//----------------------------------------------------------------------------
+
+#include "QtlMovieAnalysisScheduler.h"
+#include "QtlMovieInputFile.h"
+#include "QtlMovie.h"
+#include "QtlSysInfo.h"
+#include "QtlFile.h"
+
+
+//----------------------------------------------------------------------------
+// Constructor and single instance.
+//----------------------------------------------------------------------------
+
+QtlMovieAnalysisScheduler::QtlMovieAnalysisScheduler() :
+    QObject(),
+    _maxAnalyses(qMax(1, QtlSysInfo::numberOfProcessors(1))),
+    _maxPerDevice(QTL_MAX_ANALYSES_PER_DEVICE),
+    _pending(),
+    _running(),
+    _deviceCount()
+{
+}
+
+QtlMovieAnalysisScheduler* QtlMovieAnalysisScheduler::instance()
+{
+    // Used in the application thread only, no need to synchronize.
+    static QtlMovieAnalysisScheduler* _instance = 0;
+    if (_instance == 0) {
+        _instance = new QtlMovieAnalysisScheduler();
+    }
+    return _instance;
+}
+
+
+//----------------------------------------------------------------------------
+// Set the limits of concurrent analyses.
+//----------------------------------------------------------------------------
+
+void QtlMovieAnalysisScheduler::setLimits(int maxAnalyses, int maxPerDevice)
+{
+    _maxAnalyses = qMax(1, maxAnalyses);
+    _maxPerDevice = qMax(1, maxPerDevice);
+    schedule();
+}
+
+
+//----------------------------------------------------------------------------
+// Get a string identifying the storage device of a file.
+//----------------------------------------------------------------------------
+
+QString QtlMovieAnalysisScheduler::storageDevice(const QString& fileName)
+{
+    const QStorageInfo si(QtlFile::absoluteNativeFilePath(fileName));
+    return si.isValid() ? QString::fromUtf8(si.device()) : QString();
+}
+
+
+//----------------------------------------------------------------------------
+// Request a slot for the analysis of an input file.
+//----------------------------------------------------------------------------
+
+void QtlMovieAnalysisScheduler::requestAnalysis(QtlMovieInputFile* file, const QString& fileName)
+{
+    if (file == 0) {
+        return;
+    }
+
+    // A new request replaces a running analysis for the same file.
+    if (_running.contains(file)) {
+        releaseAnalysis(file);
+    }
+
+    // If a request is already pending, update its device but keep its position.
+    const QString device(storageDevice(fileName));
+    for (RequestList::Iterator it = _pending.begin(); it != _pending.end(); ++it) {
+        if (it->file == file) {
+            it->device = device;
+            schedule();
+            return;
+        }
+    }
+
+    // Queue a new request. Get notified of the destruction of the file.
+    _pending.append(Request(file, device));
+    connect(file, &QObject::destroyed, this, &QtlMovieAnalysisScheduler::fileDestroyed, Qt::UniqueConnection);
+    schedule();
+}
+
+
+//----------------------------------------------------------------------------
+// Release the analysis slot of an input file.
+//----------------------------------------------------------------------------
+
+void QtlMovieAnalysisScheduler::releaseAnalysis(const QObject* file)
+{
+    // Remove pending requests for this file.
+    for (RequestList::Iterator it = _pending.begin(); it != _pending.end(); ) {
+        if (it->file == file) {
+            it = _pending.erase(it);
+        }
+        else {
+            ++it;
+        }
+    }
+
+    // Release the slot of a running analysis.
+    const RunningMap::Iterator it = _running.find(file);
+    if (it != _running.end()) {
+        if (--_deviceCount[it.value()] <= 0) {
+            _deviceCount.remove(it.value());
+        }
+        _running.erase(it);
+        schedule();
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Invoked when an input file is destroyed.
+//----------------------------------------------------------------------------
+
+void QtlMovieAnalysisScheduler::fileDestroyed(QObject* object)
+{
+    releaseAnalysis(object);
+}
+
+
+//----------------------------------------------------------------------------
+// Start as many pending analyses as allowed.
+//----------------------------------------------------------------------------
+
+void QtlMovieAnalysisScheduler::schedule()
+{
+    // Pending requests are started in order of submission, except that a request
+    // on a busy device does not prevent the start of requests on other devices.
+    for (RequestList::Iterator it = _pending.begin(); it != _pending.end() && _running.size() < _maxAnalyses; ) {
+        if (_deviceCount.value(it->device, 0) >= _maxPerDevice) {
+            ++it;
+        }
+        else {
+            // Grant the slot before starting the analysis since the analysis may complete immediately.
+            QtlMovieInputFile* const file = it->file;
+            _running.insert(file, it->device);
+            _deviceCount[it->device]++;
+            it = _pending.erase(it);
+            file->startAnalysis();
+            // The list of requests may have been modified, restart from the beginning.
+            it = _pending.begin();
+        }
+    }
+}
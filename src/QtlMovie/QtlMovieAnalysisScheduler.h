@@ -0,0 +1,181 @@
+//----------------------------------------------------------------------------
+//
+// Copyright (c) 2013-2017, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//!
+//! @file QtlMovieAnalysisScheduler.h
+//!
+//! Declare the class QtlMovieAnalysisScheduler.
+//!
+//----------------------------------------------------------------------------
+
+#ifndef QTLMOVIEANALYSISSCHEDULER_H
+#define QTLMOVIEANALYSISSCHEDULER_H
+
+#include "QtlCore.h"
+
+class QtlMovieInputFile;
+
+//!
+//! A scheduler which bounds the number of concurrent media analyses of input files.
+//!
+//! Each QtlMovieInputFile runs ffprobe and searches for Teletext and Closed Captions
+//! when its file name changes. When many files are added at once in the task list,
+//! starting all analyses together overloads the processors and the disks. The input
+//! files request a slot from the single instance of this class and start their analysis
+//! when the slot is granted, in the order of the requests.
+//!
+//! The number of concurrent analyses is limited by the number of processors in the
+//! system. In addition, the number of concurrent analyses on files from the same
+//! storage device is limited since the analyses of files from distinct disks can
+//! run in parallel while files on the same disk compete for the same I/O bandwidth.
+//!
+class QtlMovieAnalysisScheduler : public QObject
+{
+    Q_OBJECT
+
+public:
+    //!
+    //! Get the single instance of QtlMovieAnalysisScheduler.
+    //! Must be used in the application thread only.
+    //! @return The single instance of QtlMovieAnalysisScheduler.
+    //!
+    static QtlMovieAnalysisScheduler* instance();
+
+    //!
+    //! Request a slot for the analysis of an input file.
+    //! When the slot is granted, QtlMovieInputFile::startAnalysis() is invoked, possibly immediately.
+    //! If the input file already has a pending request, it keeps its position in the queue.
+    //! @param [in] file The input file to analyze.
+    //! @param [in] fileName The path of the file to analyze, used to identify its storage device.
+    //!
+    void requestAnalysis(QtlMovieInputFile* file, const QString& fileName);
+
+    //!
+    //! Release the analysis slot of an input file.
+    //! Must be invoked when the analysis of the file is completed.
+    //! If the analysis was not yet started, the request is cancelled.
+    //! @param [in] file The input file.
+    //!
+    void releaseAnalysis(const QObject* file);
+
+    //!
+    //! Get the maximum number of concurrent analyses.
+    //! @return The maximum number of concurrent analyses.
+    //!
+    int maxAnalyses() const
+    {
+        return _maxAnalyses;
+    }
+
+    //!
+    //! Get the maximum number of concurrent analyses on the same storage device.
+    //! @return The maximum number of concurrent analyses on the same storage device.
+    //!
+    int maxAnalysesPerDevice() const
+    {
+        return _maxPerDevice;
+    }
+
+    //!
+    //! Set the limits of concurrent analyses.
+    //! @param [in] maxAnalyses Maximum number of concurrent analyses.
+    //! @param [in] maxPerDevice Maximum number of concurrent analyses on the same storage device.
+    //!
+    void setLimits(int maxAnalyses, int maxPerDevice);
+
+    //!
+    //! Get the number of running analyses.
+    //! @return The number of running analyses.
+    //!
+    int runningCount() const
+    {
+        return _running.size();
+    }
+
+    //!
+    //! Get the number of pending analysis requests.
+    //! @return The number of pending analysis requests.
+    //!
+    int pendingCount() const
+    {
+        return _pending.size();
+    }
+
+private slots:
+    //!
+    //! Invoked when an input file is destroyed.
+    //! @param [in] object The destroyed input file.
+    //!
+    void fileDestroyed(QObject* object);
+
+private:
+    //!
+    //! Description of an analysis request.
+    //!
+    struct Request
+    {
+        QtlMovieInputFile* file;    //!< The input file to analyze.
+        QString            device;  //!< Storage device of the file.
+        //!
+        //! Constructor.
+        //! @param [in] f The input file to analyze.
+        //! @param [in] d Storage device of the file.
+        //!
+        Request(QtlMovieInputFile* f = 0, const QString& d = QString()) : file(f), device(d) {}
+    };
+
+    typedef QList<Request> RequestList;               //!< List of analysis requests.
+    typedef QMap<const QObject*,QString> RunningMap;  //!< Storage device of running analyses, indexed by file.
+
+    int               _maxAnalyses;   //!< Maximum number of concurrent analyses.
+    int               _maxPerDevice;  //!< Maximum number of concurrent analyses per device.
+    RequestList       _pending;       //!< Pending requests, in order of submission.
+    RunningMap        _running;       //!< Running analyses.
+    QMap<QString,int> _deviceCount;   //!< Number of running analyses per storage device.
+
+    //!
+    //! Private constructor.
+    //!
+    QtlMovieAnalysisScheduler();
+
+    //!
+    //! Start as many pending analyses as allowed.
+    //!
+    void schedule();
+
+    //!
+    //! Get a string identifying the storage device of a file.
+    //! @param [in] fileName Path of a file.
+    //! @return A string identifying the storage device of the file.
+    //!
+    static QString storageDevice(const QString& fileName);
+
+    // Unaccessible operations.
+    Q_DISABLE_COPY(QtlMovieAnalysisScheduler)
+};
+
+#endif // QTLMOVIEANALYSISSCHEDULER_H
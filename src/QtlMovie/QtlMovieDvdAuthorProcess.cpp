@@ -41,8 +41,9 @@
 QtlMovieDvdAuthorProcess::QtlMovieDvdAuthorProcess(const QStringList& arguments,
                                                    const QtlMovieSettings* settings,
                                                    QtlLogger* log,
-                                                   QObject* parent) :
-    QtlMovieProcess(settings->dvdauthor(), arguments, false, settings, log, parent),
+                                                   QObject* parent,
+                                                   QtlDataPull* dataPull) :
+    QtlMovieProcess(settings->dvdauthor(), arguments, false, settings, log, parent, dataPull),
     _fileSize(-1)
 {
 }
@@ -122,6 +123,10 @@ void QtlMovieDvdAuthorProcess::processOutputLine(QProcess::ProcessChannel channe
         // so that full progression is 50% of the total.
         emitProgress(mb, 2 * totalMb);
     }
+    else if (mb >= 0) {
+        // Progression indicator in pass 1 when the input is a pipe. The total size
+        // is unknown, the progression is reported by the process which feeds us.
+    }
     else if (percent >= 0) {
         // Progression indicator in pass 2.
         // Adjust so that 0% of pass 2 means 50% of the total.
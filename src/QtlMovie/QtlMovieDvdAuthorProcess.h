@@ -53,11 +53,14 @@ public:
     //! @param [in] settings Application settings.
     //! @param [in] log Message logger.
     //! @param [in] parent Optional parent object.
+    //! @param [in] dataPull If non zero, used to feed the standard input of the process.
+    //! In that case, the input movie file in @a arguments is typically "-".
     //!
     QtlMovieDvdAuthorProcess(const QStringList& arguments,
                              const QtlMovieSettings* settings,
                              QtlLogger* log,
-                             QObject *parent = 0);
+                             QObject *parent = 0,
+                             QtlDataPull* dataPull = 0);
 
     //!
     //! Start the process.
@@ -48,37 +48,57 @@ QtlMovieDvdExtractionSession::QtlMovieDvdExtractionSession(const QString& dvdDev
     _completedSectors(0),
     _totalFiles(0),
     _completedFiles(0),
-    _transferList()
+    _aborted(false),
+    _badSectorMap(),
+    _transferList(),
+    _readAhead(QTS_DEFAULT_DVD_TRANSFER_SIZE, QTS_DVD_READ_AHEAD_CHUNKS, this),
+    _dvd(QString(), &_readAhead),
+    _buffer(),
+    _report(30000, this) // report transfer bandwidth every 30 seconds.
 {
 }
 
 
+//----------------------------------------------------------------------------
+// Destructor.
+//----------------------------------------------------------------------------
+
+QtlMovieDvdExtractionSession::~QtlMovieDvdExtractionSession()
+{
+    // The reader thread uses _dvd, which is destroyed before _readAhead.
+    _readAhead.stop();
+}
+
+
 //----------------------------------------------------------------------------
 // Constructor of inner private class describing one transfer.
 //----------------------------------------------------------------------------
 
 QtlMovieDvdExtractionSession::OutputFile::OutputFile(const QString& outputFileName,
-                                                     const QString& dvdDeviceName,
                                                      int startSector,
                                                      int sectorCount,
-                                                     bool useMaxReadSpeed,
                                                      Qts::BadSectorPolicy badSectorPolicy,
-                                                     QtlLogger* log) :
-    totalSectors(sectorCount),
-    file(outputFileName),
-    dataPull(dvdDeviceName,
-             startSector,
-             sectorCount,
-             badSectorPolicy,
-             QTS_DEFAULT_DVD_TRANSFER_SIZE,
-             QtlDataPull::DEFAULT_MIN_BUFFER_SIZE,
-             log,
-             0,
-             useMaxReadSpeed)
+                                                     qint64 fileOffset) :
+    startSector(startSector),
+    totalSectors(qMax(0, sectorCount)),
+    badSectorPolicy(badSectorPolicy),
+    fileOffset(fileOffset),
+    remainingSectors(qMax(0, sectorCount)),
+    file(outputFileName)
 {
 }
 
 
+//----------------------------------------------------------------------------
+// Compare two transfers by position on the DVD media.
+//----------------------------------------------------------------------------
+
+bool QtlMovieDvdExtractionSession::lessThan(const OutputFilePtr& ofp1, const OutputFilePtr& ofp2)
+{
+    return ofp1->startSector < ofp2->startSector;
+}
+
+
 //----------------------------------------------------------------------------
 // Add a slice of DVD to extract in a file.
 //----------------------------------------------------------------------------
@@ -94,13 +114,136 @@ void QtlMovieDvdExtractionSession::addFile(const QString& outputFileName,
     }
     else {
         // Add a new transfer in the list.
-        _transferList << OutputFilePtr(new OutputFile(outputFileName, _dvdDeviceName, startSector, sectorCount, settings()->dvdUseMaxSpeed(), badSectorPolicy, this));
+        _transferList << OutputFilePtr(new OutputFile(outputFileName, startSector, sectorCount, badSectorPolicy));
         debug(tr("Queued file %1, sectors %2 to %3").arg(outputFileName).arg(startSector).arg(startSector + sectorCount - 1));
 
         // Accumulate total transfer size.
-        _totalSectors += sectorCount;
+        _totalSectors += qMax(0, sectorCount);
+        _totalFiles++;
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Add the extraction of a complete DVD image in a file.
+//----------------------------------------------------------------------------
+
+void QtlMovieDvdExtractionSession::addImage(const QString& outputFileName, int sectorCount, const QString& badSectorMapFileName)
+{
+    if (!isStarted()) {
+        _badSectorMap = badSectorMapFileName;
+    }
+
+    // We replace bad sectors by zeroes to preserve the media layout.
+    addFile(outputFileName, 0, sectorCount, Qts::ReadBadSectorsAsZero);
+}
+
+
+//----------------------------------------------------------------------------
+// Retry reading the bad sectors of an existing DVD image file.
+//----------------------------------------------------------------------------
+
+bool QtlMovieDvdExtractionSession::addImageRetry(const QString& outputFileName, const QString& badSectorMapFileName)
+{
+    // Cannot do that after start.
+    if (isStarted()) {
+        line(tr("Internal error: adding a DVD transfer after start"));
+        return false;
+    }
+
+    // Load the previous list of bad sectors.
+    QtlRangeList sectors;
+    if (!loadBadSectorMap(badSectorMapFileName, sectors, this)) {
+        return false;
+    }
+    _badSectorMap = badSectorMapFileName;
+
+    // One transfer per range of bad sectors, updating the image in place.
+    // Sectors which are still unreadable are replaced by zeroes again.
+    foreach (const QtlRange& range, sectors) {
+        if (!range.isEmpty()) {
+            _transferList << OutputFilePtr(new OutputFile(outputFileName, int(range.first()), int(range.count()), Qts::ReadBadSectorsAsZero, range.first() * QTS_DVD_SECTOR_SIZE));
+            _totalSectors += int(range.count());
+        }
+    }
+    if (!_transferList.isEmpty()) {
         _totalFiles++;
     }
+    debug(tr("Queued retry of %1 bad sectors in %2").arg(_totalSectors).arg(outputFileName));
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Load a bad sector map file.
+//----------------------------------------------------------------------------
+
+bool QtlMovieDvdExtractionSession::loadBadSectorMap(const QString& fileName, QtlRangeList& sectors, QtlLogger* log)
+{
+    sectors.clear();
+
+    QFile file(fileName);
+    if (!file.open(QFile::ReadOnly | QFile::Text)) {
+        log->line(tr("Error opening %1").arg(fileName));
+        return false;
+    }
+
+    // One range per line, "first-last" or "sector", comments start with '#'.
+    QTextStream text(&file);
+    while (!text.atEnd()) {
+        const QString line(text.readLine().trimmed());
+        if (line.isEmpty() || line.startsWith('#')) {
+            continue;
+        }
+        const QStringList fields(line.split('-'));
+        bool ok1 = false;
+        bool ok2 = false;
+        const int first = fields.first().trimmed().toInt(&ok1);
+        const int last = fields.last().trimmed().toInt(&ok2);
+        if (fields.size() > 2 || !ok1 || !ok2 || first < 0 || last < first) {
+            log->line(tr("Invalid bad sector range \"%1\" in %2").arg(line).arg(fileName));
+            sectors.clear();
+            return false;
+        }
+        sectors << QtlRange(first, last);
+    }
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Save the bad sectors of the DVD image in the bad sector map file.
+//----------------------------------------------------------------------------
+
+bool QtlMovieDvdExtractionSession::saveBadSectorMap(const QtlRangeList& sectors)
+{
+    // No more bad sector, delete the map.
+    if (sectors.isEmpty()) {
+        if (QFile::exists(_badSectorMap) && !QFile::remove(_badSectorMap)) {
+            line(tr("Failed to delete %1").arg(_badSectorMap));
+            return false;
+        }
+        return true;
+    }
+
+    QSaveFile file(_badSectorMap);
+    if (!file.open(QFile::WriteOnly | QFile::Text)) {
+        line(tr("Error creating %1").arg(_badSectorMap), QColor(Qt::red));
+        return false;
+    }
+    QTextStream text(&file);
+    text << "# Unreadable DVD sectors, replaced by zeroes in the image file" << endl;
+    foreach (const QtlRange& range, sectors) {
+        text << range.first() << "-" << range.last() << endl;
+    }
+    text.flush();
+    if (!file.commit()) {
+        line(tr("Error writing %1").arg(_badSectorMap), QColor(Qt::red));
+        return false;
+    }
+
+    line(tr("%1 unreadable sectors, list saved in %2").arg(sectors.totalValueCount()).arg(_badSectorMap), QColor(Qt::red));
+    return true;
 }
 
 
@@ -113,7 +256,7 @@ bool QtlMovieDvdExtractionSession::askOverwriteOutput()
     // Get the list of files which already exist.
     QStringList existing;
     foreach (const OutputFilePtr& ofp, _transferList) {
-        if (!ofp.isNull() && ofp->file.exists()) {
+        if (!ofp.isNull() && ofp->fileOffset < 0 && ofp->file.exists()) {
             existing << QtlFile::absoluteNativeFilePath(ofp->file.fileName());
         }
     }
@@ -156,68 +299,151 @@ bool QtlMovieDvdExtractionSession::start()
         return false;
     }
 
-    // Start the first action.
-    if (!startNextExtraction()) {
-        emitCompleted(false, tr("Error starting DVD extraction"));
+    // Sort the transfers by position on the DVD media so that the DVD is read
+    // from front to back. Keep the original order of files at the same position.
+    std::stable_sort(_transferList.begin(), _transferList.end(), lessThan);
+
+    // Build the list of sectors to read, one range per non-empty file.
+    // The read-ahead never builds a chunk which spans two ranges. So, each
+    // chunk is entirely written into one output file.
+    QtlRangeList sectors;
+    QList<Qts::BadSectorPolicy> policies;
+    foreach (const OutputFilePtr& ofp, _transferList) {
+        if (ofp->totalSectors > 0) {
+            sectors << QtlRange(ofp->startSector, ofp->startSector + ofp->totalSectors - 1);
+            policies << ofp->badSectorPolicy;
+        }
+    }
+
+    // Open the DVD media only once for all files.
+    if (!_dvd.openFromDevice(_dvdDeviceName, settings()->dvdUseMaxSpeed())) {
+        terminate(false, tr("Error starting DVD extraction"));
+        return true;
+    }
+
+    // Start reading sectors in advance.
+    _report.start();
+    if (!_readAhead.start(&_dvd, sectors, policies)) {
+        terminate(false, tr("Error starting DVD extraction"));
+        return true;
     }
 
+    // Transfer the first chunk from the event loop.
+    QMetaObject::invokeMethod(this, "transferNextChunk", Qt::QueuedConnection);
     return true;
 }
 
 
 //----------------------------------------------------------------------------
-// Start the next extraction in the list.
+// Open the current output file, close completed ones.
 //----------------------------------------------------------------------------
 
-bool QtlMovieDvdExtractionSession::startNextExtraction()
+bool QtlMovieDvdExtractionSession::openNextFile()
 {
-    // If list is empty, the extraction is completed.
-    if (_transferList.isEmpty()) {
-        emitCompleted(true);
-        return true;
+    while (!_transferList.isEmpty()) {
+
+        OutputFilePtr out(_transferList.first());
+
+        if (!out->file.isOpen()) {
+
+            // Build a description.
+            QString desc((out->fileOffset < 0 ? tr("Extracting %1") : tr("Updating %1")).arg(QtlFile::absoluteNativeFilePath(out->file.fileName())));
+            if (_totalFiles > 1) {
+                desc.append(QStringLiteral(" (%1/%2)").arg(_completedFiles + 1).arg(_totalFiles));
+            }
+            setDescription(desc);
+
+            // Create the parent directory of the output file is necessary.
+            const QString dir(QtlFile::parentPath(out->file.fileName()));
+            if (!QtlFile::createDirectory(dir)) {
+                line(tr("Error creating directory %1").arg(dir), QColor(Qt::red));
+                return false;
+            }
+
+            // Open the output file. An existing file is updated in place.
+            if (out->fileOffset < 0 && !out->file.open(QFile::WriteOnly)) {
+                line(tr("Error creating %1").arg(out->file.fileName()), QColor(Qt::red));
+                return false;
+            }
+            else if (out->fileOffset >= 0 && (!out->file.open(QFile::ReadWrite) || !out->file.seek(out->fileOffset))) {
+                line(tr("Error updating %1").arg(out->file.fileName()), QColor(Qt::red));
+                return false;
+            }
+        }
+
+        // Current file is not yet completed.
+        if (out->remainingSectors > 0) {
+            return true;
+        }
+
+        // Current file completed, move to next one.
+        out->file.close();
+        _transferList.removeFirst();
+        _completedFiles++;
     }
+    return true;
+}
 
-    // Get the next transfer (but keep it in the list).
-    OutputFilePtr out(_transferList.first());
 
-    // Build a description.
-    QString desc(tr("Extracting %1").arg(QtlFile::absoluteNativeFilePath(out->file.fileName())));
-    if (_totalFiles > 1) {
-        desc.append(QStringLiteral(" (%1/%2)").arg(_completedFiles + 1).arg(_totalFiles));
+//----------------------------------------------------------------------------
+// Transfer the next chunk of sectors into the current output file.
+//----------------------------------------------------------------------------
+
+void QtlMovieDvdExtractionSession::transferNextChunk()
+{
+    // Filter outdated calls.
+    if (isCompleted()) {
+        return;
     }
-    setDescription(desc);
 
-    // Create the parent directory of the output file is necessary.
-    const QString dir(QtlFile::parentPath(out->file.fileName()));
-    if (!QtlFile::createDirectory(dir)) {
-        line(tr("Error creating directory %1").arg(dir), QColor(Qt::red));
-        dataPullCompleted(false);
-        return false;
+    // Check if the extraction was aborted.
+    if (_aborted) {
+        terminate(false, tr("DVD extraction aborted"));
+        return;
     }
 
-    // Open the output file.
-    if (!out->file.open(QFile::WriteOnly)) {
-        line(tr("Error creating %1").arg(out->file.fileName()), QColor(Qt::red));
-        dataPullCompleted(false);
-        return false;
+    // Move to the next output file if necessary.
+    if (!openNextFile()) {
+        terminate(false, tr("DVD extraction failed, see messages above."));
+        return;
+    }
+    if (_transferList.isEmpty()) {
+        // Extraction successfully completed.
+        terminate(true);
+        return;
     }
 
-    // Get notified of the transfer progress.
-    connect(&out->dataPull, &QtlDataPull::progress, this, &QtlMovieDvdExtractionSession::dataPullProgressed);
+    // Get the next chunk of sectors. It belongs to the current output file.
+    OutputFilePtr out(_transferList.first());
+    int requested = 0;
+    const int count = _readAhead.readChunk(_buffer, requested);
 
-    // Get notified of the transfer progress. Important: We need a queued connection, not a direct one.
-    // Our slot dataPullCompleted() will destroy the QtlDataPull instance, we cannot do this inside a
-    // direct call from the object to destroy.
-    connect(&out->dataPull, &QtlDataPull::completed, this, &QtlMovieDvdExtractionSession::dataPullCompleted, Qt::QueuedConnection);
+    if (requested <= 0 || requested > out->remainingSectors) {
+        terminate(false, tr("Internal error: unexpected end of DVD sectors"));
+        return;
+    }
+    else if (count <= 0) {
+        line(tr("Error reading DVD sectors for %1").arg(out->file.fileName()), QColor(Qt::red));
+        terminate(false, tr("DVD extraction failed, see messages above."));
+        return;
+    }
 
-    // Start the transfer.
-    if (!out->dataPull.start(&out->file)) {
-        line(tr("Error starting data transfer to %1").arg(out->file.fileName()), QColor(Qt::red));
-        dataPullCompleted(false);
-        return false;
+    // Write the sectors in the output file.
+    const qint64 size = qint64(count) * QTS_DVD_SECTOR_SIZE;
+    if (out->file.write(reinterpret_cast<const char*>(_buffer.data()), size) != size) {
+        line(tr("Error writing %1").arg(out->file.fileName()), QColor(Qt::red));
+        terminate(false, tr("DVD extraction failed, see messages above."));
+        return;
     }
 
-    return true;
+    // Report progress, in number of requested sectors.
+    out->remainingSectors -= requested;
+    _completedSectors += requested;
+    _report.transfered(count);
+    emitProgress(_completedSectors, _totalSectors);
+
+    // Let the event loop run, then transfer the next chunk.
+    QMetaObject::invokeMethod(this, "transferNextChunk", Qt::QueuedConnection);
 }
 
 
@@ -228,68 +454,41 @@ bool QtlMovieDvdExtractionSession::startNextExtraction()
 void QtlMovieDvdExtractionSession::abort()
 {
     // Is there anything to abort?
-    if (!isStarted() || _transferList.isEmpty()) {
+    if (!isStarted() || isCompleted()) {
         return;
     }
 
-    // Remove all transfers except current one.
-    while (_transferList.size() > 1 || (!_transferList.isEmpty() && !_transferList.first()->dataPull.isStarted())) {
-        _transferList.removeLast();
-    }
-
-    if (_transferList.isEmpty()) {
-        // No transfer will notify the completion, we need to do it now.
-        emitCompleted(false, "DVD extraction aborted");
-    }
-    else {
-        // Abort the current transfer.
-        _transferList.first()->dataPull.stop();
-        // The completion of the aborted transfer will trigger the completion of the complete extraction.
-    }
+    // The next transfer will notify the completion of the extraction.
+    _aborted = true;
 }
 
 
 //----------------------------------------------------------------------------
-// Invoked when some progress in the current data transfer is available.
+// Terminate the extraction.
 //----------------------------------------------------------------------------
 
-void QtlMovieDvdExtractionSession::dataPullProgressed(qint64 current, qint64 maximum)
+void QtlMovieDvdExtractionSession::terminate(bool success, const QString& message)
 {
-    // Number of sectors from previous transfers plus sectors in current transfer.
-    emitProgress(_completedSectors + int(current / QTS_DVD_SECTOR_SIZE), _totalSectors);
-}
-
+    // Stop reading the DVD.
+    _readAhead.stop();
+    if (_dvd.isOpen()) {
+        _report.reportBandwidth();
+    }
+    _dvd.close();
 
-//----------------------------------------------------------------------------
-// Invoked each time a transfer completes.
-//----------------------------------------------------------------------------
+    // Record the bad sectors of a DVD image, after a complete reading only.
+    const bool mapError = success && !_badSectorMap.isEmpty() && !saveBadSectorMap(_dvd.badSectors());
 
-void QtlMovieDvdExtractionSession::dataPullCompleted(bool success)
-{
-    // Cleanup terminated extraction.
-    Q_ASSERT(!_transferList.isEmpty());
-    OutputFilePtr out(_transferList.takeFirst());
-    _completedSectors += out->totalSectors;
-    _completedFiles++;
-    out->file.close();
-    out.clear();
-
-    // Emit a progress indicator.
-    dataPullProgressed(0, 0);
-
-    // Process the next extraction.
-    if (success) {
-        if (_transferList.isEmpty()) {
-            // Extraction successfully completed.
-            emitCompleted(true);
-            return;
-        }
-        else if (startNextExtraction()) {
-            // Next action started.
-            return;
-        }
+    // Close all output files.
+    foreach (const OutputFilePtr& ofp, _transferList) {
+        ofp->file.close();
     }
+    _transferList.clear();
 
-    // Notify failure.
-    emitCompleted(false, "DVD extraction failed, see messages above.");
+    if (mapError) {
+        emitCompleted(false, tr("DVD extraction failed, see messages above."));
+    }
+    else {
+        emitCompleted(success, message);
+    }
 }
@@ -36,12 +36,18 @@
 #define QTLMOVIEDVDEXTRACTIONSESSION_H
 
 #include "QtlMovieAction.h"
-#include "QtsDvdDataPull.h"
+#include "QtsDvdMedia.h"
+#include "QtsDvdReadAhead.h"
+#include "QtsDvdBandwidthReport.h"
 #include "QtlSmartPointer.h"
 
 //!
 //! A complete DVD extraction session.
 //!
+//! All slices of DVD are extracted in one single pass. The slices are sorted
+//! by sector address and the DVD is read once, from front to back, through one
+//! single QtsDvdMedia. The sectors are dispatched to the output files on the fly.
+//!
 class QtlMovieDvdExtractionSession : public QtlMovieAction
 {
     Q_OBJECT
@@ -56,6 +62,12 @@ public:
     //!
     QtlMovieDvdExtractionSession(const QString& dvdDeviceName, const QtlMovieSettings* settings, QtlLogger* log, QObject *parent = 0);
 
+    //!
+    //! Destructor.
+    //! Stop reading the DVD, if still running.
+    //!
+    virtual ~QtlMovieDvdExtractionSession();
+
     //!
     //! Add a slice of DVD to extract in a file.
     //! Must be done before start().
@@ -67,6 +79,37 @@ public:
     //!
     void addFile(const QString& outputFileName, int startSector, int sectorCount, Qts::BadSectorPolicy badSectorPolicy);
 
+    //!
+    //! Add the extraction of a complete DVD image in a file.
+    //! Must be done before start().
+    //! Bad sectors are replaced by zeroes and their list is saved in a bad sector map file.
+    //! @param [in] outputFileName Output image file name.
+    //! @param [in] sectorCount Total number of sectors in the DVD volume.
+    //! @param [in] badSectorMapFileName Name of the bad sector map file. It is
+    //! deleted if there is no bad sector at the end of the extraction.
+    //!
+    void addImage(const QString& outputFileName, int sectorCount, const QString& badSectorMapFileName);
+
+    //!
+    //! Retry reading the bad sectors of an existing DVD image file.
+    //! Must be done before start().
+    //! The sectors in the image file are updated in place. The bad sector map file
+    //! is updated at the end of the extraction with the remaining bad sectors.
+    //! @param [in] outputFileName Existing image file name.
+    //! @param [in] badSectorMapFileName Name of the bad sector map file, from a previous extraction.
+    //! @return True on success, false on error (cannot load the bad sector map).
+    //!
+    bool addImageRetry(const QString& outputFileName, const QString& badSectorMapFileName);
+
+    //!
+    //! Load a bad sector map file.
+    //! @param [in] fileName Name of the bad sector map file.
+    //! @param [out] sectors Ranges of bad sectors.
+    //! @param [in] log Where to log errors.
+    //! @return True on success, false on error.
+    //!
+    static bool loadBadSectorMap(const QString& fileName, QtlRangeList& sectors, QtlLogger* log);
+
     //!
     //! Get the number of remaining transfers, including the current one.
     //! @return The number of remaining transfers, including the current one.
@@ -99,29 +142,28 @@ public:
 
 private slots:
     //!
-    //! Invoked when some progress in the current data transfer is available.
-    //! @param [in] current Current number of input bytes.
-    //! @param [in] maximum Total size of the data transfer.
-    //!
-    void dataPullProgressed(qint64 current, qint64 maximum);
-
-    //!
-    //! Invoked each time a transfer completes.
-    //! @param [in] success Indicates whether the action succeeded or failed.
+    //! Transfer the next chunk of sectors into the current output file.
+    //! Invoked repeatedly from the event loop until the end of the extraction.
     //!
-    void dataPullCompleted(bool success);
+    void transferNextChunk();
 
 private:
     class OutputFile;
     typedef QtlSmartPointer<OutputFile, QtlNullMutexLocker> OutputFilePtr;
     typedef QList<OutputFilePtr> OutputFileList;
 
-    QString        _dvdDeviceName;     //!< DVD device name.
-    int            _totalSectors;      //!< Total size in DVD sectors of the transfer.
-    int            _completedSectors;  //!< Transfered sectors in previous completed transfered.
-    int            _totalFiles;        //!< Total file count.
-    int            _completedFiles;    //!< Completed file count.
-    OutputFileList _transferList;      //!< List of transfers.
+    QString               _dvdDeviceName;     //!< DVD device name.
+    int                   _totalSectors;      //!< Total size in DVD sectors of the transfer.
+    int                   _completedSectors;  //!< Transfered sectors so far.
+    int                   _totalFiles;        //!< Total file count.
+    int                   _completedFiles;    //!< Completed file count.
+    bool                  _aborted;           //!< Abort was requested.
+    QString               _badSectorMap;      //!< Name of bad sector map file, when extracting an image.
+    OutputFileList        _transferList;      //!< List of remaining transfers, the first one is the current one.
+    QtsDvdReadAhead       _readAhead;         //!< Read DVD sectors in advance. Also used as logger for _dvd.
+    QtsDvdMedia           _dvd;               //!< Access to DVD media.
+    QtlByteBlock          _buffer;            //!< Transfer buffer, swapped with read-ahead chunks.
+    QtsDvdBandwidthReport _report;            //!< To report transfer bandwidth.
 
     //!
     //! Inner private class describing one transfer.
@@ -129,34 +171,58 @@ private:
     class OutputFile
     {
     public:
-        const int      totalSectors;  //!< Total number of sectors in this transfer.
-        QFile          file;          //!< Output file.
-        QtsDvdDataPull dataPull;      //!< DVD transfer.
+        const int                  startSector;      //!< First sector to read.
+        const int                  totalSectors;     //!< Total number of sectors in this transfer.
+        const Qts::BadSectorPolicy badSectorPolicy;  //!< How to handle bad sectors.
+        const qint64               fileOffset;       //!< Offset in an existing file to update in place, -1 for a new file.
+        int                        remainingSectors; //!< Number of sectors not yet read.
+        QFile                      file;             //!< Output file.
 
         //!
         //! Constructor.
         //! @param [in] outputFileName Output file name.
-        //! @param [in] dvdDeviceName DVD device name.
         //! @param [in] startSector First sector to read.
         //! @param [in] sectorCount Total number of sectors to read.
-        //! @param [in] useMaxReadSpeed Set the DVD reader to maximum speed.
         //! @param [in] badSectorPolicy How to handle bad sectors.
-        //! @param [in] log Message logger.
+        //! @param [in] fileOffset Offset in bytes where to write in an existing file.
+        //! If negative, a new file is created.
         //!
         OutputFile(const QString& outputFileName,
-                   const QString& dvdDeviceName,
                    int startSector,
                    int sectorCount,
-                   bool useMaxReadSpeed,
                    Qts::BadSectorPolicy badSectorPolicy,
-                   QtlLogger* log);
+                   qint64 fileOffset = -1);
     };
 
     //!
-    //! Start the next extraction in the list.
-    //! @return True on success, false on error (not started).
+    //! Compare two transfers by position on the DVD media.
+    //! @param [in] ofp1 First transfer.
+    //! @param [in] ofp2 Second transfer.
+    //! @return True if @a ofp1 starts before @a ofp2.
+    //!
+    static bool lessThan(const OutputFilePtr& ofp1, const OutputFilePtr& ofp2);
+
+    //!
+    //! Open the current output file, if not yet open.
+    //! Close completed files, including empty ones.
+    //! @return True on success, false on error.
+    //!
+    bool openNextFile();
+
+    //!
+    //! Terminate the extraction and emit the completed() signal.
+    //! @param [in] success True when the extraction completed successfully, false otherwise.
+    //! @param [in] message Optional error message to log.
+    //!
+    void terminate(bool success, const QString& message = QString());
+
+    //!
+    //! Save the bad sectors of the DVD image in the bad sector map file.
+    //! If there is no bad sector, delete the bad sector map file.
+    //! @param [in] sectors Ranges of bad sectors.
+    //! @return True on success, false on error.
     //!
-    bool startNextExtraction();
+    bool saveBadSectorMap(const QtlRangeList& sectors);
 
     // Unaccessible operations.
     QtlMovieDvdExtractionSession() Q_DECL_EQ_DELETE;
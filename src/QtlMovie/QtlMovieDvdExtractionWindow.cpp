@@ -476,8 +476,21 @@ void QtlMovieDvdExtractionWindow::startExtraction()
     switch (_ui.tabDvd->currentIndex()) {
         case QTL_TAB_ISO: {
             // Only one big file to extract.
-            // We replace bad sectors by zeroes to preserve the media layout.
-            _extraction->addFile(_ui.valueFullPath->text(), 0, dvd->volumeSizeInSectors(), Qts::ReadBadSectorsAsZero);
+            // Bad sectors are replaced by zeroes to preserve the media layout and recorded in a map.
+            const QString imageFile(_ui.valueFullPath->text());
+            const QString mapFile(imageFile + QTL_DVD_BAD_SECTOR_MAP_SUFFIX);
+            QtlRangeList badSectors;
+            if (QFile::exists(mapFile) &&
+                QFileInfo(imageFile).size() == qint64(dvd->volumeSizeInSectors()) * QTS_DVD_SECTOR_SIZE &&
+                QtlMovieDvdExtractionSession::loadBadSectorMap(mapFile, badSectors, log()) &&
+                !badSectors.isEmpty() &&
+                qtlConfirm(this, tr("A previous extraction of %1 has %2 unreadable sectors.\nRetry only these sectors?").arg(QtlFile::absoluteNativeFilePath(imageFile)).arg(badSectors.totalValueCount()))) {
+                // Retry only the previous bad sectors in the existing image.
+                _extraction->addImageRetry(imageFile, mapFile);
+            }
+            else {
+                _extraction->addImage(imageFile, dvd->volumeSizeInSectors(), mapFile);
+            }
             break;
         }
         case QTL_TAB_VTS: {
@@ -38,6 +38,7 @@
 #include "QtlOpticalDrive.h"
 #include "QtlStringUtils.h"
 #include "QtlWinUtils.h"
+#include "QtsDvdMedia.h"
 
 
 //-----------------------------------------------------------------------------
@@ -254,6 +255,7 @@ void QtlMovieEditSettings::resetValues(QAbstractButton* button)
     _ui.checkTargetSubtitles->setChecked(_settings->selectTargetSubtitles());
     _ui.checkDvdExtractDirTree->setChecked(_settings->dvdExtractDirTree());
     _ui.checkDvdUseMaxSpeed->setChecked(_settings->dvdUseMaxSpeed());
+    _ui.checkDvdKeyCache->setChecked(_settings->dvdKeyCache());
     _ui.checkBoxCleanupSubtitles->setChecked(_settings->cleanupSubtitles());
     _ui.checkBoxUseHtmlInSrt->setChecked(_settings->useSrtHtmlTags());
     _ui.checkBoxDowngradeSsaToSrt->setChecked(_settings->downgradeSsaToSrt());
@@ -262,6 +264,9 @@ void QtlMovieEditSettings::resetValues(QAbstractButton* button)
     _ui.spinDvdProgramChain->setValue(_settings->dvdProgramChain());
     _ui.spinDvdAngle->setValue(_settings->dvdAngle());
     _ui.checkBoxFFmpegLowPriority->setChecked(_settings->ffmpegLowPriority());
+    _ui.spinMaxConcurrentJobs->setValue(_settings->maxConcurrentJobs());
+    _ui.spinMaxParallelActions->setValue(_settings->maxParallelActions());
+    _ui.spinMediaCacheSize->setValue(_settings->mediaCacheSize());
 
     const int dvdBurningSpeed = _settings->dvdBurningSpeed();
     _ui.checkDvdBurningSpeed->setChecked(dvdBurningSpeed != 0);
@@ -416,6 +421,7 @@ void QtlMovieEditSettings::applySettings()
     _settings->setSelectTargetSubtitles(_ui.checkTargetSubtitles->isChecked());
     _settings->setDvdExtractDirTree(_ui.checkDvdExtractDirTree->isChecked());
     _settings->setDvdUseMaxSpeed(_ui.checkDvdUseMaxSpeed->isChecked());
+    _settings->setDvdKeyCache(_ui.checkDvdKeyCache->isChecked());
     _settings->setCleanupSubtitles(_ui.checkBoxCleanupSubtitles->isChecked());
     _settings->setUseSrtHtmlTags(_ui.checkBoxUseHtmlInSrt->isChecked());
     _settings->setDowngradeSsaToSrt(_ui.checkBoxDowngradeSsaToSrt->isChecked());
@@ -424,6 +430,9 @@ void QtlMovieEditSettings::applySettings()
     _settings->setDvdAngle(_ui.spinDvdAngle->value());
     _settings->setDvdBurningSpeed(_ui.checkDvdBurningSpeed->isChecked() ? _ui.spinDvdBurningSpeed->value() : 0);
     _settings->setFFmpegLowPriority(_ui.checkBoxFFmpegLowPriority->isChecked());
+    _settings->setMaxConcurrentJobs(_ui.spinMaxConcurrentJobs->value());
+    _settings->setMaxParallelActions(_ui.spinMaxParallelActions->value());
+    _settings->setMediaCacheSize(_ui.spinMediaCacheSize->value());
 
     // Load default output directories by output type.
     for (OutputDirectoryMap::ConstIterator it = _outDirs.begin(); it != _outDirs.end(); ++it) {
@@ -471,6 +480,21 @@ void QtlMovieEditSettings::browseOutputDir()
 }
 
 
+//-----------------------------------------------------------------------------
+// Invoked by the "Purge" button for the DVD key cache.
+//-----------------------------------------------------------------------------
+
+void QtlMovieEditSettings::purgeDvdKeyCache()
+{
+    // Purge the cache location even if the cache is currently disabled: keys may have been saved before.
+    if (qtlConfirm(this, tr("Remove all DVD encryption keys from the cache?")) &&
+        !QtsDvdMedia::purgeKeyCache(_settings->dvdKeyCacheLocation(), _settings->log()))
+    {
+        qtlError(this, tr("Error purging the DVD key cache, see the log for details"));
+    }
+}
+
+
 //-----------------------------------------------------------------------------
 // Invoked by the "Browse..." button for the DVD burner device.
 //-----------------------------------------------------------------------------
@@ -157,6 +157,11 @@ private slots:
     //!
     void browseDvdBurner();
 
+    //!
+    //! Invoked by the "Purge" button for the DVD key cache.
+    //!
+    void purgeDvdKeyCache();
+
     //!
     //! Invoked by the "New..." button in the target audience language editing.
     //!
@@ -131,9 +131,10 @@ void QtlMovieFFmpegProcess::updateEnvironment(QProcessEnvironment& env)
 
 bool QtlMovieFFmpegProcess::createFontConfig(const QString& templateFile, const QString& actualFile)
 {
-    // Open input and output files.
+    // Open input and output files. Several FFmpeg processes of the same job may
+    // run concurrently, the output file is atomically replaced when complete.
     QFile inFile(templateFile);
-    QFile outFile(actualFile);
+    QSaveFile outFile(actualFile);
     if (!inFile.open(QFile::ReadOnly)) {
         line(tr("Cannot open %1, may be a problem to insert subtitles").arg(inFile.fileName()));
         return false;
@@ -154,6 +155,11 @@ bool QtlMovieFFmpegProcess::createFontConfig(const QString& templateFile, const
         line.replace(QTLFC_FONTDIR_MARK, fontDir);
         out << line << "\n";
     }
+    out.flush();
+    if (!outFile.commit()) {
+        this->line(tr("Cannot create %1, may be a problem to insert subtitles").arg(actualFile));
+        return false;
+    }
     return true;
 }
 
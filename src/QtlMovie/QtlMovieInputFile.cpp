@@ -34,9 +34,13 @@
 #include "QtlMovieFFmpeg.h"
 #include "QtlMovieTeletextSearch.h"
 #include "QtlMovieClosedCaptionsSearch.h"
+#include "QtlMovieAnalysisScheduler.h"
+#include "QtlMovieMediaCache.h"
 #include "QtlMovie.h"
 #include "QtlNumUtils.h"
 #include "QtlFileDataPull.h"
+#include "QtlDataFanOut.h"
+#include "QtlFanOutDataPull.h"
 #include "QtsDvdDataPull.h"
 #include "QtsDvdProgramChainDemux.h"
 
@@ -59,6 +63,9 @@ QtlMovieInputFile::QtlMovieInputFile(const QString& fileName,
     _dvdTitleSet(fileName, log),
     _dvdPgc(),
     _teletextSearch(0),
+    _dvdScanner(),
+    _dvdScanPull(),
+    _cacheKeyThread(),
     _ffprobeCount(0),
     _ccSearchCount(0),
     _selectedVideoStreamIndex(-1),
@@ -74,7 +81,10 @@ QtlMovieInputFile::QtlMovieInputFile(const QString& fileName,
     _pipeInput(false),
     _dvdTranscodeRawVob(settings->dvdTranscodeRawVob()),
     _dvdProgramChain(settings->dvdProgramChain()),
-    _dvdAngle(settings->dvdAngle())
+    _dvdAngle(settings->dvdAngle()),
+    _cacheKey(),
+    _analysisFailed(false),
+    _speculativeStreams(false)
 {
     Q_ASSERT(log != 0);
     Q_ASSERT(settings != 0);
@@ -97,6 +107,9 @@ QtlMovieInputFile::QtlMovieInputFile(const QtlMovieInputFile& other, QObject* pa
     _dvdTitleSet(other._dvdTitleSet),
     _dvdPgc(other._dvdPgc),
     _teletextSearch(0),  // don't copy
+    _dvdScanner(),       // don't copy
+    _dvdScanPull(),      // don't copy
+    _cacheKeyThread(),   // don't copy
     _ffprobeCount(0),    // don't copy
     _ccSearchCount(0),   // don't copy
     _selectedVideoStreamIndex(other._selectedVideoStreamIndex),
@@ -112,7 +125,10 @@ QtlMovieInputFile::QtlMovieInputFile(const QtlMovieInputFile& other, QObject* pa
     _pipeInput(other._pipeInput),
     _dvdTranscodeRawVob(other._dvdTranscodeRawVob),
     _dvdProgramChain(other._dvdProgramChain),
-    _dvdAngle(other._dvdAngle)
+    _dvdAngle(other._dvdAngle),
+    _cacheKey(),          // don't copy
+    _analysisFailed(false),
+    _speculativeStreams(false)
 {
     // Update media info when the file name is changed.
     connect(this, &QtlMovieInputFile::fileNameChanged, this, &QtlMovieInputFile::updateMediaInfo);
@@ -162,6 +178,15 @@ QtlBoundProcess* QtlMovieInputFile::ffprobeProcess(int probeTimeDivisor, int ffp
 
 void QtlMovieInputFile::updateMediaInfo(const QString& fileName)
 {
+    // Cancel any previous analysis request. A running computation of the cache key
+    // is not interrupted, it terminates quickly, but its result will be ignored.
+    QtlMovieAnalysisScheduler::instance()->releaseAnalysis(this);
+    _cacheKeyThread.clear();
+
+    // Stop any previous DVD stream scanning, its results are no longer relevant.
+    stopDvdScan();
+    _speculativeStreams = false;
+
     // By default, the ffmpeg input spec is the file name.
     _ffmpegInput = fileName;
     _ffmpegFormat.clear();
@@ -210,7 +235,6 @@ void QtlMovieInputFile::updateMediaInfo(const QString& fileName)
     _dvdAngle = _settings->dvdAngle();
 
     // DVD media and file structure requires special treatment.
-    int ffprobeTimeout = _settings->ffprobeExecutionTimeout();
     if (isOnDvd) {
 
         // If the specified PGC in the settings does not exist in this VTS, revert to PGC #1.
@@ -220,9 +244,6 @@ void QtlMovieInputFile::updateMediaInfo(const QString& fileName)
             _dvdPgc = _dvdTitleSet.title(1);
         }
 
-        // Give a 4 times longer timeout on DVD devices, they are so slow to start.
-        ffprobeTimeout *= 4;
-
         if (isOnEncryptedDvd || !_dvdTranscodeRawVob) {
             // Encrypted and/or demuxed DVD's shall be read from stdin.
             // We need to specify the file format for ffmpeg.
@@ -242,6 +263,111 @@ void QtlMovieInputFile::updateMediaInfo(const QString& fileName)
         }
     }
 
+    // The analysis itself (including the lookup in the cache) is started when the
+    // scheduler allows it, to avoid running too many analyses at the same time.
+    QtlMovieAnalysisScheduler::instance()->requestAnalysis(this, fileName);
+}
+
+
+//----------------------------------------------------------------------------
+// Try to load the media info from the media analysis cache.
+//----------------------------------------------------------------------------
+
+bool QtlMovieInputFile::loadCachedMediaInfo(const QString& fileName)
+{
+    QtlMovieMediaCache cache(_settings, _log);
+    QtlMovieMediaCache::Entry entry;
+    if (!cache.load(_cacheKey, entry)) {
+        // Not in cache, the results will be stored after analysis.
+        return false;
+    }
+
+    _log->debug(tr("Using cached media information for %1").arg(fileName));
+    _cacheKey.clear();
+    _ffInfo = entry.ffInfo;
+    _streams = entry.streams;
+    _isTs = entry.isTs;
+    _isM2ts = entry.isM2ts;
+    _isSubtitle = entry.isSubtitle;
+
+    selectDefaultStreams(_settings->audienceLanguages());
+    emit mediaInfoChanged();
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Start the analysis of the file, invoked by the analysis scheduler.
+//----------------------------------------------------------------------------
+
+void QtlMovieInputFile::startAnalysis()
+{
+    _cacheKey.clear();
+    _analysisFailed = false;
+
+    // Without cache, analyze the file immediately.
+    if (!QtlMovieMediaCache(_settings, _log).isEnabled()) {
+        startFileAnalysis();
+        return;
+    }
+
+    // Computing the cache key reads the file. This is done in the analysis slot, with the
+    // same limits per device as the analysis itself, and in a thread to avoid blocking the GUI.
+    // The analysis results depend on the ffprobe version, probe size and DVD demux options.
+    // The thread deletes itself when finished.
+    CacheKeyThread* thread =
+            new CacheKeyThread(fileName(),
+                               QStringList() << _settings->ffprobe()->fileName()
+                                             << QString::number(_settings->ffmpegProbeSeconds())
+                                             << QString::number(int(_dvdTranscodeRawVob))
+                                             << QString::number(_dvdProgramChain)
+                                             << QString::number(_dvdAngle));
+    connect(thread, &QThread::finished, this, &QtlMovieInputFile::cacheKeyThreadFinished, Qt::QueuedConnection);
+    connect(thread, &QThread::finished, thread, &QObject::deleteLater);
+    _cacheKeyThread = thread;
+    thread->start();
+}
+
+
+//----------------------------------------------------------------------------
+// Invoked when the cache key of the file has been computed.
+//----------------------------------------------------------------------------
+
+void QtlMovieInputFile::cacheKeyThreadFinished()
+{
+    // Ignore the results of an obsolete thread (the file name has changed since then).
+    CacheKeyThread* const thread = _cacheKeyThread.data();
+    if (thread == 0 || sender() != thread) {
+        return;
+    }
+    _cacheKeyThread.clear();
+    _cacheKey = thread->key();
+
+    // If the same file was previously analyzed, reuse the results and release the analysis slot.
+    if (loadCachedMediaInfo(fileName())) {
+        checkAnalysisCompleted();
+    }
+    else {
+        startFileAnalysis();
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Start the actual analysis of the file (ffprobe, search for subtitles).
+//----------------------------------------------------------------------------
+
+void QtlMovieInputFile::startFileAnalysis()
+{
+    const QString fileName(this->fileName());
+    const bool isOnDvd = _dvdTitleSet.isLoaded();
+
+    // Give a 4 times longer timeout on DVD devices, they are so slow to start.
+    int ffprobeTimeout = _settings->ffprobeExecutionTimeout();
+    if (isOnDvd) {
+        ffprobeTimeout *= 4;
+    }
+
     // Create the process object. It will automatically delete itself after completion.
     QtlBoundProcess* process = ffprobeProcess(1, ffprobeTimeout);
 
@@ -249,22 +375,39 @@ void QtlMovieInputFile::updateMediaInfo(const QString& fileName)
     // is very slow. A typical bitrate is 21 Mb/s. Reading the default probe size
     // duration (200 s. of contents) takes approximately 1 minute. So, you cannot
     // see the audio and subtitle streams before that. This is not user-friendly.
-    // To improve the user experience, we start shorter ffprobes in parallel. These
-    // shorter ffprobes may not find all streams but will give information much
-    // faster. If other streams are found later, they will appear later. This is not
-    // perfect but better than waiting 1 minute.
+    // To improve the user experience, the same DVD content is scanned in parallel
+    // by a PS parser which reports the elementary streams as soon as they appear.
+    // The streams are built from the IFO description and displayed immediately.
+    // They are replaced by the final results when ffprobe completes.
 
     if (isOnDvd) {
-        QtlBoundProcess* process2 = ffprobeProcess(QTL_FFPROBE_DVD_DIVISOR_2, ffprobeTimeout);
-        QtlBoundProcess* process3 = ffprobeProcess(QTL_FFPROBE_DVD_DIVISOR_3, ffprobeTimeout);
+        _dvdScanner = new QtsDvdStreamScanner(this);
+        _dvdScanner->open(QIODevice::WriteOnly);
+        connect(_dvdScanner, &QtsDvdStreamScanner::streamFound, this, &QtlMovieInputFile::dvdStreamFound);
 
-        // Pipe DVD content into all process inputs at the same time.
         if (_pipeInput) {
-            QList<QIODevice*> processInputs;
-            processInputs << process->inputDevice() << process2->inputDevice() << process3->inputDevice();
-            dataPull(this)->start(processInputs);
+            // Pipe DVD content into ffprobe and the scanner at the same time. The DVD is read only once.
+            // The scanner is much faster than ffprobe, it never slows down the DVD reading.
+            // The fan-out owns its consumers and source and deletes itself when they are all done.
+            QtlDataFanOut* fanOut = new QtlDataFanOut(QtlDataFanOut::DEFAULT_MAX_LAG, _log, this);
+            connect(fanOut, &QtlDataFanOut::finished, fanOut, &QtlDataFanOut::deleteLater);
+            QtlFanOutDataPull* probeInput = new QtlFanOutDataPull(fanOut, QtlDataFanOut::BlockOnLag, QtlDataPull::DEFAULT_MIN_BUFFER_SIZE, _log, fanOut);
+            QtlFanOutDataPull* scanInput = new QtlFanOutDataPull(fanOut, QtlDataFanOut::DropOnLag, QtlDataPull::DEFAULT_MIN_BUFFER_SIZE, _log, fanOut);
+            probeInput->start(process->inputDevice());
+            scanInput->start(_dvdScanner);
+            _dvdScanPull = scanInput;
+            fanOut->start(dataPull(fanOut));
             _log->line(tr("Searching audio and subtitles tracks on DVD, please be patient..."), QColor(Qt::darkGreen));
         }
+        else {
+            // FFprobe reads the VOB files by itself, the scanner reads them from the file system.
+            _dvdScanPull = new QtlFileDataPull(_dvdTitleSet.vobFileNames(),
+                                               QtlFileDataPull::DEFAULT_TRANSFER_SIZE,
+                                               QtlDataPull::DEFAULT_MIN_BUFFER_SIZE,
+                                               _log,
+                                               _dvdScanner);
+            _dvdScanPull->start(_dvdScanner);
+        }
     }
     else {
         // Look for Closed Captions. Create a new instance of CC search.
@@ -281,6 +424,34 @@ void QtlMovieInputFile::updateMediaInfo(const QString& fileName)
             delete cc;
         }
     }
+
+    // In case everything failed to start.
+    checkAnalysisCompleted();
+}
+
+
+//----------------------------------------------------------------------------
+// Release the analysis slot when no more operation is in progress.
+//----------------------------------------------------------------------------
+
+void QtlMovieInputFile::checkAnalysisCompleted()
+{
+    if (_ffprobeCount <= 0 && _ccSearchCount <= 0 && _teletextSearch == 0) {
+
+        // Save the results for the next time the same file is analyzed.
+        if (!_cacheKey.isEmpty() && !_analysisFailed && !_ffInfo.isEmpty()) {
+            QtlMovieMediaCache::Entry entry;
+            entry.ffInfo = _ffInfo;
+            entry.streams = _streams;
+            entry.isTs = _isTs;
+            entry.isM2ts = _isM2ts;
+            entry.isSubtitle = _isSubtitle;
+            QtlMovieMediaCache(_settings, _log).store(_cacheKey, entry);
+        }
+        _cacheKey.clear();
+
+        QtlMovieAnalysisScheduler::instance()->releaseAnalysis(this);
+    }
 }
 
 
@@ -293,9 +464,21 @@ void QtlMovieInputFile::ffprobeTerminated(const QtlBoundProcessResult& result)
     // FFprobe terminated.
     _ffprobeCount--;
 
+    // The DVD stream scanning is useless after ffprobe.
+    if (_ffprobeCount <= 0) {
+        stopDvdScan();
+    }
+
+    // Drop the speculative streams from the DVD stream scanning, ffprobe is authoritative.
+    if (_speculativeStreams) {
+        _streams.clear();
+        _speculativeStreams = false;
+    }
+
     // Filter ffprobe process execution.
     if (result.hasError()) {
         _log->line(tr("FFprobe error: %1").arg(result.errorMessage()));
+        _analysisFailed = true;
     }
 
     // The standard output from ffprobe contains the media info in the form of "key=value".
@@ -349,6 +532,9 @@ void QtlMovieInputFile::ffprobeTerminated(const QtlBoundProcessResult& result)
 
         // Create a search action for teletext.
         // Will be deleted no later than this object.
+        // This is currently the only analysis which reads the TS file with a QtsDemux
+        // (Closed Captions are searched by FFmpeg). A future TS analysis of the input
+        // file can be attached to the same file read using addDemux().
         _teletextSearch = new QtlMovieTeletextSearch(fileName(), _settings, _log, this);
 
         // Get notifications from the Teletext searcher.
@@ -369,6 +555,67 @@ void QtlMovieInputFile::ffprobeTerminated(const QtlBoundProcessResult& result)
 }
 
 
+//----------------------------------------------------------------------------
+// Invoked when a new elementary stream is found by the DVD stream scanner.
+//----------------------------------------------------------------------------
+
+void QtlMovieInputFile::dvdStreamFound(int streamId)
+{
+    // Ignore late notifications, after the final ffprobe results.
+    if (_ffprobeCount <= 0 || _dvdScanner.isNull()) {
+        return;
+    }
+
+    // Use the stream description from the IFO file. Ignore streams which are not described in the IFO.
+    QtlMediaStreamInfoPtr ifoStream;
+    foreach (const QtlMediaStreamInfoPtr& s, _dvdTitleSet.streams()) {
+        if (!s.isNull() && s->streamId() == streamId) {
+            ifoStream = s;
+            break;
+        }
+    }
+    if (ifoStream.isNull()) {
+        return;
+    }
+
+    // FFmpeg creates the streams of a program stream in order of appearance.
+    // So, the FFmpeg index is probably the index of the stream in the scanner.
+    QtlMediaStreamInfoPtr stream(new QtlMediaStreamInfo(*ifoStream));
+    stream->setFFIndex(_dvdScanner->streamIds().indexOf(streamId));
+    _log->debug(tr("Found DVD stream id 0x%1, probable index %2").arg(streamId, 0, 16).arg(stream->ffIndex()));
+
+    // Replace previous speculative streams or start a new list.
+    if (!_speculativeStreams) {
+        _streams.clear();
+        _speculativeStreams = true;
+    }
+    _streams.append(stream);
+    std::sort(_streams.begin(), _streams.end(), QtsDvdTitleSet::lessThan);
+
+    // Notify the new streams immediately.
+    selectDefaultStreams(_settings->audienceLanguages());
+    emit mediaInfoChanged();
+}
+
+
+//----------------------------------------------------------------------------
+// Stop the DVD stream scanning.
+//----------------------------------------------------------------------------
+
+void QtlMovieInputFile::stopDvdScan()
+{
+    if (!_dvdScanner.isNull()) {
+        disconnect(_dvdScanner, 0, this, 0);
+        _dvdScanner->deleteLater();
+        _dvdScanner.clear();
+    }
+    if (!_dvdScanPull.isNull()) {
+        _dvdScanPull->stop();
+        _dvdScanPull.clear();
+    }
+}
+
+
 //----------------------------------------------------------------------------
 // Invoked when a Teletext subtitle stream is found.
 //----------------------------------------------------------------------------
@@ -425,6 +672,10 @@ void QtlMovieInputFile::foundClosedCaptions(QtlMediaStreamInfoPtr stream)
 
 void QtlMovieInputFile::teletextSearchTerminated(bool success)
 {
+    if (!success) {
+        _analysisFailed = true;
+    }
+
     // Cleanup the teletext searcher.
     if (_teletextSearch != 0) {
         _log->debug(tr("Search for Teletext subtitles completed"));
@@ -448,6 +699,10 @@ void QtlMovieInputFile::teletextSearchTerminated(bool success)
 
 void QtlMovieInputFile::closedCaptionsSearchTerminated(bool success)
 {
+    if (!success) {
+        _analysisFailed = true;
+    }
+
     // Decrement the number of searches.
     if (_ccSearchCount > 0) {
         _ccSearchCount--;
@@ -458,6 +713,7 @@ void QtlMovieInputFile::closedCaptionsSearchTerminated(bool success)
     if (_ccSearchCount <= 0) {
         emit mediaInfoChanged();
     }
+    checkAnalysisCompleted();
 }
 
 
@@ -475,6 +731,7 @@ void QtlMovieInputFile::newMediaInfo()
         selectDefaultStreams(_settings->audienceLanguages());
         emit mediaInfoChanged();
     }
+    checkAnalysisCompleted();
 }
 
 
@@ -43,6 +43,8 @@
 #include "QtlMovieSettings.h"
 #include "QtlMovieFFprobeTags.h"
 #include "QtlMovieTeletextSearch.h"
+#include "QtlMovieMediaCache.h"
+#include "QtsDvdStreamScanner.h"
 
 //!
 //! Describes an input video file.
@@ -362,6 +364,11 @@ private slots:
     //!
     void ffprobeTerminated(const QtlBoundProcessResult& result);
     //!
+    //! Invoked when a new elementary stream is found by the DVD stream scanner.
+    //! @param [in] streamId Stream id in the DVD content.
+    //!
+    void dvdStreamFound(int streamId);
+    //!
     //! Invoked when a Teletext subtitle stream is found.
     //! @param [in] stream A smart pointer to the stream info data.
     //!
@@ -381,17 +388,67 @@ private slots:
     //! @param [in] success True on success, false on error.
     //!
     void closedCaptionsSearchTerminated(bool success);
+    //!
+    //! Invoked when the cache key of the file has been computed in a CacheKeyThread.
+    //!
+    void cacheKeyThreadFinished();
 
 private:
-    QtlLogger*              _log;            //!< Where to log errors.
-    const QtlMovieSettings* _settings;       //!< Application settings.
-    QString                 _ffmpegInput;    //!< Name to specify as input to ffmpeg.
-    QString                 _ffmpegFormat;   //!< Name to specify as input file format to ffmpeg.
-    QtlMovieFFprobeTags     _ffInfo;         //!< Media info in ffprobe flat format.
-    QtlMediaStreamInfoList  _streams;        //!< Stream information.
-    QtsDvdTitleSet          _dvdTitleSet;    //!< DVD title set access (when the input file comes from a DVD).
-    QtsDvdProgramChainPtr   _dvdPgc;         //!< Smart pointer to PGC inside the DVD VTS.
-    QtlMovieTeletextSearch* _teletextSearch; //!< Search for Teletext subtitles in MPEG-TS files.
+    //!
+    //! A thread which computes the media cache key of a file.
+    //! The first and last bytes of the file are read to compute the key.
+    //! This can be slow on optical media and must not block the GUI thread.
+    //!
+    class CacheKeyThread : public QThread
+    {
+    public:
+        //!
+        //! Constructor.
+        //! @param [in] fileName Name of the file to analyze.
+        //! @param [in] options Additional analysis options which influence the analysis results.
+        //!
+        CacheKeyThread(const QString& fileName, const QStringList& options) :
+            QThread(),
+            _fileName(fileName),
+            _options(options),
+            _key()
+        {
+        }
+        //!
+        //! Get the computed key, when the thread is finished.
+        //! @return The cache key or an empty string if the file cannot be cached.
+        //!
+        QString key() const
+        {
+            return _key;
+        }
+    protected:
+        //!
+        //! Thread main code.
+        //! Reimplemented from QThread.
+        //!
+        virtual void run() Q_DECL_OVERRIDE
+        {
+            _key = QtlMovieMediaCache::computeFileKey(_fileName, _options);
+        }
+    private:
+        const QString     _fileName; //!< File to analyze.
+        const QStringList _options;  //!< Analysis options.
+        QString           _key;      //!< Computed key.
+    };
+
+    QtlLogger*                    _log;            //!< Where to log errors.
+    const QtlMovieSettings*       _settings;       //!< Application settings.
+    QString                       _ffmpegInput;    //!< Name to specify as input to ffmpeg.
+    QString                       _ffmpegFormat;   //!< Name to specify as input file format to ffmpeg.
+    QtlMovieFFprobeTags           _ffInfo;         //!< Media info in ffprobe flat format.
+    QtlMediaStreamInfoList        _streams;        //!< Stream information.
+    QtsDvdTitleSet                _dvdTitleSet;    //!< DVD title set access (when the input file comes from a DVD).
+    QtsDvdProgramChainPtr         _dvdPgc;         //!< Smart pointer to PGC inside the DVD VTS.
+    QtlMovieTeletextSearch*       _teletextSearch; //!< Search for Teletext subtitles in MPEG-TS files.
+    QPointer<QtsDvdStreamScanner> _dvdScanner;     //!< Scan DVD content for elementary streams while ffprobe is running.
+    QPointer<QtlDataPull>         _dvdScanPull;    //!< Feed the DVD stream scanner.
+    QPointer<CacheKeyThread>      _cacheKeyThread; //!< Compute the media cache key before the analysis.
     int     _ffprobeCount;                       //!< Number of ffprobe in progress.
     int     _ccSearchCount;                      //!< Number of Closed Captions research in progress.
     int     _selectedVideoStreamIndex;           //!< Index of video stream to transcode.
@@ -408,6 +465,21 @@ private:
     bool    _dvdTranscodeRawVob;                 //!< On DVD, transcode raw VOB files, don't demux.
     int     _dvdProgramChain;                    //!< PGC number when demuxing DVD content.
     int     _dvdAngle;                           //!< Angle number when demuxing DVD content.
+    QString _cacheKey;                           //!< Key of the analysis in the media cache, empty if not cacheable.
+    bool    _analysisFailed;                     //!< Some part of the analysis failed, don't cache it.
+    bool    _speculativeStreams;                 //!< The streams come from the DVD stream scanner, not from ffprobe.
+
+    //!
+    //! Try to load the media info from the media analysis cache, using _cacheKey.
+    //! @param [in] fileName Name of the file to analyze.
+    //! @return True if the media info were loaded from the cache, false if the file must be analyzed.
+    //!
+    bool loadCachedMediaInfo(const QString& fileName);
+
+    //!
+    //! Stop the DVD stream scanning, if any is in progress.
+    //!
+    void stopDvdScan();
 
     //!
     //! Report that new media info has been found.
@@ -415,6 +487,23 @@ private:
     //!
     void newMediaInfo();
 
+    //!
+    //! Start the analysis of the file, invoked by QtlMovieAnalysisScheduler when allowed.
+    //! The cache key is first computed in a CacheKeyThread. The media info are then
+    //! loaded from the cache or the file is analyzed by startFileAnalysis().
+    //!
+    void startAnalysis();
+
+    //!
+    //! Start the actual analysis of the file (ffprobe, search for subtitles).
+    //!
+    void startFileAnalysis();
+
+    //!
+    //! Release the analysis slot in QtlMovieAnalysisScheduler when no more operation is in progress.
+    //!
+    void checkAnalysisCompleted();
+
     //!
     //! Create and start a ffprobe process.
     //! @param [in] probeTimeDivisor If positive, this value is used to reduce the probe time duration.
@@ -424,6 +513,9 @@ private:
     //!
     QtlBoundProcess* ffprobeProcess(int probeTimeDivisor, int ffprobeTimeout);
 
+    // The analysis scheduler starts the analysis.
+    friend class QtlMovieAnalysisScheduler;
+
     // Unaccessible operations.
     QtlMovieInputFile() Q_DECL_EQ_DELETE;
 };
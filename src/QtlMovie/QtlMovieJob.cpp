@@ -37,15 +37,18 @@
 #include "QtlMovieFFmpegProcess.h"
 #include "QtlMovieFFmpegVolumeDetect.h"
 #include "QtlMovieDvdAuthorProcess.h"
+#include "QtlMovieProcessDataPull.h"
 #include "QtlMovieMkisofsProcess.h"
 #include "QtlMovieGrowisofsProcess.h"
 #include "QtlMovieCcExtractorProcess.h"
 #include "QtlMovieTeletextExtract.h"
+#include "QtlMovieTsDemux.h"
 #include "QtlMovieCleanupSubtitles.h"
 #include "QtlMovieConvertSubStationAlpha.h"
 #include "QtlOpticalDrive.h"
 #include "QtlStringList.h"
 #include "QtlSysInfo.h"
+#include "QtlThreadDataPull.h"
 
 
 //----------------------------------------------------------------------------
@@ -57,9 +60,16 @@ QtlMovieJob::QtlMovieJob(QtlMovieTask* task, const QtlMovieSettings* settings, Q
     _task(task),
     _outSeconds(0),
     _actionCount(0),
+    _ffmpegThreads(ffmpegThreadBudget(1)),
     _tempDir(),
     _actionList(),
-    _variables()
+    _encodings(),
+    _variables(),
+    _actionProgress(),
+    _pipelines(),
+    _totalCost(0),
+    _completedCost(0),
+    _failed(false)
 {
     Q_ASSERT(task != 0);
     Q_ASSERT(task->inputFile() != 0);
@@ -68,6 +78,45 @@ QtlMovieJob::QtlMovieJob(QtlMovieTask* task, const QtlMovieSettings* settings, Q
     // Notify the task when the state changes.
     connect(this, &QtlMovieJob::started, task, &QtlMovieTask::setStarted);
     connect(this, &QtlMovieJob::completed, task, &QtlMovieTask::setCompleted);
+    connect(this, &QtlMovieJob::progress, this, &QtlMovieJob::updateTaskProgress);
+}
+
+
+//----------------------------------------------------------------------------
+// Update the progress indicator of the task.
+//----------------------------------------------------------------------------
+
+void QtlMovieJob::updateTaskProgress(const QString& description, int current, int maximum)
+{
+    Q_UNUSED(description);
+    Q_UNUSED(current);
+    Q_UNUSED(maximum);
+    _task->setProgress(currentProgress(100));
+}
+
+
+//----------------------------------------------------------------------------
+// Number of threads to give to each FFmpeg video encoding.
+//----------------------------------------------------------------------------
+
+int QtlMovieJob::ffmpegThreadBudget(int concurrentEncodings)
+{
+    return qBound(1, QtlSysInfo::numberOfProcessors(1) / qMax(1, concurrentEncodings), QTL_MAX_FFMPEG_THREADS);
+}
+
+
+//----------------------------------------------------------------------------
+// Check if the job still has video encoding processes to execute.
+//----------------------------------------------------------------------------
+
+bool QtlMovieJob::hasPendingEncoding() const
+{
+    foreach (const QtlMovieAction* action, _actionList) {
+        if (_encodings.contains(action)) {
+            return true;
+        }
+    }
+    return false;
 }
 
 
@@ -113,6 +162,10 @@ bool QtlMovieJob::start()
     while (!_actionList.isEmpty()) {
         delete _actionList.takeFirst();
     }
+    _encodings.clear();
+    _actionProgress.clear();
+    _pipelines.clear();
+    _failed = false;
 
     // Check that input/output files are specified.
     if (_task == 0 || _task->inputFile() == 0 || !_task->inputFile()->isSet()) {
@@ -156,12 +209,20 @@ bool QtlMovieJob::start()
     }
     _actionCount = _actionList.size();
 
-    // Start the first action.
+    // Compute the expected cost of the job.
+    _totalCost = 0;
+    _completedCost = 0;
+    foreach (const QtlMovieAction* action, _actionList) {
+        _totalCost += action->cost();
+    }
+
+    // Start the first actions.
     if (_actionList.isEmpty()) {
         emitCompleted(false, tr("Nothing to do"));
     }
-    else if (!startNextAction()) {
-        emitCompleted(false, tr("Error starting process"));
+    else if (!startReadyActions()) {
+        cancelActions();
+        completeWhenIdle();
     }
     return true;
 }
@@ -178,20 +239,14 @@ void QtlMovieJob::abort()
         return;
     }
 
-    // Cleanup all future actions.
-    while (_actionList.size() > 1 || !_actionList.first()->isStarted()) {
-        delete _actionList.takeLast();
-    }
+    // Cleanup all future actions and kill the running ones.
+    cancelActions();
 
-    if (_actionList.isEmpty()) {
+    if (runningActionCount() == 0) {
         // No action will notify the completion, we need to do it now.
         emitCompleted(false, "Transcoding aborted");
     }
-    else {
-        // Kill the current process.
-        _actionList.first()->abort();
-        // The completion of the aborted process will trigger the completion of the job.
-    }
+    // Otherwise, the completion of the aborted processes will trigger the completion of the job.
 }
 
 
@@ -199,23 +254,19 @@ void QtlMovieJob::abort()
 // Get an indication of the total progress within the job.
 //----------------------------------------------------------------------------
 
-int QtlMovieJob::currentProgress(int currentActionProgress, int currentActionMaximum, int jobMaximum) const
+int QtlMovieJob::currentProgress(int jobMaximum) const
 {
-    int progressValue = 0;
-    if (isStarted() && jobMaximum > 0) {
-        // First, compute duration of one action. This assumes that all actions
-        // have the same duration, which is of course wrong. But never mind.
-        const int actionDuration = _actionCount == 0 ? jobMaximum : jobMaximum / _actionCount;
-
-        // Then, compute initial progress of current action.
-        progressValue = actionDuration * (_actionCount - _actionList.size());
-
-        // Finally, add progress within current action, if available.
-        if (currentActionMaximum > 0) {
-            progressValue += (actionDuration * currentActionProgress) / currentActionMaximum;
-        }
+    if (!isStarted() || jobMaximum <= 0 || _totalCost <= 0) {
+        return 0;
+    }
+
+    // Accumulate the cost of completed actions and the completed part of running actions.
+    // The progress of running actions is in 1/1000, so compute everything in 1/1000 of cost.
+    qint64 done = qint64(_completedCost) * 1000;
+    foreach (const QtlMovieAction* action, _actionList) {
+        done += qint64(action->cost()) * _actionProgress.value(action, 0);
     }
-    return progressValue;
+    return int(qBound<qint64>(0, (done * jobMaximum) / (qint64(_totalCost) * 1000), jobMaximum));
 }
 
 
@@ -246,6 +297,8 @@ void QtlMovieJob::cleanup()
     while (!_actionList.isEmpty()) {
         _actionList.takeFirst()->deleteLater();
     }
+    _actionProgress.clear();
+    _pipelines.clear();
 
     // Delete temporary directory and its content.
     // If the option "keep intermediate files" is present, we delete it only if empty.
@@ -273,58 +326,171 @@ void QtlMovieJob::cleanup()
 
 
 //----------------------------------------------------------------------------
-// Start the next action in the list.
+// Start all actions which are ready to start.
 //----------------------------------------------------------------------------
 
-bool QtlMovieJob::startNextAction()
+bool QtlMovieJob::startReadyActions()
 {
-    // Check that there is something to start.
-    if (_actionList.isEmpty()) {
-        line(tr("Internal error, no more process to start"));
-        return false;
+    // Maximum number of concurrent actions.
+    const int maxRunning = qMax(1, settings()->maxParallelActions());
+    int running = runningActionCount();
+
+    // Completed actions are removed from the list. So, an action is ready when it does
+    // not depend on any previous action in the list, started or not. Actions which do
+    // not declare their files depend on all others and are consequently run alone.
+    for (int index = 0; running < maxRunning && index < _actionList.size(); ++index) {
+        QtlMovieAction* action = _actionList[index];
+        bool ready = !action->isStarted();
+        for (int previous = 0; ready && previous < index; ++previous) {
+            ready = !action->dependsOn(_actionList[previous]);
+        }
+        if (ready) {
+            if (!startAction(action)) {
+                return false;
+            }
+            running++;
+        }
     }
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Start one action.
+//----------------------------------------------------------------------------
+
+bool QtlMovieJob::startAction(QtlMovieAction* action)
+{
+    // The number of threads for video encoding may have changed since the job started.
+    setVariable(QTL_FFMPEG_THREADS_VARNAME, QtlStringList("-threads", QString::number(_ffmpegThreads)));
 
-    // Get notifications from next process.
-    QtlMovieAction* next = _actionList.first();
-    connect(next, &QtlMovieAction::progress,  this, &QtlMovieJob::progress);
-    connect(next, &QtlMovieAction::completed, this, &QtlMovieJob::actionCompleted);
+    // Get notifications from the action. Some actions complete during start(),
+    // always process the completion from the event loop, after start() returns.
+    connect(action, &QtlMovieAction::progress, this, &QtlMovieJob::actionProgressed);
+    connect(action, &QtlMovieAction::completed, this, &QtlMovieJob::actionCompleted, Qt::QueuedConnection);
 
-    // Start the next process.
-    if (!next->start()) {
+    // Start the action.
+    if (!action->start()) {
         line(tr("Failed to start process."));
-        actionCompleted(false);
+        disconnect(action, 0, this, 0);
+        _actionList.removeOne(action);
+        action->deleteLater();
         return false;
     }
-
     return true;
 }
 
 
 //----------------------------------------------------------------------------
-// Invoked each time a process completes.
+// Get the number of running actions.
 //----------------------------------------------------------------------------
 
-void QtlMovieJob::actionCompleted(bool success)
+int QtlMovieJob::runningActionCount() const
 {
-    // Cleanup terminated action.
-    Q_ASSERT(!_actionList.isEmpty());
-    _actionList.takeFirst()->deleteLater();
+    int count = 0;
+    foreach (const QtlMovieAction* action, _actionList) {
+        if (action->isStarted()) {
+            count++;
+        }
+    }
+    return count;
+}
 
-    // Process the next step.
-    if (success) {
-        if (_actionList.isEmpty()) {
-            // Job successfully completed.
-            emitCompleted(true);
-            return;
+
+//----------------------------------------------------------------------------
+// Cancel the job after an error or an abort request.
+//----------------------------------------------------------------------------
+
+void QtlMovieJob::cancelActions()
+{
+    _failed = true;
+
+    // Iterate on a copy since the list is modified.
+    const QList<QtlMovieAction*> actions(_actionList);
+    foreach (QtlMovieAction* action, actions) {
+        if (!action->isStarted()) {
+            _actionList.removeOne(action);
+            delete action;
         }
-        else if (startNextAction()) {
-            // Next action started.
-            return;
+        else if (!action->isCompleted()) {
+            action->abort();
         }
     }
+}
+
+
+//----------------------------------------------------------------------------
+// Emit the completion of the job if no more action is running.
+//----------------------------------------------------------------------------
+
+void QtlMovieJob::completeWhenIdle()
+{
+    if (runningActionCount() > 0) {
+        // Wait for the completion of the running actions.
+        return;
+    }
+    else if (_failed) {
+        emitCompleted(false, "Transcoding failed, see messages above.");
+    }
+    else if (_actionList.isEmpty()) {
+        // Job successfully completed.
+        emitCompleted(true);
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Invoked each time an action completes.
+//----------------------------------------------------------------------------
+
+void QtlMovieJob::actionCompleted(bool success)
+{
+    // Filter completions of actions which were already cleaned up.
+    QtlMovieAction* action = qobject_cast<QtlMovieAction*>(sender());
+    if (action == 0 || !_actionList.contains(action)) {
+        return;
+    }
+
+    // Cleanup terminated action.
+    _actionList.removeOne(action);
+    _actionProgress.remove(action);
+    _completedCost += action->cost();
+    action->deleteLater();
+
+    // Start the next actions or cancel the job on error.
+    if (!success || (!_failed && !startReadyActions())) {
+        cancelActions();
+    }
+    completeWhenIdle();
+}
+
+
+//----------------------------------------------------------------------------
+// Invoked each time some progress is made in an action.
+//----------------------------------------------------------------------------
+
+void QtlMovieJob::actionProgressed(const QString& description, int current, int maximum, int elapsedSeconds, int remainingSeconds)
+{
+    const QtlMovieAction* action = qobject_cast<const QtlMovieAction*>(sender());
+    if (action != 0 && maximum > 0) {
+        _actionProgress.insert(action, int((qint64(qBound(0, current, maximum)) * 1000) / maximum));
+    }
+    emit progress(description, current, maximum, elapsedSeconds, remainingSeconds);
+}
+
+
+//----------------------------------------------------------------------------
+// Invoked when a process which feeds another one completes.
+//----------------------------------------------------------------------------
 
-    // Notify failure.
-    emitCompleted(false, "Transcoding failed, see messages above.");
+void QtlMovieJob::pipelineProducerCompleted(bool success)
+{
+    // If the producer failed, the fed action received a truncated input
+    // and may still terminate successfully. Kill it to make the job fail.
+    QtlMovieAction* consumer = _pipelines.value(qobject_cast<const QtlMovieAction*>(sender()), 0);
+    if (!success && consumer != 0 && _actionList.contains(consumer) && consumer->isStarted() && !consumer->isCompleted()) {
+        consumer->abort();
+    }
 }
 
 
@@ -462,6 +628,9 @@ bool QtlMovieJob::buildScenario()
     // This boolean will be true when the subtitle file is created by QtlMovie internal code.
     bool internallyCreatedSubtitles = false;
 
+    // Internal action which reads the complete input TS file, if any.
+    QtlMovieTsDemux* inputScan = 0;
+
     // Do we need to add an initial pass to extract subtitles? Yes if:
     // - A subtitle stream is selected in input file.
     // - Not DVD or DVB subtitles. These are directly processed by FFmpeg from the input file.
@@ -478,9 +647,13 @@ bool QtlMovieJob::buildScenario()
 
         // Create a process for subtitle extraction. File suffix is updated.
         // SSA/ASS are converted to SRT if specified in the settings.
+        const int firstAction = _actionList.size();
         if (!addExtractSubtitle(inputForTranscoding, subtitleFile, internallyCreatedSubtitles, settings()->downgradeSsaToSrt(), false)) {
             return false;
         }
+        for (int i = firstAction; inputScan == 0 && i < _actionList.size(); ++i) {
+            inputScan = qobject_cast<QtlMovieTsDemux*>(_actionList[i]);
+        }
 
         // Clone the input file with different subtitle characteristics.
         setExternalSubtitleFileName(inputForTranscoding, subtitleFile);
@@ -505,6 +678,8 @@ bool QtlMovieJob::buildScenario()
                                              this,
                                              this);
         action->setDescription(tr("Cleanup subtitles file"));
+        action->addInputFile(inputForTranscoding->externalSubtitleFileName());
+        action->addOutputFile(cleanSubtitleFile);
         _actionList.append(action);
 
         // So now the transcoding should use the cleaned file.
@@ -519,18 +694,37 @@ bool QtlMovieJob::buildScenario()
     // This is required if audio normalization is requested and both input and output contain audio.
     if (settings()->audioNormalize() && !audioStream.isNull() && outputType != QtlMovieOutputFile::SubRip) {
 
+        // When the subtitles are extracted by an internal TS demux, the same input scan
+        // feeds the volume detection through its standard input. The input file is read once.
+        const bool fused = inputScan != 0 && !inputForTranscoding->pipeInput();
+        QtlThreadDataPull* tee = fused ? new QtlThreadDataPull(QtlThreadDataPull::DEFAULT_MAX_QUEUED_SIZE, QtlDataPull::DEFAULT_MIN_BUFFER_SIZE, this, this) : 0;
+
         // Add an initial pass to evaluate the audio volume.
         QtlMovieFFmpegVolumeDetect* process =
-                new QtlMovieFFmpegVolumeDetect(inputForTranscoding->ffmpegInputFileSpecification(),
+                new QtlMovieFFmpegVolumeDetect(fused ? QString("-") : inputForTranscoding->ffmpegInputFileSpecification(),
                                                audioStream->ffSpecifier(),
                                                _outSeconds,
                                                _tempDir,
                                                settings(),
                                                this,
                                                this,
-                                               inputForTranscoding->dataPull(this));
+                                               fused ? tee : inputForTranscoding->dataPull(this));
         process->setDescription(tr("Evaluate audio level"));
-        _actionList.append(process);
+        process->setCost(QTL_ACTION_COST_MEDIA);
+
+        if (fused) {
+            // The volume detection is started and completed by the input scan.
+            inputScan->setTee(process, tee);
+            inputScan->setCost(inputScan->cost() + QTL_ACTION_COST_MEDIA);
+        }
+        else {
+            // The volume detection only reads the input file and can run concurrently with the
+            // subtitles processing. A piped input (DVD) cannot be read by two actions at a time.
+            if (!inputForTranscoding->pipeInput()) {
+                process->addInputFile(inputForTranscoding->fileName());
+            }
+            _actionList.append(process);
+        }
     }
 
     // Build the ffmpeg command for the main process.
@@ -611,7 +805,15 @@ bool QtlMovieJob::addFFmpeg(const QString& description, const QStringList ffmpeg
 
         QtlMovieFFmpegProcess* process = new QtlMovieFFmpegProcess(ffmpegArguments, _outSeconds, _tempDir, settings(), this, this, dataPull);
         process->setDescription(description);
+        process->setCost(QTL_ACTION_COST_MEDIA);
         _actionList.append(process);
+
+        // A process which does not simply copy the video stream is a CPU-bound video encoding.
+        const int codec = ffmpegArguments.indexOf("-codec:v");
+        if (codec >= 0 && codec + 1 < ffmpegArguments.size() && ffmpegArguments[codec + 1] != "copy") {
+            process->setCost(QTL_ACTION_COST_ENCODING);
+            _encodings.insert(process);
+        }
         return true;
     }
 }
@@ -862,7 +1064,7 @@ bool QtlMovieJob::addTranscodeAudioVideoToDvd(const QtlMovieInputFile* inputFile
         // Common video options.
         args << "-map" << videoStream->ffSpecifier()
              << "-codec:v" << "mpeg2video"
-             << "-threads" << QString::number(QtlSysInfo::numberOfProcessors(1))
+             << QTL_FFMPEG_THREADS_VARREF    // Number of threads, resolved when the process starts.
              << "-target" << (settings()->createPalDvd() ? "pal-dvd" : "ntsc-dvd")  // Select presets for DVD.
              << "-b:v" << QString::number(bitrate)
              << "-aspect" << QTL_DVD_DAR_FFMPEG
@@ -982,10 +1184,14 @@ bool QtlMovieJob::addTranscodeToDvdFile(const QtlMovieInputFile* inputFile, cons
 
 bool QtlMovieJob::addTranscodeToDvdIsoImage(const QtlMovieInputFile* inputFile, const QString& outputFileName)
 {
-    // Need to transcode to a temporary file first.
-    const QString mpegFileName(_tempDir + QDir::separator() + "movie-iso.mpg");
+    // Unless intermediate files must be kept, the output of the last FFmpeg process is
+    // directly piped into DVD Author. Otherwise, need to transcode to a temporary file first.
+    // In both cases, DVD Author and FFmpeg use "-" as standard input and output, respectively.
+    const bool pipeline = !settings()->keepIntermediateFiles();
+    const QString mpegFileName(pipeline ? QString("-") : _tempDir + QDir::separator() + "movie-iso.mpg");
 
     // Add a process to transcode input file into a DVD-compliant MPEG file.
+    const int firstAction = _actionList.size();
     if (!addTranscodeToDvdFile(inputFile, mpegFileName)) {
         return false;
     }
@@ -1005,27 +1211,53 @@ bool QtlMovieJob::addTranscodeToDvdIsoImage(const QtlMovieInputFile* inputFile,
          << mpegFileName;      // MPEG file for this title.
 
     // Add the DVD author process.
-    QtlMovieProcess* process = new QtlMovieDvdAuthorProcess(args, settings(), this, this);
-    process->setDescription(tr("Creating DVD structure pass 1: add movie"));
-    _actionList.append(process);
+    QtlMovieProcess* process = 0;
+    if (pipeline) {
+        // Locate the last FFmpeg process, the one which produces the MPEG file.
+        // Some cleanup actions may have been added after it.
+        int index = _actionList.size();
+        QtlMovieFFmpegProcess* producer = 0;
+        while (producer == 0 && --index >= firstAction) {
+            producer = qobject_cast<QtlMovieFFmpegProcess*>(_actionList[index]);
+        }
+        if (producer == 0) {
+            return abortStart(tr("Internal error, no FFmpeg process to produce the MPEG file"));
+        }
+
+        // The FFmpeg process is no longer an action by itself. It is started by DVD Author
+        // when it starts pulling its standard input. FFmpeg reports the progress.
+        _actionList.removeAt(index);
+        connect(producer, &QtlMovieAction::completed, this, &QtlMovieJob::pipelineProducerCompleted);
+
+        QtlMovieProcessDataPull* dataPull = new QtlMovieProcessDataPull(producer, QtlMovieProcessDataPull::DEFAULT_TRANSFER_SIZE, QtlDataPull::DEFAULT_MIN_BUFFER_SIZE, this, this);
+        process = new QtlMovieDvdAuthorProcess(args, settings(), this, this, dataPull);
+        process->setDescription(tr("%1, creating DVD structure pass 1").arg(producer->description()));
+        process->setCost(producer->cost() + QTL_ACTION_COST_MEDIA);
+        process->useDataPullProgressReport(true);
+        _actionList.insert(index, process);
+        _pipelines.insert(producer, process);
+
+        // DVD Author now carries the video encoding of FFmpeg.
+        if (_encodings.remove(producer)) {
+            _encodings.insert(process);
+        }
+    }
+    else {
+        process = new QtlMovieDvdAuthorProcess(args, settings(), this, this);
+        process->setDescription(tr("Creating DVD structure pass 1: add movie"));
+        process->setCost(QTL_ACTION_COST_MEDIA);
+        _actionList.append(process);
+    }
 
     // Second pass: create the table of content of the DVD.
     args.clear();
     args << "-T"               // Create the "table of content" of the DVD.
          << "-o" << dvdRoot;   // Output directory (-o, uppercase, means keep previous content).
 
-    // Add an action to delete the intermediate file now.
-    // This save a lot of transient disk space before creating the ISO image.
-    if (!settings()->keepIntermediateFiles()) {
-        // If the input was not DVD-compliant, the MPEG file was a temporary one.
-        QtlMovieDeleteAction* eraser = new QtlMovieDeleteAction(QStringList(mpegFileName), settings(), this, this);
-        eraser->setDescription(tr("Cleaning up intermediate MPEG file"));
-        _actionList.append(eraser);
-    }
-
     // Add the second DVD author process.
     process = new QtlMovieDvdAuthorProcess(args, settings(), this, this);
     process->setDescription(tr("Creating DVD structure pass 2: DVD table of content"));
+    process->setCost(QTL_ACTION_COST_MEDIA);
     _actionList.append(process);
 
     // Create the DVD ISO image using mkisofs.
@@ -1040,6 +1272,7 @@ bool QtlMovieJob::addTranscodeToDvdIsoImage(const QtlMovieInputFile* inputFile,
     // Add the mkisofs process.
     process = new QtlMovieMkisofsProcess(args, settings(), this, this);
     process->setDescription(tr("Creating DVD ISO image file"));
+    process->setCost(QTL_ACTION_COST_MEDIA);
     _actionList.append(process);
 
     return true;
@@ -1077,6 +1310,7 @@ bool QtlMovieJob::addBurnDvd(const QString& isoFile, const QString& dvdBurner)
     // Add the growisofs process to the job.
     QtlMovieProcess* process = new QtlMovieGrowisofsProcess(args, settings(), this, this);
     process->setDescription(tr("Burning DVD ISO image file"));
+    process->setCost(QTL_ACTION_COST_MEDIA);
     _actionList.append(process);
 
     return true;
@@ -1106,7 +1340,7 @@ bool QtlMovieJob::addTranscodeToMp4(const QtlMovieInputFile* inputFile,
         // Common video options.
         args << "-map" << videoStream->ffSpecifier()
              << "-codec:v" << "libx264"      // H.264 (AVC, Advanced Video Coding, MPEG-4 part 10)
-             << "-threads" << QString::number(QtlSysInfo::numberOfProcessors(1))
+             << QTL_FFMPEG_THREADS_VARREF    // Number of threads, resolved when the process starts.
              << "-r" << profile.frameRateString()
              << "-maxrate" << "10000k"
              << "-bufsize" << "10000k"
@@ -1209,6 +1443,7 @@ bool QtlMovieJob::addTranscodeToAvi(const QtlMovieInputFile* inputFile, const QS
     // Common video options.
     args << "-map" << videoStream->ffSpecifier()
          << "-codec:v" << "mpeg4"      // H.263 (MPEG-4 part 2)
+         << QTL_FFMPEG_THREADS_VARREF  // Number of threads, resolved when the process starts.
          << "-r" << QTL_STRINGIFY(QTL_AVI_FRAME_RATE);
 
     // Add video rotation options if required.
@@ -1326,6 +1561,20 @@ bool QtlMovieJob::addExtractSubtitle(const QtlMovieInputFile* inputFile,
             return abortStart(tr("Teletext subtitles can be extracted as SRT only"));
         }
 
+        // If Teletext subtitles are already extracted from the same file, extract
+        // this track in the same action. The input file is read only once.
+        foreach (QtlMovieAction* previous, _actionList) {
+            QtlMovieTeletextExtract* extract = qobject_cast<QtlMovieTeletextExtract*>(previous);
+            if (extract != 0 &&
+                extract->fileName() == inputFile->fileName() &&
+                extract->addTarget(stream->streamId(), stream->teletextPage(), outputFileName))
+            {
+                extract->setDescription(tr("Extracting %1 Teletext subtitle tracks as SRT").arg(extract->targetCount()));
+                extract->addOutputFile(outputFileName);
+                return true;
+            }
+        }
+
         // Build our own action to extract one subtitle track to SRT.
         QtlMovieTeletextExtract* action = new QtlMovieTeletextExtract
                 (inputFile->fileName(),
@@ -1338,6 +1587,9 @@ bool QtlMovieJob::addExtractSubtitle(const QtlMovieInputFile* inputFile,
 
         // Add the extraction to the job.
         action->setDescription(tr("Extracting Teletext subtitles as SRT"));
+        action->setCost(QTL_ACTION_COST_MEDIA);
+        action->addInputFile(inputFile->fileName());
+        action->addOutputFile(outputFileName);
         _actionList.append(action);
         return true;
     }
@@ -1382,6 +1634,9 @@ bool QtlMovieJob::addExtractSubtitle(const QtlMovieInputFile* inputFile,
         // Add the CCExtractor process.
         QtlMovieCcExtractorProcess* process = new QtlMovieCcExtractorProcess(args, settings(), this, this);
         process->setDescription(tr("Extracting Closed Captions as SRT"));
+        process->setCost(QTL_ACTION_COST_MEDIA);
+        process->addInputFile(inputFile->fileName());
+        process->addOutputFile(outputFileName);
         _actionList.append(process);
         return true;
     }
@@ -1429,12 +1684,20 @@ bool QtlMovieJob::addExtractSubtitle(const QtlMovieInputFile* inputFile,
             if (!addFFmpeg(tr("Extracting subtitles"), args, true)) {
                 return false;
             }
+
+            // A piped input (DVD) cannot be read by two actions at a time.
+            if (!inputFile->pipeInput()) {
+                _actionList.last()->addInputFile(inputFile->fileName());
+                _actionList.last()->addOutputFile(ffmpegOutputFile);
+            }
         }
 
         // If SSA/ASS to SRT conversion is required, add a pass to do this.
         if (convertToSubRip) {
             QtlMovieConvertSubStationAlpha * action = new QtlMovieConvertSubStationAlpha(ffmpegOutputFile, outputFileName, settings(), this, this);
             action->setDescription(tr("Convert subtitles to SRT"));
+            action->addInputFile(ffmpegOutputFile);
+            action->addOutputFile(outputFileName);
             _actionList.append(action);
         }
         return true;
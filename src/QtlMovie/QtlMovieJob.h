@@ -100,16 +100,48 @@ public:
 
     //!
     //! Get an indication of the total progress within the job.
-    //! Given an estimation of the progress within the current action, we return
-    //! an estimation of the progress in the entire job. We assume that all actions
-    //! have the same duration, which is of course wrong.
-    //! @param [in] currentActionProgress Current progress in the current action.
-    //! Shall be in the range 0 to @a currentActionMaximum.
-    //! @param [in] currentActionMaximum Value for completion of the current action.
+    //! The progress of each action is weighted by its expected cost. The completed actions
+    //! count for their full cost and the running actions for their last reported progress.
     //! @param [in] jobMaximum Value for completion of the entire job.
     //! @return A value between 0 and @a jobMaximum indicating the progression in the entire job.
     //!
-    int currentProgress(int currentActionProgress, int currentActionMaximum = 100, int jobMaximum = 100) const;
+    int currentProgress(int jobMaximum = 100) const;
+
+    //!
+    //! Check if the job still has video encoding processes to execute.
+    //! Video encoding processes are CPU-bound, as opposed to other processes
+    //! (remux, DVD authoring, ISO image creation, subtitles extraction, etc.)
+    //! which are mostly I/O-bound.
+    //! @return True if the current or a future action is a video encoding.
+    //!
+    bool hasPendingEncoding() const;
+
+    //!
+    //! Get the number of threads which are given to the next FFmpeg video encodings.
+    //! @return The number of threads for FFmpeg video encodings.
+    //!
+    int ffmpegThreads() const
+    {
+        return _ffmpegThreads;
+    }
+
+    //!
+    //! Set the number of threads to give to the next FFmpeg video encodings.
+    //! Already running processes are not affected.
+    //! @param [in] threads The number of threads for FFmpeg video encodings.
+    //!
+    void setFFmpegThreads(int threads)
+    {
+        _ffmpegThreads = qMax(1, threads);
+    }
+
+    //!
+    //! Compute the number of threads to give to each FFmpeg video encoding.
+    //! The processors are evenly split between concurrent encodings.
+    //! @param [in] concurrentEncodings Number of concurrent video encodings.
+    //! @return The number of threads for each video encoding, between 1 and QTL_MAX_FFMPEG_THREADS.
+    //!
+    static int ffmpegThreadBudget(int concurrentEncodings);
 
     //!
     //! Store a variable in the job.
@@ -155,13 +187,46 @@ private slots:
     //!
     void actionCompleted(bool success);
 
+    //!
+    //! Invoked when a process which feeds the standard input of an action completes.
+    //! @param [in] success Indicates whether the process succeeded or failed.
+    //!
+    void pipelineProducerCompleted(bool success);
+
+    //!
+    //! Invoked each time some progress is made in an action.
+    //! Record the progress of the action and forward it as progress of the job.
+    //! @param [in] description The description of the current process in the action.
+    //! @param [in] current Current value.
+    //! @param [in] maximum Value indicating full completion.
+    //! @param [in] elapsedSeconds Elapsed seconds since the action started.
+    //! @param [in] remainingSeconds Estimated remaining seconds to process.
+    //!
+    void actionProgressed(const QString& description, int current, int maximum, int elapsedSeconds, int remainingSeconds);
+
+    //!
+    //! Invoked each time some progress is made in the job.
+    //! Update the progress indicator of the task.
+    //! @param [in] description The description of the current process.
+    //! @param [in] current Current value in the current action.
+    //! @param [in] maximum Value indicating full completion of the current action.
+    //!
+    void updateTaskProgress(const QString& description, int current, int maximum);
+
 private:
-    QtlMovieTask*             _task;           //!< Task to process.
-    int                       _outSeconds;     //!< Output file duration in seconds.
-    int                       _actionCount;    //!< Number of actions to execute on start.
-    QString                   _tempDir;        //!< Directory of temporary files, to delete after completion.
-    QList<QtlMovieAction*>    _actionList;     //!< List of actions to execute.
-    QMap<QString,QStringList> _variables;      //!< Set of job variables.
+    QtlMovieTask*                               _task;           //!< Task to process.
+    int                                         _outSeconds;     //!< Output file duration in seconds.
+    int                                         _actionCount;    //!< Number of actions to execute on start.
+    int                                         _ffmpegThreads;  //!< Number of threads for FFmpeg video encodings.
+    QString                                     _tempDir;        //!< Directory of temporary files, to delete after completion.
+    QList<QtlMovieAction*>                      _actionList;     //!< Actions to execute or still running, in scenario order.
+    QSet<const QtlMovieAction*>                 _encodings;      //!< Actions in _actionList which are video encodings.
+    QMap<QString,QStringList>                   _variables;      //!< Set of job variables.
+    QMap<const QtlMovieAction*,int>             _actionProgress; //!< Progress of running actions, in 1/1000.
+    QMap<const QtlMovieAction*,QtlMovieAction*> _pipelines;      //!< Processes feeding other actions, map to the fed action.
+    int                                         _totalCost;      //!< Expected cost of all actions.
+    int                                         _completedCost;  //!< Expected cost of all completed actions.
+    bool                                        _failed;         //!< An action failed or the job was aborted.
 
     //!
     //! Cleanup the job environment.
@@ -184,10 +249,36 @@ private:
     bool abortStart(const QString& message, bool result = false);
 
     //!
-    //! Start the next action in the list.
+    //! Start all actions which are ready to start.
+    //! An action is ready when it does not depend on any previous action which is not yet
+    //! completed. The number of running actions is limited by the application settings.
+    //! @return True on success, false on error (one action could not be started).
+    //!
+    bool startReadyActions();
+
+    //!
+    //! Start one action.
+    //! @param [in] action The action to start. It is removed from the list of actions on error.
     //! @return True on success, false on error (not started).
     //!
-    bool startNextAction();
+    bool startAction(QtlMovieAction* action);
+
+    //!
+    //! Get the number of started actions which are not yet processed as completed.
+    //! @return The number of running actions.
+    //!
+    int runningActionCount() const;
+
+    //!
+    //! Cancel the job after an error or an abort request.
+    //! Actions which are not yet started are deleted and running actions are aborted.
+    //!
+    void cancelActions();
+
+    //!
+    //! Emit the completion of the job if no more action is running.
+    //!
+    void completeWhenIdle();
 
     //!
     //! Add an FFmpeg process in the process list.
@@ -42,7 +42,7 @@
 
 QtlMovieMainWindow::QtlMovieMainWindow(QWidget *parent, const QStringList& initialFileNames, bool logDebug) :
     QtlMovieMainWindowBase(parent, logDebug),
-    _job(0),
+    _jobs(),
     _batchMode(false),
     _restartRequested(false)
 {
@@ -156,27 +156,103 @@ void QtlMovieMainWindow::transcodingUpdateUi(bool started)
 
 bool QtlMovieMainWindow::startNewJob(QtlMovieTask* task)
 {
-    _job = new QtlMovieJob(task, settings(), log(), this);
+    QtlMovieJob* const job = new QtlMovieJob(task, settings(), log(), this);
+    _jobs.append(job);
 
     // Connect the job's signals to the UI.
-    connect(_job, &QtlMovieJob::started,   this, &QtlMovieMainWindow::transcodingStarted);
-    connect(_job, &QtlMovieJob::progress,  this, &QtlMovieMainWindow::transcodingProgress);
-    connect(_job, &QtlMovieJob::completed, this, &QtlMovieMainWindow::transcodingStopped);
+    connect(job, &QtlMovieJob::started,   this, &QtlMovieMainWindow::transcodingStarted);
+    connect(job, &QtlMovieJob::progress,  this, &QtlMovieMainWindow::transcodingProgress);
+    connect(job, &QtlMovieJob::completed, this, &QtlMovieMainWindow::transcodingStopped);
+
+    // Until its actions are known, assume that the new job starts with a video encoding.
+    balanceFFmpegThreads(1);
 
     // Start the job.
-    if (_job->start()) {
-        // Note that the job may fail in the meantime and _job is now back to zero.
+    if (job->start()) {
+        // Note that the job may fail in the meantime and is no longer in _jobs.
         return true;
     }
     else {
        // Error starting the job, delete it now.
-        delete _job;
-        _job = 0;
+        _jobs.removeOne(job);
+        delete job;
         return false;
     }
 }
 
 
+//-----------------------------------------------------------------------------
+// In batch mode, get the next queued task which can be started now.
+//-----------------------------------------------------------------------------
+
+QtlMovieTask* QtlMovieMainWindow::nextStartableTask() const
+{
+    // There is only one DVD burner, DVD burning tasks must be serialized.
+    bool burning = false;
+    foreach (const QtlMovieJob* job, _jobs) {
+        burning = burning || job->task()->outputFile()->outputType() == QtlMovieOutputFile::DvdBurn;
+    }
+
+    // Get the first queued task which does not conflict with running jobs.
+    foreach (QtlMovieTask* task, _ui.taskList->queuedTasks()) {
+        if (!burning || task->outputFile()->outputType() != QtlMovieOutputFile::DvdBurn) {
+            return task;
+        }
+    }
+    return 0;
+}
+
+
+//-----------------------------------------------------------------------------
+// In batch mode, start queued tasks up to the maximum number of concurrent jobs.
+//-----------------------------------------------------------------------------
+
+void QtlMovieMainWindow::startQueuedJobs()
+{
+    // A started task is no longer queued, even if its job immediately failed.
+    // Note that a job failing during startNewJob() may recursively invoke
+    // this method. This is why the number of jobs is rechecked each time.
+    QtlMovieTask* task = 0;
+    while (_jobs.size() < qMax(1, settings()->maxConcurrentJobs()) && (task = nextStartableTask()) != 0) {
+        startNewJob(task);
+    }
+}
+
+
+//-----------------------------------------------------------------------------
+// Split the processors between the jobs which have video encodings to execute.
+//-----------------------------------------------------------------------------
+
+void QtlMovieMainWindow::balanceFFmpegThreads(int newEncodings)
+{
+    int encodings = newEncodings;
+    foreach (const QtlMovieJob* job, _jobs) {
+        if (job->hasPendingEncoding()) {
+            encodings++;
+        }
+    }
+
+    const int threads = QtlMovieJob::ffmpegThreadBudget(encodings);
+    foreach (QtlMovieJob* job, _jobs) {
+        job->setFFmpegThreads(threads);
+    }
+}
+
+
+//-----------------------------------------------------------------------------
+// Get the global progress of all running jobs.
+//-----------------------------------------------------------------------------
+
+int QtlMovieMainWindow::globalProgress(int maximum) const
+{
+    int percent = 0;
+    foreach (const QtlMovieJob* job, _jobs) {
+        percent += job->task()->progress();
+    }
+    return _jobs.isEmpty() ? 0 : (percent * maximum) / (100 * _jobs.size());
+}
+
+
 //-----------------------------------------------------------------------------
 // Invoked by the "Transcode ..." buttons.
 //-----------------------------------------------------------------------------
@@ -184,20 +260,15 @@ bool QtlMovieMainWindow::startNewJob(QtlMovieTask* task)
 void QtlMovieMainWindow::startTranscoding()
 {
     // Fool-proof check.
-    if (_job != 0) {
+    if (!_jobs.isEmpty()) {
         log()->line(tr("Internal error, transcoding job already created."));
         return;
     }
 
     // The start processing depends on the single task vs. batch mode.
     if (_batchMode) {
-        // Batch mode. Loop until a job is successfully started.
-        // We exit the loop either when there is no more job to start (task == 0)
-        // or a job was successfully started.
-        QtlMovieTask* task = 0;
-        do {
-            task = _ui.taskList->nextTask();
-        } while (task != 0 && !startNewJob(task));
+        // Batch mode. Start as many jobs as allowed.
+        startQueuedJobs();
     }
     else {
         // Single task mode. Get the task to execute.
@@ -235,6 +306,11 @@ void QtlMovieMainWindow::cancelTranscoding()
 
 void QtlMovieMainWindow::transcodingStarted()
 {
+    // Additional concurrent jobs do not affect the UI or the log of running jobs.
+    if (_jobs.size() > 1) {
+        return;
+    }
+
     // Clear the log if required.
     if (settings()->clearLogBeforeTranscode()) {
         _ui.log->clear();
@@ -256,6 +332,20 @@ void QtlMovieMainWindow::transcodingProgress(const QString& description, int cur
     // Restrict current within range.
     current = qBound(0, current, maximum);
 
+    // The current action of the emitting job may have changed from I/O to video encoding or vice versa.
+    balanceFFmpegThreads();
+
+    // With concurrent jobs, display the global progress of all jobs.
+    if (_jobs.size() > 1) {
+        _ui.progressBarEncode->setRange(0, 100);
+        _ui.progressBarEncode->setValue(globalProgress(100));
+        _ui.progressBarEncode->setTextVisible(true);
+        _ui.labelRemainingTime->setText(tr("%1 concurrent jobs").arg(_jobs.size()));
+        _ui.labelRemainingTime->setVisible(true);
+        setIconTaskBarValue(globalProgress(1000), 1000);
+        return;
+    }
+
     // Progress bar.
     if (maximum <= 0) {
         // Cannot evaluate the progression, display a "busy" progress bar without percentage.
@@ -286,8 +376,8 @@ void QtlMovieMainWindow::transcodingProgress(const QString& description, int cur
     }
 
     // Update the Windows task bar button.
-    if (_job != 0) {
-        setIconTaskBarValue(_job->currentProgress(current, maximum, 1000), 1000);
+    if (!_jobs.isEmpty()) {
+        setIconTaskBarValue(_jobs.first()->currentProgress(1000), 1000);
     }
 }
 
@@ -298,36 +388,45 @@ void QtlMovieMainWindow::transcodingProgress(const QString& description, int cur
 
 void QtlMovieMainWindow::transcodingStopped(bool success)
 {
-    // Check if a transcoding job was actually in progress.
-    if (_job != 0) {
+    Q_UNUSED(success);
+
+    // Check if the transcoding job was actually in progress.
+    QtlMovieJob* const job = qobject_cast<QtlMovieJob*>(sender());
+    if (job != 0 && _jobs.removeOne(job)) {
 
         // Play notification sound at complete end of all jobs.
-        if (settings()->playSoundOnCompletion() && (!_batchMode || !_ui.taskList->hasQueuedTasks())) {
+        if (settings()->playSoundOnCompletion() && _jobs.isEmpty() && (!_batchMode || !_ui.taskList->hasQueuedTasks())) {
             playNotificationSound();
         }
 
         // Save log file if required.
         if (settings()->saveLogAfterTranscode()) {
-            const QString logFile(_job->task()->outputFile()->fileName() + settings()->logFileExtension());
+            const QString logFile(job->task()->outputFile()->fileName() + settings()->logFileExtension());
             _ui.log->saveToFile(logFile);
             log()->line(tr("Saved log to %1").arg(logFile));
         }
 
         // Delete transcoding job.
-        _job->deleteLater();
-        _job = 0;
+        job->deleteLater();
     }
 
-    // Update UI.
-    transcodingUpdateUi(false);
+    // Other concurrent jobs may now get more threads for their video encodings.
+    balanceFFmpegThreads();
+
+    // Update UI when the last job completes.
+    if (_jobs.isEmpty()) {
+        transcodingUpdateUi(false);
+    }
 
     // If the application needs to be closed, close it now.
     if (closePending()) {
-        close();
+        if (_jobs.isEmpty()) {
+            close();
+        }
     }
     else if (_batchMode) {
-        // In batch mode, start the next task, if any.
-        startTranscoding();
+        // In batch mode, start the next tasks, if any.
+        startQueuedJobs();
     }
 }
 
@@ -339,14 +438,14 @@ void QtlMovieMainWindow::transcodingStopped(bool success)
 QtlMovieMainWindow::CancelStatus QtlMovieMainWindow::proposeToCancel()
 {
     // If there is nothing to cancel now, no need to ask.
-    if (_job == 0) {
+    if (_jobs.isEmpty()) {
         return NothingToCancel;
     }
 
     // Ask the user if we should cancel the current transcoding?
     const bool confirm = qtlConfirm(this, tr("Do you want to abort the current transcoding ?"));
 
-    if (_job == 0) {
+    if (_jobs.isEmpty()) {
         // If all transcoding completed in the meantime, all clear...
         return NothingToCancel;
     }
@@ -369,8 +468,11 @@ QtlMovieMainWindow::CancelStatus QtlMovieMainWindow::proposeToCancel()
 
 void QtlMovieMainWindow::deferredAbort()
 {
-    if (_job != 0) {
-        _job->abort();
+    // Abort all concurrent jobs. Iterate on a copy of the list since
+    // jobs may complete and be removed from _jobs during abort().
+    const QList<QtlMovieJob*> jobs(_jobs);
+    foreach (QtlMovieJob* job, jobs) {
+        job->abort();
     }
 }
 
@@ -138,8 +138,33 @@ private:
     //!
     bool startNewJob(QtlMovieTask* task);
 
+    //!
+    //! In batch mode, start queued tasks up to the maximum number of concurrent jobs.
+    //!
+    void startQueuedJobs();
+
+    //!
+    //! In batch mode, get the next queued task which can be started now.
+    //! @return The next task to start or zero if there is none.
+    //!
+    QtlMovieTask* nextStartableTask() const;
+
+    //!
+    //! Split the processors between the jobs which still have video encodings to execute.
+    //! I/O-bound jobs (remux, DVD authoring, subtitles extraction, etc.) do not use any share.
+    //! @param [in] newEncodings Number of additional video encodings which are about to start.
+    //!
+    void balanceFFmpegThreads(int newEncodings = 0);
+
+    //!
+    //! Get the global progress of all running jobs.
+    //! @param [in] maximum Value for completion of all jobs.
+    //! @return A value between 0 and @a maximum.
+    //!
+    int globalProgress(int maximum) const;
+
     Ui::QtlMovieMainWindow _ui;                 //!< UI from Qt Designer.
-    QtlMovieJob*           _job;                //!< Current transcoding job.
+    QList<QtlMovieJob*>    _jobs;               //!< Currently running transcoding jobs.
     bool                   _batchMode;          //!< The UI is currently in batch mode (ie not single file mode).
     bool                   _restartRequested;   //!< A restart of the application is requested.
 
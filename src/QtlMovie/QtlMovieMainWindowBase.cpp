@@ -40,6 +40,7 @@
 #include "QtlSysInfo.h"
 #include "QtlStringUtils.h"
 #include "QtlMessageBoxUtils.h"
+#include "QtsDvdMedia.h"
 
 
 //-----------------------------------------------------------------------------
@@ -92,6 +93,9 @@ void QtlMovieMainWindowBase::setupUserInterface(QtlLogger* log, QAction* aboutQt
     // Create and load settings. Ignore errors (typically default settings file not yet created).
     _settings = new QtlMovieSettings(_log, this);
 
+    // Use the application cache for DVD encryption keys.
+    QtsDvdMedia::setKeyCacheDirectory(_settings->dvdKeyCacheDirectory());
+
     // Restore the window geometry from the saved settings.
     _settings->restoreGeometry(this);
     _settings->restoreState(this);
@@ -226,6 +230,7 @@ void QtlMovieMainWindowBase::editSettings()
     if (edit.exec() == QDialog::Accepted) {
         // Button "OK" has been selected, update settings from the values in the dialog box.
         edit.applySettings();
+        QtsDvdMedia::setKeyCacheDirectory(_settings->dvdKeyCacheDirectory());
         applyUserInterfaceSettings(false);
     }
 }
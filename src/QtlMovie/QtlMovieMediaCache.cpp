@@ -0,0 +1,229 @@
+//----------------------------------------------------------------------------
+//
+// Copyright (c) 2013-2017, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//
+// Define the class QtlMovieMediaCache.
+//
+//----------------------------------------------------------------------------
+
+#include "QtlMovieMediaCache.h"
+#include "QtlFile.h"
+
+namespace {
+    // Identification of cache files. Increment the version when the format
+    // of cache files or the analysis of input files changes.
+    const quint32 CACHE_MAGIC   = 0x514D4D43;  // "QMMC"
+    const quint32 CACHE_VERSION = 1;
+
+    // Suffix of cache files.
+    const char* const CACHE_SUFFIX = ".qmc";
+}
+
+
+//----------------------------------------------------------------------------
+// Constructor.
+//----------------------------------------------------------------------------
+
+QtlMovieMediaCache::QtlMovieMediaCache(const QtlMovieSettings* settings, QtlLogger* log) :
+    _settings(settings),
+    _log(log),
+    _directory(QStandardPaths::writableLocation(QStandardPaths::CacheLocation))
+{
+    Q_ASSERT(settings != 0);
+    Q_ASSERT(log != 0);
+
+    // Without a cache location on this system, the cache is disabled.
+    if (!_directory.isEmpty()) {
+        _directory.append(QDir::separator());
+        _directory.append("mediainfo");
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Check if the cache is enabled in the settings.
+//----------------------------------------------------------------------------
+
+bool QtlMovieMediaCache::isEnabled() const
+{
+    return _settings->mediaCacheSize() > 0 && !_directory.isEmpty();
+}
+
+
+//----------------------------------------------------------------------------
+// Get the name of the cache file for a key.
+//----------------------------------------------------------------------------
+
+QString QtlMovieMediaCache::cacheFileName(const QString& key) const
+{
+    return _directory + QDir::separator() + key + CACHE_SUFFIX;
+}
+
+
+//----------------------------------------------------------------------------
+// Compute the cache key of a file, without checking the settings.
+//----------------------------------------------------------------------------
+
+QString QtlMovieMediaCache::computeFileKey(const QString& fileName, const QStringList& options)
+{
+    const QFileInfo info(fileName);
+    QFile file(fileName);
+    if (!info.isFile() || !file.open(QFile::ReadOnly)) {
+        return QString();
+    }
+
+    // File identity: path, size, modification time and analysis options.
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(QStringLiteral("%1|%2|%3|%4|%5")
+                 .arg(CACHE_VERSION)
+                 .arg(QtlFile::absoluteNativeFilePath(fileName))
+                 .arg(info.size())
+                 .arg(info.lastModified().toMSecsSinceEpoch())
+                 .arg(options.join('|'))
+                 .toUtf8());
+
+    // File content: first and last bytes. Some tools rewrite files without
+    // changing their size or modification time, the content hash catches it.
+    const qint64 size = info.size();
+    const qint64 chunk = QTL_MEDIA_CACHE_HASH_SIZE;
+    const QByteArray head(file.read(chunk));
+    if (head.size() != qMin(size, chunk)) {
+        return QString();
+    }
+    hash.addData(head);
+    if (size > chunk) {
+        // Do not read the same bytes twice on small files.
+        const qint64 tailStart = qMax(chunk, size - chunk);
+        if (!file.seek(tailStart)) {
+            return QString();
+        }
+        const QByteArray tail(file.read(size - tailStart));
+        if (tail.size() != size - tailStart) {
+            return QString();
+        }
+        hash.addData(tail);
+    }
+
+    return QString::fromLatin1(hash.result().toHex());
+}
+
+
+//----------------------------------------------------------------------------
+// Load the analysis results of a file from the cache.
+//----------------------------------------------------------------------------
+
+bool QtlMovieMediaCache::load(const QString& key, Entry& entry) const
+{
+    if (key.isEmpty() || !isEnabled()) {
+        return false;
+    }
+
+    QFile file(cacheFileName(key));
+    if (!file.open(QFile::ReadOnly)) {
+        return false;
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_0);
+
+    quint32 magic = 0;
+    quint32 version = 0;
+    QString storedKey;
+    stream >> magic >> version >> storedKey;
+    if (stream.status() != QDataStream::Ok || magic != CACHE_MAGIC || version != CACHE_VERSION || storedKey != key) {
+        _log->debug(QObject::tr("Ignoring invalid media cache file %1").arg(file.fileName()));
+        return false;
+    }
+
+    stream >> static_cast<QMap<QString,QString>&>(entry.ffInfo) >> entry.isTs >> entry.isM2ts >> entry.isSubtitle;
+    if (stream.status() != QDataStream::Ok || !QtlMediaStreamInfo::deserialize(stream, entry.streams)) {
+        _log->debug(QObject::tr("Ignoring corrupted media cache file %1").arg(file.fileName()));
+        return false;
+    }
+
+    file.close();
+
+#if QT_VERSION >= QT_VERSION_CHECK(5,10,0)
+    // Mark the entry as recently used. Older versions of Qt cannot set
+    // the file time, the entries are then purged in storage order.
+    if (file.open(QFile::ReadWrite)) {
+        file.setFileTime(QDateTime::currentDateTime(), QFileDevice::FileModificationTime);
+    }
+#endif
+
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Store the analysis results of a file in the cache.
+//----------------------------------------------------------------------------
+
+bool QtlMovieMediaCache::store(const QString& key, const Entry& entry) const
+{
+    if (key.isEmpty() || !isEnabled() || !QDir().mkpath(_directory)) {
+        return false;
+    }
+
+    // Write a temporary file and rename it on commit.
+    // Concurrent instances of the application never see a partial cache file.
+    QSaveFile file(cacheFileName(key));
+    if (!file.open(QFile::WriteOnly)) {
+        _log->debug(QObject::tr("Cannot create media cache file %1").arg(file.fileName()));
+        return false;
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_0);
+    stream << CACHE_MAGIC << CACHE_VERSION << key
+           << static_cast<const QMap<QString,QString>&>(entry.ffInfo)
+           << entry.isTs << entry.isM2ts << entry.isSubtitle;
+    QtlMediaStreamInfo::serialize(stream, entry.streams);
+
+    if (stream.status() != QDataStream::Ok || !file.commit()) {
+        _log->debug(QObject::tr("Error writing media cache file %1").arg(file.fileName()));
+        return false;
+    }
+
+    // Keep the cache size within limits.
+    purge(_settings->mediaCacheSize());
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Remove the least recently used entries when the cache is full.
+//----------------------------------------------------------------------------
+
+void QtlMovieMediaCache::purge(int maxEntries) const
+{
+    // Most recently used files first.
+    const QFileInfoList files(QDir(_directory).entryInfoList(QStringList(QStringLiteral("*") + CACHE_SUFFIX), QDir::Files, QDir::Time));
+    for (int i = qMax(0, maxEntries); i < files.size(); ++i) {
+        QFile::remove(files[i].absoluteFilePath());
+    }
+}
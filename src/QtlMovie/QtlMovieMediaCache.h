@@ -0,0 +1,140 @@
+//----------------------------------------------------------------------------
+//
+// Copyright (c) 2013-2017, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//!
+//! @file QtlMovieMediaCache.h
+//!
+//! Declare the class QtlMovieMediaCache.
+//!
+//----------------------------------------------------------------------------
+
+#ifndef QTLMOVIEMEDIACACHE_H
+#define QTLMOVIEMEDIACACHE_H
+
+#include "QtlMovieSettings.h"
+#include "QtlMovieFFprobeTags.h"
+#include "QtlMediaStreamInfo.h"
+
+//!
+//! An on-disk cache of media analysis results of input files.
+//!
+//! The analysis of an input file (ffprobe, search for Teletext subtitles and
+//! Closed Captions) can be long, especially on DVD media. Its results are stored
+//! on disk, one cache file per analyzed file. When the same file is opened again,
+//! the results are reloaded from the cache instead of analyzing the file again.
+//!
+//! A cache entry is identified by a key which is computed from the path, size and
+//! modification time of the file, a hash of its first and last bytes and the
+//! settings which influence the analysis. When the file is modified, its key
+//! changes and the previous entry is never used again. Obsolete entries are
+//! eventually removed when the number of cache files exceeds the maximum size
+//! from the settings, the least recently used entries first.
+//!
+class QtlMovieMediaCache
+{
+public:
+    //!
+    //! Content of a cache entry: the analysis results of a file.
+    //!
+    struct Entry
+    {
+        QtlMovieFFprobeTags    ffInfo;      //!< Media info in ffprobe flat format.
+        QtlMediaStreamInfoList streams;     //!< Stream information, including Teletext and Closed Captions.
+        bool                   isTs;        //!< File is a transport stream (TS or M2TS format).
+        bool                   isM2ts;      //!< File has M2TS format.
+        bool                   isSubtitle;  //!< File is a pure subtitle file, no container format.
+
+        //!
+        //! Constructor.
+        //!
+        Entry() : ffInfo(), streams(), isTs(false), isM2ts(false), isSubtitle(false) {}
+    };
+
+    //!
+    //! Constructor.
+    //! @param [in] settings Application settings.
+    //! @param [in] log Where to log errors.
+    //!
+    QtlMovieMediaCache(const QtlMovieSettings* settings, QtlLogger* log);
+
+    //!
+    //! Check if the cache is enabled in the settings.
+    //! @return True if the cache is enabled.
+    //!
+    bool isEnabled() const;
+
+    //!
+    //! Compute the cache key of a file, even if the cache is disabled.
+    //! This static method reads the first and last bytes of the file. It does not use
+    //! the settings and can be called from any thread, away from the GUI thread.
+    //! @param [in] fileName Name of the file to analyze.
+    //! @param [in] options Additional analysis options which influence the analysis results.
+    //! @return The cache key or an empty string if the file cannot be read.
+    //!
+    static QString computeFileKey(const QString& fileName, const QStringList& options = QStringList());
+
+    //!
+    //! Load the analysis results of a file from the cache.
+    //! @param [in] key The cache key of the file, as returned by computeFileKey().
+    //! @param [out] entry The analysis results.
+    //! @return True if the results were found in the cache, false otherwise.
+    //!
+    bool load(const QString& key, Entry& entry) const;
+
+    //!
+    //! Store the analysis results of a file in the cache.
+    //! The least recently used entries are removed when the cache is full.
+    //! @param [in] key The cache key of the file, as returned by computeFileKey().
+    //! @param [in] entry The analysis results.
+    //! @return True on success, false on error.
+    //!
+    bool store(const QString& key, const Entry& entry) const;
+
+private:
+    const QtlMovieSettings* _settings;  //!< Application settings.
+    QtlLogger*              _log;       //!< Where to log errors.
+    QString                 _directory; //!< Cache directory.
+
+    //!
+    //! Get the name of the cache file for a key.
+    //! @param [in] key The cache key.
+    //! @return The cache file name.
+    //!
+    QString cacheFileName(const QString& key) const;
+
+    //!
+    //! Remove the least recently used entries when the cache is full.
+    //! @param [in] maxEntries Maximum number of entries to keep.
+    //!
+    void purge(int maxEntries) const;
+
+    // Unaccessible operations.
+    QtlMovieMediaCache() Q_DECL_EQ_DELETE;
+    Q_DISABLE_COPY(QtlMovieMediaCache)
+};
+
+#endif // QTLMOVIEMEDIACACHE_H
@@ -0,0 +1,164 @@
+//----------------------------------------------------------------------------
+//
+// Copyright (c) 2013-2017, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//
+// Define the class QtlMovieProcessDataPull.
+//
+//----------------------------------------------------------------------------
+
+#include "QtlMovieProcessDataPull.h"
+
+
+//----------------------------------------------------------------------------
+// Constructor.
+//----------------------------------------------------------------------------
+
+QtlMovieProcessDataPull::QtlMovieProcessDataPull(QtlMovieProcess* producer,
+                                                 int transferSize,
+                                                 int minBufferSize,
+                                                 QtlLogger* log,
+                                                 QObject* parent) :
+    QtlDataPull(minBufferSize, log, parent),
+    _producer(producer),
+    _buffer(qMax(1024, transferSize)),
+    _producerSuccess(false)
+{
+    Q_ASSERT(_producer != 0);
+    connect(_producer, &QtlMovieProcess::readyReadOutputData, this, &QtlMovieProcessDataPull::producerDataReady);
+    connect(_producer, &QtlMovieProcess::progress, this, &QtlMovieProcessDataPull::producerProgressed);
+    connect(_producer, &QtlMovieProcess::completed, this, &QtlMovieProcessDataPull::producerCompleted);
+
+    // The total size of the transfer is unknown. The progress is reported by the producer,
+    // not by the superclass: make progress available but never reach the reporting interval.
+    setProgressMaxHint(1);
+    setProgressIntervalInBytes(std::numeric_limits<qint64>::max());
+}
+
+
+//----------------------------------------------------------------------------
+// Initialize the transfer.
+//----------------------------------------------------------------------------
+
+bool QtlMovieProcessDataPull::initializeTransfer()
+{
+    // The producer must have a binary standard output to pull from.
+    if (_producer->outputDevice() == 0) {
+        log()->line(tr("Internal error, process has no binary output"));
+        return false;
+    }
+
+    // Start the producer process. Its output is pulled when available.
+    _producerSuccess = false;
+    return _producer->start();
+}
+
+
+//----------------------------------------------------------------------------
+// Invoked when more data is needed.
+//----------------------------------------------------------------------------
+
+bool QtlMovieProcessDataPull::needTransfer(qint64 maxSize)
+{
+    QIODevice* input = _producer->outputDevice();
+    Q_ASSERT(input != 0);
+
+    // Maximum size of data to read.
+    qint64 count = qMin<qint64>(_buffer.size(), input->bytesAvailable());
+    if (maxSize >= 0 && maxSize < count) {
+        count = maxSize;
+    }
+
+    if (count > 0) {
+        // Some data are available from the producer, transfer them now.
+        count = input->read(reinterpret_cast<char*>(_buffer.data()), count);
+        if (count < 0) {
+            log()->line(tr("Error reading output of %1").arg(_producer->execFile()->name()));
+            return false;
+        }
+        return count == 0 || write(_buffer.data(), count);
+    }
+    else if (_producer->isCompleted()) {
+        // All output data were read, transfer completed when the producer succeeded.
+        if (_producerSuccess) {
+            close();
+        }
+        return _producerSuccess;
+    }
+    else {
+        // Nothing to transfer for now, producerDataReady() will restart the transfer.
+        return true;
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Invoked when the producer process has some data on its standard output.
+//----------------------------------------------------------------------------
+
+void QtlMovieProcessDataPull::producerDataReady()
+{
+    processNewStateLater();
+}
+
+
+//----------------------------------------------------------------------------
+// Invoked when the producer process reports some progress.
+//----------------------------------------------------------------------------
+
+void QtlMovieProcessDataPull::producerProgressed(const QString& description, int current, int maximum, int elapsedSeconds, int remainingSeconds)
+{
+    Q_UNUSED(description);
+    Q_UNUSED(elapsedSeconds);
+    Q_UNUSED(remainingSeconds);
+    if (maximum > 0) {
+        emit progress(current, maximum);
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Invoked when the producer process completes.
+//----------------------------------------------------------------------------
+
+void QtlMovieProcessDataPull::producerCompleted(bool success)
+{
+    _producerSuccess = success;
+    processNewStateLater();
+}
+
+
+//----------------------------------------------------------------------------
+// Cleanup the transfer.
+//----------------------------------------------------------------------------
+
+void QtlMovieProcessDataPull::cleanupTransfer(bool closed)
+{
+    // If the consumer stopped before the end, kill the producer.
+    if (!closed && _producer->isStarted() && !_producer->isCompleted()) {
+        _producer->abort();
+    }
+}
@@ -0,0 +1,142 @@
+//----------------------------------------------------------------------------
+//
+// Copyright (c) 2013-2017, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//!
+//! @file QtlMovieProcessDataPull.h
+//!
+//! Declare the class QtlMovieProcessDataPull.
+//!
+//----------------------------------------------------------------------------
+
+#ifndef QTLMOVIEPROCESSDATAPULL_H
+#define QTLMOVIEPROCESSDATAPULL_H
+
+#include <QtCore>
+#include "QtlDataPull.h"
+#include "QtlByteBlock.h"
+#include "QtlMovieProcess.h"
+
+//!
+//! A class to pull the standard output of a process into the standard input of another one.
+//! The producer process must have been created with binary output. It is started when
+//! the transfer starts and it is aborted when the transfer is interrupted. This is used
+//! to chain two processes without writing an intermediate file. The progress of the
+//! producer is reported as progress of the transfer.
+//!
+class QtlMovieProcessDataPull : public QtlDataPull
+{
+    Q_OBJECT
+
+public:
+    //!
+    //! Default transfer size in bytes (1 MB).
+    //!
+    static const int DEFAULT_TRANSFER_SIZE = 1024 * 1024;
+
+    //!
+    //! Constructor.
+    //! @param [in] producer The process which produces the data on its standard output.
+    //! It is not owned by this object. It should keep its parent (typically a job)
+    //! since the resolution of its job variables depends on it.
+    //! @param [in] transferSize Maximum data transfer size in bytes.
+    //! @param [in] minBufferSize The minimum buffer size is the lower limit of the
+    //! buffered data. When the amount of data not yet written to the device is lower
+    //! than this size, new data is pulled from the producer.
+    //! @param [in] log Optional message logger.
+    //! @param [in] parent Optional parent object.
+    //!
+    explicit QtlMovieProcessDataPull(QtlMovieProcess* producer,
+                                     int transferSize = DEFAULT_TRANSFER_SIZE,
+                                     int minBufferSize = DEFAULT_MIN_BUFFER_SIZE,
+                                     QtlLogger* log = 0,
+                                     QObject* parent = 0);
+
+    //!
+    //! Get the producer process.
+    //! @return The producer process.
+    //!
+    QtlMovieProcess* producer() const
+    {
+        return _producer;
+    }
+
+protected:
+    //!
+    //! Initialize the transfer.
+    //! Reimplemented from QtlDataPull.
+    //! @return True on success, false on error.
+    //!
+    virtual bool initializeTransfer() Q_DECL_OVERRIDE;
+
+    //!
+    //! Invoked when more data is needed.
+    //! Reimplemented from QtlDataPull.
+    //! @param [in] maxSize Maximum size in bytes of the requested transfer.
+    //! @return True on success, false on error.
+    //!
+    virtual bool needTransfer(qint64 maxSize) Q_DECL_OVERRIDE;
+
+    //!
+    //! Cleanup the transfer.
+    //! Reimplemented from QtlDataPull.
+    //! @param [in] closed If true, this is a clean termination.
+    //!
+    virtual void cleanupTransfer(bool closed) Q_DECL_OVERRIDE;
+
+private slots:
+    //!
+    //! Invoked when the producer process has some data on its standard output.
+    //!
+    void producerDataReady();
+
+    //!
+    //! Invoked when the producer process reports some progress.
+    //! @param [in] description The description of the producer process.
+    //! @param [in] current Current value.
+    //! @param [in] maximum Value indicating full completion.
+    //! @param [in] elapsedSeconds Elapsed seconds since the producer started.
+    //! @param [in] remainingSeconds Estimated remaining seconds to process.
+    //!
+    void producerProgressed(const QString& description, int current, int maximum, int elapsedSeconds, int remainingSeconds);
+
+    //!
+    //! Invoked when the producer process completes.
+    //! @param [in] success True when the process completed successfully.
+    //!
+    void producerCompleted(bool success);
+
+private:
+    QtlMovieProcess* _producer;        //!< Process producing the data.
+    QtlByteBlock     _buffer;          //!< Transfer buffer.
+    bool             _producerSuccess; //!< The producer process completed successfully.
+
+    // Unaccessible operations.
+    QtlMovieProcessDataPull() Q_DECL_EQ_DELETE;
+    Q_DISABLE_COPY(QtlMovieProcessDataPull)
+};
+
+#endif // QTLMOVIEPROCESSDATAPULL_H
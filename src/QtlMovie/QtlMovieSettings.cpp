@@ -169,6 +169,22 @@ void QtlMovieSettings::setInitialInputDir(const QString& initialInputDir)
 }
 
 
+//----------------------------------------------------------------------------
+// Directory of the persistent cache of DVD encryption keys.
+//----------------------------------------------------------------------------
+
+QString QtlMovieSettings::dvdKeyCacheDirectory() const
+{
+    return dvdKeyCache() ? dvdKeyCacheLocation() : QString();
+}
+
+QString QtlMovieSettings::dvdKeyCacheLocation() const
+{
+    const QString cache(QStandardPaths::writableLocation(QStandardPaths::CacheLocation));
+    return cache.isEmpty() ? QString() : cache + QStringLiteral("/dvdcss");
+}
+
+
 //----------------------------------------------------------------------------
 // Default output directory for a given output type.
 //----------------------------------------------------------------------------
@@ -115,6 +115,19 @@ public:
     //!
     void setDefaultOutputDir(const QString& outputType, const QString& defaultOutDir);
 
+    //!
+    //! Get the directory of the persistent cache of DVD encryption keys.
+    //! @return The cache directory or an empty string if the cache is disabled.
+    //!
+    QString dvdKeyCacheDirectory() const;
+
+    //!
+    //! Get the location of the persistent cache of DVD encryption keys, even if the cache is disabled.
+    //! Keys which were saved while the cache was enabled can be purged from there.
+    //! @return The cache location or an empty string if the system has no cache location.
+    //!
+    QString dvdKeyCacheLocation() const;
+
     //!
     //! Get the list of language codes for the intended audience.
     //! @return A list of language codes for the intended audience.
@@ -212,6 +225,7 @@ public:
     QTL_SETTINGS_STRING(defaultDvdExtractionDir, setDefaultDvdExtractionDir, "")
     QTL_SETTINGS_BOOL(dvdExtractDirTree, setDvdExtractDirTree, QTL_DVD_EXTRACT_DIR_TREE)
     QTL_SETTINGS_BOOL(dvdUseMaxSpeed, setDvdUseMaxSpeed, QTL_DVD_MAX_SPEED)
+    QTL_SETTINGS_BOOL(dvdKeyCache, setDvdKeyCache, QTL_DVD_KEY_CACHE)
     QTL_SETTINGS_BOOL(cleanupSubtitles, setCleanupSubtitles, QTL_CLEANUP_SUBTITLES)
     QTL_SETTINGS_BOOL(useSrtHtmlTags, setUseSrtHtmlTags, QTL_SRT_HTML_TAGS)
     QTL_SETTINGS_BOOL(downgradeSsaToSrt, setDowngradeSsaToSrt, QTL_DOWNGRADE_SSA_TO_SRT)
@@ -220,6 +234,9 @@ public:
     QTL_SETTINGS_INT(dvdAngle, setDvdAngle, QTL_DVD_ANGLE)
     QTL_SETTINGS_INT(dvdBurningSpeed, setDvdBurningSpeed, QTL_DVD_BURNING_SPEED)
     QTL_SETTINGS_BOOL(ffmpegLowPriority, setFFmpegLowPriority, QTL_FFMPEG_LOW_PRIORITY)
+    QTL_SETTINGS_INT(maxConcurrentJobs, setMaxConcurrentJobs, QTL_MAX_CONCURRENT_JOBS)
+    QTL_SETTINGS_INT(maxParallelActions, setMaxParallelActions, QTL_MAX_PARALLEL_ACTIONS)
+    QTL_SETTINGS_INT(mediaCacheSize, setMediaCacheSize, QTL_MEDIA_CACHE_SIZE)
 
     //
     // Inlined definitions of the getters and setters for media tools executable.
@@ -43,7 +43,8 @@ QtlMovieTask::QtlMovieTask(const QtlMovieSettings* settings, QtlLogger* log, QOb
     _settings(settings),
     _inFile(new QtlMovieInputFile("", settings, log, this)),
     _outFile(new QtlMovieOutputFile("", settings, log, this)),
-    _state(Queued)
+    _state(Queued),
+    _progress(0)
 {
     // Emit taskChanged when required.
     connect(_inFile,  &QtlMovieInputFile::fileNameChanged,    this, &QtlMovieTask::emitTaskChanged);
@@ -58,17 +59,22 @@ QtlMovieTask::QtlMovieTask(const QtlMovieSettings* settings, QtlLogger* log, QOb
 
 void QtlMovieTask::setStarted()
 {
+    setProgress(0);
     setState(Running);
 }
 
 void QtlMovieTask::setCompleted(bool success)
 {
+    if (success) {
+        setProgress(100);
+    }
     setState(success ? Success : Failed);
 }
 
 void QtlMovieTask::setRequeue()
 {
     if (_state != Running) {
+        setProgress(0);
         setState(Queued);
     }
 }
@@ -82,6 +88,20 @@ void QtlMovieTask::setState(State state)
 }
 
 
+//----------------------------------------------------------------------------
+// Set the progress of the task.
+//----------------------------------------------------------------------------
+
+void QtlMovieTask::setProgress(int percent)
+{
+    percent = qBound(0, percent, 100);
+    if (_progress != percent) {
+        _progress = percent;
+        emit progressChanged(this);
+    }
+}
+
+
 //----------------------------------------------------------------------------
 // This slot is used as relay to emit the signal taskChanged().
 //----------------------------------------------------------------------------
@@ -101,6 +101,22 @@ public:
         return _state;
     }
 
+    //!
+    //! Get the progress of the task.
+    //! @return The progress of the task in percent (0 to 100).
+    //!
+    int progress() const
+    {
+        return _progress;
+    }
+
+    //!
+    //! Set the progress of the task.
+    //! Typically invoked by the job which executes the task.
+    //! @param [in] percent The progress of the task in percent (0 to 100).
+    //!
+    void setProgress(int percent);
+
 signals:
     //!
     //! Emitted when the input file name, output file name or output type changes.
@@ -113,6 +129,12 @@ signals:
     //!
     void stateChanged(QtlMovieTask* task);
 
+    //!
+    //! Emitted when the progress of the task changes.
+    //! @param [in] task The changed task (ie. signal emitter).
+    //!
+    void progressChanged(QtlMovieTask* task);
+
 public slots:
     //!
     //! Invoked when the task starts.
@@ -139,6 +161,7 @@ private:
     QtlMovieInputFile*      _inFile;    //!< Input file description.
     QtlMovieOutputFile*     _outFile;   //!< Output file description.
     State                   _state;     //!< State of the task (queued, running, etc.)
+    int                     _progress;  //!< Progress of the task in percent.
 
     //!
     //! Set the current state of the task (queued, running, etc).
@@ -65,8 +65,8 @@ QtlMovieTaskList::QtlMovieTaskList(QWidget *parent) :
     // There is no direct method to do that, so we use a style sheet.
     setStyleSheet("selection-background-color: rgba(128, 128, 128, 50);");
 
-    // There are 3 columns: output type, input file name, input file name directory.
-    setColumnCount(3);
+    // There are 4 columns: output type, progress, input file name, input file name directory.
+    setColumnCount(4);
 
     // Setup headers.
     verticalHeader()->setVisible(false);
@@ -77,8 +77,9 @@ QtlMovieTaskList::QtlMovieTaskList(QWidget *parent) :
     horizontalHeader()->setStretchLastSection(true);
 
     qtlSetTableHorizontalHeader(this, 0, tr("Output"));
-    qtlSetTableHorizontalHeader(this, 1, tr("Input file"));
-    qtlSetTableHorizontalHeader(this, 2, tr("Input directory"));
+    qtlSetTableHorizontalHeader(this, 1, tr("Progress"), Qt::AlignRight | Qt::AlignVCenter);
+    qtlSetTableHorizontalHeader(this, 2, tr("Input file"));
+    qtlSetTableHorizontalHeader(this, 3, tr("Input directory"));
 
     // Select by row (one row = one task).
     setSelectionBehavior(QAbstractItemView::SelectRows);
@@ -171,6 +172,7 @@ void QtlMovieTaskList::addTask(QtlMovieTask* task, bool editNow)
         // Get notified when the task changes.
         connect(task, &QtlMovieTask::taskChanged, this, &QtlMovieTaskList::taskChanged);
         connect(task, &QtlMovieTask::stateChanged, this, &QtlMovieTaskList::taskStateChanged);
+        connect(task, &QtlMovieTask::progressChanged, this, &QtlMovieTaskList::taskChanged);
 
         // Edit the task if required.
         if (editNow) {
@@ -236,6 +238,23 @@ QtlMovieTask* QtlMovieTaskList::nextTask()
 }
 
 
+//-----------------------------------------------------------------------------
+// Get all tasks in "queued" state.
+//-----------------------------------------------------------------------------
+
+QList<QtlMovieTask*> QtlMovieTaskList::queuedTasks() const
+{
+    QList<QtlMovieTask*> tasks;
+    for (int row = 0; row < rowCount(); ++row) {
+        QtlMovieTask* const task = taskOfRow(row);
+        if (task != 0 && task->state() == QtlMovieTask::Queued) {
+            tasks << task;
+        }
+    }
+    return tasks;
+}
+
+
 //-----------------------------------------------------------------------------
 // Check if some queued tasks are present.
 //-----------------------------------------------------------------------------
@@ -280,14 +299,16 @@ void QtlMovieTaskList::updateRow(int row)
 {
     QtlMovieTask* task = taskOfRow(row);
     if (task != 0 && task->inputFile() != 0 && task->outputFile() != 0) {
-        // The columns contain the output type, input file name, input file directory.
+        // The columns contain the output type, progress, input file name, input file directory.
+        // The progress is displayed only while the task is running.
         const QString inFile(task->inputFile()->fileName());
         qtlSetTableRow(this,
                        row,
                        QtlStringList(QtlMovieOutputFile::outputTypeName(task->outputFile()->outputType()),
+                                     task->state() == QtlMovieTask::Running ? QStringLiteral("%1%").arg(task->progress()) : "",
                                      inFile.isEmpty() ? "" : QFileInfo(inFile).fileName(),
                                      inFile.isEmpty() ? "" : QtlFile::parentPath(inFile)),
-                       false, // copyHeaderTextAlignment
+                       true, // copyHeaderTextAlignment
                        Qt::ItemIsEnabled | Qt::ItemIsSelectable);
     }
 }
@@ -332,6 +353,9 @@ void QtlMovieTaskList::taskStateChanged(QtlMovieTask* task)
 {
     const int row = rowOfTask(task);
     if (row >= 0) {
+        // The progress is displayed only in running state.
+        updateRow(row);
+
         // Update the appearance of the row depending on the task state.
         // For color names, see http://www.w3.org/TR/SVG/types.html#ColorKeywords
         switch (task->state()) {
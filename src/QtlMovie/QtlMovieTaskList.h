@@ -85,6 +85,12 @@ public:
     //!
     QtlMovieTask* nextTask();
 
+    //!
+    //! Get all tasks in "queued" state.
+    //! @return The list of queued tasks, in execution order.
+    //!
+    QList<QtlMovieTask*> queuedTasks() const;
+
     //!
     //! Check if some queued tasks are present.
     //! @return True if some queued tasks are present, false otherwise.
@@ -149,7 +155,7 @@ public slots:
 
 private slots:
     //!
-    //! Triggered when the input file name, output file name or output type of a task changes.
+    //! Triggered when the input file name, output file name, output type or progress of a task changes.
     //! @param [in] task The changed task (ie. signal emitter).
     //!
     void taskChanged(QtlMovieTask* task);
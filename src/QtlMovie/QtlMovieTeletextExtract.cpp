@@ -49,13 +49,39 @@ QtlMovieTeletextExtract::QtlMovieTeletextExtract(const QString& inputFileName,
                                                  QObject* parent) :
     QtlMovieTsDemux(inputFileName, settings, log, parent),
     _demux(this),
-    _subrip(),
-    _outputFileName(outputFileName),
-    _pid(pid),
-    _page(teletextPage)
+    _targets()
 {
-    // Set the demux to collect the Teletext PID.
+    addTarget(pid, teletextPage, outputFileName);
+}
+
+
+//----------------------------------------------------------------------------
+// Destructor.
+//----------------------------------------------------------------------------
+
+QtlMovieTeletextExtract::~QtlMovieTeletextExtract()
+{
+    // The demux thread must not use our demux after this point.
+    stopDemux();
+}
+
+
+//----------------------------------------------------------------------------
+// Add another Teletext subtitle stream to extract.
+//----------------------------------------------------------------------------
+
+bool QtlMovieTeletextExtract::addTarget(QtsPid pid, int teletextPage, const QString& outputFileName)
+{
+    const quint32 key = targetKey(pid, teletextPage);
+    if (isStarted() || _targets.contains(key)) {
+        return false;
+    }
+
+    // Set the demux to collect the Teletext PID. Only the extracted pages are decoded.
+    _targets.insert(key, TargetPtr(new Target(outputFileName)));
     _demux.addPid(pid);
+    _demux.addPage(teletextPage);
+    return true;
 }
 
 
@@ -70,10 +96,12 @@ bool QtlMovieTeletextExtract::start()
         return false;
     }
 
-    // Create the output file.
-    if (!_subrip.open(_outputFileName)) {
-        emitCompleted(false, tr("Error creating %1").arg(_outputFileName));
-        return true; // true = started (and completed as well in that case).
+    // Create the output files.
+    foreach (const TargetPtr& target, _targets) {
+        if (!target->subrip.open(target->outputFileName)) {
+            emitCompleted(false, tr("Error creating %1").arg(target->outputFileName));
+            return true; // true = started (and completed as well in that case).
+        }
     }
 
     return true;
@@ -86,17 +114,24 @@ bool QtlMovieTeletextExtract::start()
 
 void QtlMovieTeletextExtract::emitCompleted(bool success, const QString& message)
 {
-    if (_subrip.isOpen()) {
+    // From the demux thread, the superclass only terminates the thread.
+    // We will be invoked again in the thread of this object.
+    if (!inDemuxThread()) {
+
+        // Make sure the demux thread no longer uses the demux and the output files.
+        stopDemux();
 
-        // Flush pending Teletext messages.
+        // Flush pending Teletext messages while the output files are still open.
         _demux.flushTeletext();
 
-        // Close the output file.
-        _subrip.close();
-    }
+        // Close the output files.
+        foreach (const TargetPtr& target, _targets) {
+            target->subrip.close();
+        }
 
-    // Cleanup the demux.
-    demux()->reset();
+        // Cleanup the demux.
+        demux()->reset();
+    }
 
     // Notify the completion via super-class.
     QtlMovieTsDemux::emitCompleted(success, message);
@@ -109,7 +144,8 @@ void QtlMovieTeletextExtract::emitCompleted(bool success, const QString& message
 
 void QtlMovieTeletextExtract::handleTeletextMessage(QtsTeletextDemux& demux, const QtsTeletextFrame& frame)
 {
-    if (frame.pid() == _pid && frame.page() == _page && _subrip.isOpen()) {
-        _subrip.addFrame(frame.showTimestamp(), frame.hideTimestamp(), frame.lines());
+    const TargetPtr target(_targets.value(targetKey(frame.pid(), frame.page())));
+    if (!target.isNull() && target->subrip.isOpen()) {
+        target->subrip.addFrame(frame.showTimestamp(), frame.hideTimestamp(), frame.lines());
     }
 }
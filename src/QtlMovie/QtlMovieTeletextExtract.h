@@ -39,9 +39,14 @@
 #include "QtlMovieTsDemux.h"
 #include "QtsTeletextDemux.h"
 #include "QtlSubRipGenerator.h"
+#include "QtlSmartPointer.h"
 
 //!
-//! This class extracts one Teletext subtitle stream from an MPEG-TS file into an SRT file.
+//! This class extracts Teletext subtitle streams from an MPEG-TS file into SRT files.
+//!
+//! Each subtitle stream is identified by a PID and a Teletext page. One stream is
+//! specified in the constructor, more streams can be added using addTarget().
+//! All subtitle streams are extracted in one single reading of the MPEG-TS file.
 //!
 class QtlMovieTeletextExtract : public QtlMovieTsDemux, private QtsTeletextHandlerInterface
 {
@@ -51,7 +56,7 @@ public:
     //!
     //! Constructor.
     //! @param [in] inputFileName Input MPEG-TS file name.
-    //! @param [in] pid PID containing Teletext to extract.
+    //! @param [in] pid PID containing the first Teletext subtitles to extract.
     //! @param [in] teletextPage Teletext page.
     //! @param [in] outputFileName Output SRT file name.
     //! @param [in] settings Application settings.
@@ -66,6 +71,30 @@ public:
                             QtlLogger* log,
                             QObject *parent = 0);
 
+    //!
+    //! Destructor.
+    //!
+    virtual ~QtlMovieTeletextExtract();
+
+    //!
+    //! Add another Teletext subtitle stream to extract in the same reading of the input file.
+    //! Must be invoked before start().
+    //! @param [in] pid PID containing Teletext to extract.
+    //! @param [in] teletextPage Teletext page.
+    //! @param [in] outputFileName Output SRT file name.
+    //! @return True on success, false if already started or the same PID and page are already extracted.
+    //!
+    bool addTarget(QtsPid pid, int teletextPage, const QString& outputFileName);
+
+    //!
+    //! Get the number of Teletext subtitle streams to extract.
+    //! @return The number of Teletext subtitle streams to extract.
+    //!
+    int targetCount() const
+    {
+        return _targets.size();
+    }
+
     //!
     //! Start the extraction.
     //! Reimplemented from QtlMovieTsDemux.
@@ -93,11 +122,47 @@ protected:
     }
 
 private:
-    QtsTeletextDemux   _demux;          //!< Extract the Teletext frames from the file.
-    QtlSubRipGenerator _subrip;         //!< SRT file generator.
-    QString            _outputFileName; //!< Output SRT file name.
-    QtsPid             _pid;            //!< PID containing Teletext to extract.
-    int                _page;           //!< Teletext page.
+    //!
+    //! Description of one Teletext subtitle stream to extract.
+    //!
+    class Target
+    {
+    public:
+        //!
+        //! Constructor.
+        //! @param [in] fileName Output SRT file name.
+        //!
+        Target(const QString& fileName) :
+            outputFileName(fileName),
+            subrip()
+        {
+        }
+        QString            outputFileName;  //!< Output SRT file name.
+        QtlSubRipGenerator subrip;          //!< SRT file generator.
+    private:
+        // Unaccessible operations.
+        Target() Q_DECL_EQ_DELETE;
+        Q_DISABLE_COPY(Target)
+    };
+
+    //!
+    //! Smart pointer to a Target (non thread-safe).
+    //!
+    typedef QtlSmartPointer<Target,QtlNullMutexLocker> TargetPtr;
+
+    //!
+    //! Build the index of a target from its PID and Teletext page.
+    //! @param [in] pid PID containing Teletext.
+    //! @param [in] page Teletext page.
+    //! @return The index of the target in _targets.
+    //!
+    static quint32 targetKey(QtsPid pid, int page)
+    {
+        return (quint32(pid) << 16) | quint32(page & 0xFFFF);
+    }
+
+    QtsTeletextDemux         _demux;    //!< Extract the Teletext frames from the file.
+    QMap<quint32, TargetPtr> _targets;  //!< Subtitle streams to extract, indexed by targetKey().
 
     //!
     //! Invoked when a complete Teletext message is available.
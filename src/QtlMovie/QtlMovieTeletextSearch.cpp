@@ -56,6 +56,17 @@ QtlMovieTeletextSearch::QtlMovieTeletextSearch(const QString& fileName,
 }
 
 
+//----------------------------------------------------------------------------
+// Destructor.
+//----------------------------------------------------------------------------
+
+QtlMovieTeletextSearch::~QtlMovieTeletextSearch()
+{
+    // The demux thread must not use our demux after this point.
+    stopDemux();
+}
+
+
 //----------------------------------------------------------------------------
 // Invoked when a complete table is available.
 //----------------------------------------------------------------------------
@@ -60,6 +60,11 @@ public:
                            QtlLogger* log,
                            QObject *parent = 0);
 
+    //!
+    //! Destructor.
+    //!
+    virtual ~QtlMovieTeletextSearch();
+
 signals:
     //!
     //! Emitted when a Teletext subtitle stream is found.
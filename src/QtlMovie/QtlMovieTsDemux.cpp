@@ -35,7 +35,7 @@
 
 
 //----------------------------------------------------------------------------
-// Constructor.
+// Constructor and destructor.
 //----------------------------------------------------------------------------
 
 QtlMovieTsDemux::QtlMovieTsDemux(const QString& fileName,
@@ -44,12 +44,52 @@ QtlMovieTsDemux::QtlMovieTsDemux(const QString& fileName,
                                  QObject* parent) :
     QtlMovieAction(settings, log, parent),
     _file(fileName),
-    _isM2ts(false),
-    _timerId(-1),
+    _hub(),
+    _thread(this),
+    _threadStatus(Running),
+    _threadSuccess(false),
+    _threadMessage(),
+    _currentPackets(0),
+    _progressPending(0),
+    _isM2ts(0),
     _totalPackets(0),
     _packetInterval(0),
-    _nextReport(0)
+    _teeAction(0),
+    _teePull(0),
+    _demuxDone(false),
+    _demuxMessage()
 {
+    // Get notified in our thread when the demux thread terminates.
+    connect(&_thread, &QThread::finished, this, &QtlMovieTsDemux::demuxThreadFinished, Qt::QueuedConnection);
+}
+
+QtlMovieTsDemux::~QtlMovieTsDemux()
+{
+    stopDemux();
+}
+
+
+//----------------------------------------------------------------------------
+// Feed an additional demux with the TS packets of the file.
+//----------------------------------------------------------------------------
+
+bool QtlMovieTsDemux::addDemux(QtsDemux* demux)
+{
+    return !isStarted() && _hub.addDemux(demux);
+}
+
+
+//----------------------------------------------------------------------------
+// Copy the TS packets of the file to another action.
+//----------------------------------------------------------------------------
+
+void QtlMovieTsDemux::setTee(QtlMovieAction* action, QtlThreadDataPull* dataPull)
+{
+    if (!isStarted() && action != 0 && dataPull != 0) {
+        _teeAction = action;
+        _teePull = dataPull;
+        connect(_teeAction, &QtlMovieAction::completed, this, &QtlMovieTsDemux::teeCompleted);
+    }
 }
 
 
@@ -70,88 +110,313 @@ bool QtlMovieTsDemux::start()
         return true; // true = started (and completed as well in that case.
     }
 
-    // Start immediate timer, a way to read continuously packets but return periodically to the event loop.
-    _timerId = startTimer(0);
-
     // Do not report progress more often that every 1% of the file size.
     _totalPackets = int(_file.size() / QTS_PKT_SIZE);
     _packetInterval = qMax(1, _totalPackets / 100);
-    _nextReport = _packetInterval;
 
-    // Will read packets later.
+    // Start the action which receives a copy of the packets.
+    if (_teeAction != 0 && !_teeAction->start()) {
+        emitCompleted(false, tr("Error starting %1").arg(_teeAction->description()));
+        return true;
+    }
+
+    // Read and demux packets in a separate thread. Start it from the event loop,
+    // after the subclasses have completed their own initialization.
+    QMetaObject::invokeMethod(this, "startDemux", Qt::QueuedConnection);
     return true;
 }
 
 
+//----------------------------------------------------------------------------
+// Start the demux thread, unless the action is already completed.
+//----------------------------------------------------------------------------
+
+void QtlMovieTsDemux::startDemux()
+{
+    if (!isCompleted() && !_thread.isRunning()) {
+        _thread.start();
+    }
+}
+
+
 //----------------------------------------------------------------------------
 // Abort analysis.
 //----------------------------------------------------------------------------
 
 void QtlMovieTsDemux::abort()
 {
+    // Make sure the demux is no longer used before subclasses complete.
+    stopDemux();
+
     // Declare the completion with error status but no message.
     emitCompleted(false);
 }
 
 
+//----------------------------------------------------------------------------
+// Stop the demux thread and wait for its termination.
+//----------------------------------------------------------------------------
+
+void QtlMovieTsDemux::stopDemux()
+{
+    if (!inDemuxThread()) {
+        _thread.requestInterruption();
+        _thread.wait();
+    }
+}
+
+
 //----------------------------------------------------------------------------
 // Emit the completed() signal.
 //----------------------------------------------------------------------------
 
 void QtlMovieTsDemux::emitCompleted(bool success, const QString& message)
 {
-    // Stop our polling for the file.
-    killTimer(_timerId);
-    _timerId = -1;
+    // When invoked from a demux handler, simply terminate the demux thread.
+    // The completion will be processed in demuxThreadFinished().
+    // With a tee, the thread continues to read the file without demuxing it.
+    if (inDemuxThread()) {
+        if (_threadStatus == Running) {
+            _threadStatus = Terminated;
+            _threadSuccess = success;
+            _threadMessage = message;
+            demux()->interruptFeed();
+        }
+        if (_teePull == 0) {
+            _thread.requestInterruption();
+        }
+        return;
+    }
+
+    // Wait for the demux thread to terminate.
+    stopDemux();
+
+    // Abort the action which receives a copy of the packets if still running.
+    // Its completion is no longer relevant.
+    if (_teeAction != 0 && _teeAction->isStarted() && !_teeAction->isCompleted()) {
+        disconnect(_teeAction, &QtlMovieAction::completed, this, &QtlMovieTsDemux::teeCompleted);
+        _teeAction->abort();
+    }
 
     // Close the file.
     _file.close();
-    disconnect(&_file, 0, this, 0);
 
-    // Cleanup the demux.
-    demux()->reset();
+    // Cleanup the demuxes.
+    if (_hub.demuxCount() > 0) {
+        _hub.reset();
+    }
+    else {
+        demux()->reset();
+    }
 
     // Notify the completion via super-class.
     QtlMovieAction::emitCompleted(success, message);
 }
 
 
-//-----------------------------------------------------------------------------
-// Event handler to handle timer.
-//-----------------------------------------------------------------------------
+//----------------------------------------------------------------------------
+// Read and demux the file, executed in the demux thread.
+//----------------------------------------------------------------------------
+
+void QtlMovieTsDemux::demuxFile()
+{
+    int nextReport = _packetInterval;
+    int readPackets = 0;
+    bool teeing = _teePull != 0;
+    QtsDemux* dmx = demux();
+
+    // With additional demuxes, route the packets through the hub.
+    // When a handler completes the action, the feed of the hub is interrupted.
+    if (_hub.demuxCount() > 0) {
+        _hub.addDemux(dmx);
+        dmx = &_hub;
+    }
+
+    // When a handler terminates the demux, continue reading the file for the tee.
+    while (_threadStatus == Running || (teeing && _threadStatus == Terminated && _threadSuccess)) {
+
+        // Stop when interrupted from the thread of this object.
+        if (_thread.isInterruptionRequested()) {
+            _threadStatus = Terminated;
+            _threadSuccess = false;
+            break;
+        }
+
+        // Get next TS packets, directly in the mapped file.
+        const QtsTsPacket* packets = 0;
+        const int count = _file.mapPackets(packets, QTL_TS_PACKETS_CHUNK);
+
+        // The file format is known after the first packets, publish it once.
+        if (readPackets == 0 && count > 0) {
+            _isM2ts.storeRelease(_file.tsFileType() == QtsTsFile::M2tsFile ? 1 : 0);
+        }
+
+        if (count < 0) {
+            _threadStatus = FileError;
+            break;
+        }
+        else if (count == 0) {
+            if (_threadStatus == Running) {
+                _threadStatus = EndOfFile;
+            }
+            if (teeing) {
+                _teePull->pushEnd();
+            }
+            break;
+        }
+
+        // Process packets. The batch is interrupted as soon as a handler completes the action.
+        if (_threadStatus == Running) {
+            dmx->feedPackets(packets, count);
+        }
+
+        // Copy the packets to the tee. Stop copying when the tee no longer accepts data.
+        if (teeing && !_teePull->push(packets, count * QTS_PKT_SIZE)) {
+            teeing = false;
+        }
+
+        // Report progress in the file. Do not queue a new report while the previous one is not yet processed.
+        readPackets += count;
+        _currentPackets.store(readPackets);
+        if (readPackets >= nextReport) {
+            if (_progressPending.testAndSetOrdered(0, 1)) {
+                QMetaObject::invokeMethod(this, "reportProgress", Qt::QueuedConnection);
+            }
+            nextReport = readPackets + _packetInterval;
+        }
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Invoked in the thread of this object when the demux thread terminates.
+//----------------------------------------------------------------------------
+
+void QtlMovieTsDemux::demuxThreadFinished()
+{
+    // Ignore termination after abort().
+    if (isCompleted()) {
+        return;
+    }
+
+    switch (_threadStatus) {
+    case EndOfFile:
+        demuxTerminated(true);
+        break;
+    case FileError:
+        demuxTerminated(false, tr("Error reading %1").arg(_file.fileName()));
+        break;
+    case Terminated:
+        demuxTerminated(_threadSuccess, _threadMessage);
+        break;
+    case Running:
+    default:
+        // Should not happen, the thread has returned.
+        demuxTerminated(false);
+        break;
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Process the termination of the demux, in the thread of this object.
+//----------------------------------------------------------------------------
+
+void QtlMovieTsDemux::demuxTerminated(bool success, const QString& message)
+{
+    if (success && _teeAction != 0 && !_teeAction->isCompleted()) {
+        // Wait for the completion of the tee action, see teeCompleted().
+        _demuxDone = true;
+        _demuxMessage = message;
+    }
+    else {
+        emitCompleted(success, message);
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Invoked when the action which receives a copy of the TS packets completes.
+//----------------------------------------------------------------------------
 
-void QtlMovieTsDemux::timerEvent(QTimerEvent* event)
+void QtlMovieTsDemux::teeCompleted(bool success)
 {
-    // This handler is invoked for all timer, make sure it is ours.
-    if (event == 0 || _timerId < 0 || event->timerId() != _timerId) {
-        // Not our poll timer, invoke superclass.
-        QtlMovieAction::timerEvent(event);
+    if (isCompleted()) {
+        // Already completed, nothing more to do.
         return;
     }
+    else if (!success) {
+        // The tee action failed, the whole action fails.
+        // The demux thread may still be running, stop it before subclasses cleanup their demux.
+        stopDemux();
+        emitCompleted(false);
+    }
+    else if (_demuxDone) {
+        // The demux already completed, now complete the action.
+        emitCompleted(true, _demuxMessage);
+    }
+    // Otherwise, wait for the termination of the demux thread.
+}
+
 
-    // Read TS packets.
-    QtsTsPacket buffer[QTL_TS_PACKETS_CHUNK];
-    const int count = _file.read(buffer, QTL_TS_PACKETS_CHUNK);
-    _isM2ts = _file.tsFileType() == QtsTsFile::M2tsFile;
+//----------------------------------------------------------------------------
+// Report progress in the thread of this object.
+//----------------------------------------------------------------------------
 
-    if (count < 0) {
-        // File error.
-        emitCompleted(false, tr("Error reading %1").arg(_file.fileName()));
+void QtlMovieTsDemux::reportProgress()
+{
+    _progressPending.store(0);
+    if (!isCompleted()) {
+        emitProgress(_currentPackets.load(), _totalPackets);
     }
-    else if (count == 0) {
-        // End of file.
-        emitCompleted(true);
+}
+
+
+//----------------------------------------------------------------------------
+// Logging, can be invoked from the demux thread.
+//----------------------------------------------------------------------------
+
+void QtlMovieTsDemux::text(const QString& text)
+{
+    if (inDemuxThread()) {
+        QMetaObject::invokeMethod(this, "logFromThread", Qt::QueuedConnection, Q_ARG(int, 0), Q_ARG(QString, text), Q_ARG(QColor, QColor()));
     }
     else {
-        // Process packets.
-        for (int i = 0; i < count; i++) {
-            demux()->feedPacket(buffer[i]);
-        }
-        // Report progress in the file.
-        const int current  = int(demux()->packetCount());
-        if (current >= _nextReport) {
-            emitProgress(current, _totalPackets);
-            _nextReport += _packetInterval;
-        }
+        QtlMovieAction::text(text);
+    }
+}
+
+void QtlMovieTsDemux::line(const QString& line, const QColor& color)
+{
+    if (inDemuxThread()) {
+        QMetaObject::invokeMethod(this, "logFromThread", Qt::QueuedConnection, Q_ARG(int, 1), Q_ARG(QString, line), Q_ARG(QColor, color));
+    }
+    else {
+        QtlMovieAction::line(line, color);
+    }
+}
+
+void QtlMovieTsDemux::debug(const QString& line, const QColor& color)
+{
+    if (inDemuxThread()) {
+        QMetaObject::invokeMethod(this, "logFromThread", Qt::QueuedConnection, Q_ARG(int, 2), Q_ARG(QString, line), Q_ARG(QColor, color));
+    }
+    else {
+        QtlMovieAction::debug(line, color);
+    }
+}
+
+void QtlMovieTsDemux::logFromThread(int type, const QString& line, const QColor& color)
+{
+    switch (type) {
+    case 0:
+        QtlMovieAction::text(line);
+        break;
+    case 1:
+        QtlMovieAction::line(line, color);
+        break;
+    default:
+        QtlMovieAction::debug(line, color);
+        break;
     }
 }
@@ -37,16 +37,32 @@
 
 #include <QObject>
 #include "QtlMovieAction.h"
-#include "QtsTsFile.h"
-#include "QtsDemux.h"
+#include "QtsMappedTsFile.h"
+#include "QtsDemuxHub.h"
+#include "QtlThreadDataPull.h"
 
 //!
 //! Abstract base class to read an MPEG-TS file and demux its content.
 //!
 //! Reading a TS file is not a blocking operation. When start() is invoked,
-//! the file is not synchronously read. The Qt event loop invokes the appropriate
-//! slots when data is available from the file. The completion is notified using
-//! the signal completed(), inherited from QtlMovieAction.
+//! the file is read and demuxed in a separate thread. The progress and the
+//! completion are notified in the thread of this object using the signals
+//! progress() and completed(), inherited from QtlMovieAction.
+//!
+//! Consequently, the handlers of the demux are invoked in the demux thread.
+//! Logging and signals from the handlers are safe since they are queued
+//! to the thread of this object. Invoking emitCompleted() from a handler
+//! terminates the demux thread and the completion is notified later.
+//! Subclasses shall invoke stopDemux() in their destructor. Subclasses which
+//! reimplement emitCompleted() shall invoke stopDemux() before using their demux
+//! when not in the demux thread.
+//!
+//! Other demuxes can be fed from the same reading of the file using addDemux().
+//! Several analyses of the same file then cost one single read. This is only
+//! infrastructure for now: no action of the application uses addDemux() yet.
+//!
+//! The content of the file can be simultaneously copied to another action, typically
+//! an FFmpeg process, using setTee(). The file is then read only once for both actions.
 //!
 class QtlMovieTsDemux : public QtlMovieAction
 {
@@ -65,6 +81,11 @@ public:
                     QtlLogger* log,
                     QObject *parent = 0);
 
+    //!
+    //! Destructor.
+    //!
+    virtual ~QtlMovieTsDemux();
+
     //!
     //! Start the analysis.
     //! Reimplemented from QtlMovieAction.
@@ -79,20 +100,80 @@ public:
     //!
     virtual void abort() Q_DECL_OVERRIDE;
 
+    //!
+    //! Get the name of the MPEG-TS file.
+    //! @return The name of the MPEG-TS file.
+    //!
+    QString fileName() const
+    {
+        return _file.fileName();
+    }
+
     //!
     //! Check if the input file has M2TS format.
     //! This information is available after reading at least one packet from the file.
+    //! It is set once by the demux thread and can be read from any thread.
     //! @return True if the input file has M2TS format.
     //!
     bool isM2tsFile() const
     {
-        return _isM2ts;
+        return _isM2ts.loadAcquire() != 0;
     }
 
+    //!
+    //! Feed an additional demux with the TS packets of the file.
+    //! Must be invoked before start(). The packets are routed to the demux of this
+    //! object and to all additional demuxes, according to their PID filters.
+    //! The handlers of the additional demuxes are invoked in the demux thread.
+    //! The completion of the action is driven by the demux of this object only.
+    //! @param [in] demux The additional demux. Not owned by this object.
+    //! It must remain valid until the action is completed or it is deleted first.
+    //! @return True on success, false if already started or @a demux is already attached.
+    //!
+    bool addDemux(QtsDemux* demux);
+
+    //!
+    //! Copy the TS packets of the file to another action while they are demuxed.
+    //! Must be invoked before start(). The other action is started and aborted with this one.
+    //! This action completes when both the demux and the other action are completed.
+    //! When a demux handler completes the action before the end of file, the file is
+    //! still read up to the end for the other action.
+    //! @param [in] action The action which receives the TS packets, typically a process.
+    //! The completion of this action is notified as part of the completion of @a action.
+    //! @param [in] dataPull The data pull which feeds @a action. It receives the packets
+    //! from the demux thread.
+    //!
+    void setTee(QtlMovieAction* action, QtlThreadDataPull* dataPull);
+
+    //!
+    //! Log text.
+    //! Reimplemented from QtlMovieAction to be invoked from the demux thread.
+    //! @param [in] text Text to log.
+    //!
+    virtual void text(const QString& text) Q_DECL_OVERRIDE;
+
+    //!
+    //! Log a line of text.
+    //! Reimplemented from QtlMovieAction to be invoked from the demux thread.
+    //! @param [in] line Line to log. No need to contain a trailing new-line character.
+    //! @param [in] color When a valid color is passed, try to display the text in this color.
+    //!
+    virtual void line(const QString& line, const QColor& color = QColor()) Q_DECL_OVERRIDE;
+
+    //!
+    //! Log a line of debug text.
+    //! Reimplemented from QtlMovieAction to be invoked from the demux thread.
+    //! @param [in] line Line to log. No need to contain a trailing new-line character.
+    //! @param [in] color When a valid color is passed, try to display the text in this color.
+    //!
+    virtual void debug(const QString& line, const QColor& color = QColor()) Q_DECL_OVERRIDE;
+
 protected:
     //!
     //! Emit the completed() signal.
     //! Reimplemented from QtlMovieAction.
+    //! When invoked from the demux thread, the demux thread terminates and
+    //! the signal is emitted later, in the thread of this object.
     //! @param [in] success True when the action completed successfully, false otherwise.
     //! @param [in] message Optional error message to log.
     //!
@@ -106,18 +187,117 @@ protected:
     virtual QtsDemux* demux() = 0;
 
     //!
-    //! Event handler to handle timer.
-    //! @param event Notified event.
+    //! Stop the demux thread and wait for its termination.
+    //! Must be invoked by the destructor of subclasses, before the demux is destroyed.
+    //! Does nothing when invoked from the demux thread.
+    //!
+    void stopDemux();
+
+    //!
+    //! Check if the current thread is the demux thread.
+    //! @return True if the current thread is the demux thread.
+    //!
+    bool inDemuxThread() const
+    {
+        return QThread::currentThread() == &_thread;
+    }
+
+private slots:
+    //!
+    //! Start the demux thread, unless the action is already completed.
+    //!
+    void startDemux();
+
+    //!
+    //! Invoked in the thread of this object when the demux thread terminates.
+    //!
+    void demuxThreadFinished();
+
+    //!
+    //! Report progress in the thread of this object.
+    //!
+    void reportProgress();
+
+    //!
+    //! Log text, from the demux thread.
+    //! @param [in] type Type of log (0: text, 1: line, 2: debug).
+    //! @param [in] line Text to log.
+    //! @param [in] color Optional color.
+    //!
+    void logFromThread(int type, const QString& line, const QColor& color);
+
+    //!
+    //! Invoked when the action which receives a copy of the TS packets completes.
+    //! @param [in] success True when the action completed successfully.
     //!
-    virtual void timerEvent(QTimerEvent* event) Q_DECL_OVERRIDE;
+    void teeCompleted(bool success);
 
 private:
-    QtsTsFile _file;            //!< TS file.
-    bool      _isM2ts;          //!< File has M2TS format.
-    int       _timerId;         //!< Repetitive timer.
-    int       _totalPackets;    //!< File size in packets.
-    int       _packetInterval;  //!< Min number of packets between two progress reports.
-    int       _nextReport;      //!< Next packet index to indicate progress report.
+    //!
+    //! The thread which reads and demuxes the file.
+    //!
+    class DemuxThread : public QThread
+    {
+    public:
+        //!
+        //! Constructor.
+        //! @param [in] demux The action which is run in this thread.
+        //!
+        DemuxThread(QtlMovieTsDemux* demux) :
+            QThread(),
+            _demux(demux)
+        {
+        }
+    protected:
+        //!
+        //! Thread main code.
+        //! Reimplemented from QThread.
+        //!
+        virtual void run() Q_DECL_OVERRIDE
+        {
+            _demux->demuxFile();
+        }
+    private:
+        QtlMovieTsDemux* _demux; //!< The action to run.
+    };
+
+    //!
+    //! Status of the demux thread.
+    //!
+    enum ThreadStatus {
+        Running,      //!< Still running or not started.
+        EndOfFile,    //!< Completed at end of file.
+        FileError,    //!< Completed on error while reading the file.
+        Terminated    //!< Interrupted by emitCompleted() or stopDemux().
+    };
+
+    QtsMappedTsFile    _file;            //!< TS file, mapped in memory.
+    QtsDemuxHub        _hub;             //!< Routes the packets when additional demuxes are used.
+    DemuxThread        _thread;          //!< Thread which reads and demuxes the file.
+    ThreadStatus       _threadStatus;    //!< Termination status of the demux thread.
+    bool               _threadSuccess;   //!< Success status when emitCompleted() was invoked in the demux thread.
+    QString            _threadMessage;   //!< Message when emitCompleted() was invoked in the demux thread.
+    QAtomicInt         _currentPackets;  //!< Number of demuxed packets, for progress reporting.
+    QAtomicInt         _progressPending; //!< A progress report is queued to the thread of this object.
+    QAtomicInt         _isM2ts;          //!< File has M2TS format (non-zero), set after the first packets are read.
+    int                _totalPackets;    //!< File size in packets.
+    int                _packetInterval;  //!< Min number of packets between two progress reports.
+    QtlMovieAction*    _teeAction;       //!< Action which receives a copy of the TS packets.
+    QtlThreadDataPull* _teePull;         //!< Data pull which feeds _teeAction.
+    bool               _demuxDone;       //!< The demux successfully completed, waiting for _teeAction.
+    QString            _demuxMessage;    //!< Completion message of the demux.
+
+    //!
+    //! Process the termination of the demux, in the thread of this object.
+    //! @param [in] success True when the demux completed successfully, false otherwise.
+    //! @param [in] message Optional error message to log.
+    //!
+    void demuxTerminated(bool success, const QString& message = QString());
+
+    //!
+    //! Read and demux the file, executed in the demux thread.
+    //!
+    void demuxFile();
 
     // Unaccessible operations.
     QtlMovieTsDemux() Q_DECL_EQ_DELETE;
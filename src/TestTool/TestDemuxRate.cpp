@@ -0,0 +1,247 @@
+//----------------------------------------------------------------------------
+//
+// Copyright (c) 2013-2017, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//
+// Command line tool to evaluate the demux performances on a synthetic mux.
+//
+//----------------------------------------------------------------------------
+
+#include "TestToolCommand.h"
+#include "QtsSectionDemux.h"
+#include "QtsPesDemux.h"
+#include "QtsPidContextTable.h"
+#include "QtsCrc32.h"
+
+class TestDemuxRate : public TestToolCommand, private QtsSectionHandlerInterface, private QtsPesHandlerInterface
+{
+    Q_OBJECT
+public:
+    TestDemuxRate() :
+        TestToolCommand("demuxrate",
+                        "[megabytes [pes-pid-count]]",
+                        "Evaluate the throughput of the section and PES demuxes on a synthetic\n"
+                        "full mux (default: 1024 MB, 64 PES PID's, one PAT every 20 packets).\n"
+                        "Also compare the per-packet PID context lookup in a map, as previously\n"
+                        "used by the demuxes, and in a flat table indexed by PID."),
+        _sectionCount(0),
+        _pesCount(0),
+        _cc(QTS_PID_MAX, 0)
+    {
+    }
+    virtual int run(const QStringList& args) Q_DECL_OVERRIDE;
+private:
+    qint64 _sectionCount;
+    qint64 _pesCount;
+    QVector<quint8> _cc;
+    void generate(QtsTsPacket* packets, int count, qint64 index, int pesPidCount);
+    void displayThroughput(const QString& name, qint64 packetCount, qint64 ns);
+    virtual void handleSection(QtsSectionDemux& demux, const QtsSection& section) Q_DECL_OVERRIDE;
+    virtual void handlePesPacket(QtsPesDemux& demux, const QtsPesPacket& packet) Q_DECL_OVERRIDE;
+};
+
+namespace {
+    // Number of packets per generated chunk.
+    const int CHUNK_PACKETS = 10000;
+    // Number of TS packets per PES packet.
+    const int PACKETS_PER_PES = 50;
+    // One PAT every N packets.
+    const int PAT_INTERVAL = 20;
+    // First PES PID.
+    const QtsPid FIRST_PES_PID = 0x0100;
+
+    // Context in the lookup test.
+    struct LookupContext
+    {
+        qint64 count;
+        LookupContext() : count(0) {}
+    };
+}
+
+//----------------------------------------------------------------------------
+
+int TestDemuxRate::run(const QStringList& args)
+{
+    if (args.size() > 2) {
+        return syntaxError();
+    }
+    const qint64 megabytes = args.size() < 1 ? 1024 : args[0].toLongLong();
+    const int pesPidCount = args.size() < 2 ? 64 : args[1].toInt();
+    if (megabytes <= 0 || pesPidCount <= 0 || FIRST_PES_PID + pesPidCount >= QTS_PID_NULL) {
+        return syntaxError();
+    }
+    const qint64 totalPackets = (megabytes * 1024 * 1024) / QTS_PKT_SIZE;
+    out << "Synthetic mux: " << totalPackets << " packets, " << pesPidCount << " PES PID's" << endl;
+
+    QtsSectionDemux sectionDemux(0, this, QtsAllPids);
+    QtsPesDemux pesDemux(this, QtsAllPids);
+
+    // Two PES PID's only, typical of a subtitle extraction in a full mux.
+    QtsPidSet twoPids;
+    twoPids.set(FIRST_PES_PID);
+    twoPids.set(FIRST_PES_PID + 1);
+    QtsPesDemux filteredDemux(this, twoPids);
+    QtsPesDemux batchDemux(this, twoPids);
+    QMap<QtsPid,LookupContext> lookupMap;
+    QtsPidContextTable<LookupContext> lookupTable;
+
+    QVector<QtsTsPacket> chunk(CHUNK_PACKETS);
+    qint64 sectionNs = 0;
+    qint64 pesNs = 0;
+    qint64 filteredNs = 0;
+    qint64 batchNs = 0;
+    qint64 mapNs = 0;
+    qint64 tableNs = 0;
+    QElapsedTimer timer;
+
+    for (qint64 index = 0; index < totalPackets; index += CHUNK_PACKETS) {
+        const int count = int(qMin<qint64>(CHUNK_PACKETS, totalPackets - index));
+        generate(chunk.data(), count, index, pesPidCount);
+
+        timer.start();
+        for (int i = 0; i < count; ++i) {
+            lookupMap[chunk[i].getPid()].count++;
+        }
+        mapNs += timer.nsecsElapsed();
+
+        timer.start();
+        for (int i = 0; i < count; ++i) {
+            lookupTable[chunk[i].getPid()].count++;
+        }
+        tableNs += timer.nsecsElapsed();
+
+        timer.start();
+        for (int i = 0; i < count; ++i) {
+            sectionDemux.feedPacket(chunk[i]);
+        }
+        sectionNs += timer.nsecsElapsed();
+
+        timer.start();
+        for (int i = 0; i < count; ++i) {
+            pesDemux.feedPacket(chunk[i]);
+        }
+        pesNs += timer.nsecsElapsed();
+
+        timer.start();
+        for (int i = 0; i < count; ++i) {
+            filteredDemux.feedPacket(chunk[i]);
+        }
+        filteredNs += timer.nsecsElapsed();
+
+        timer.start();
+        batchDemux.feedPackets(chunk.constData(), count);
+        batchNs += timer.nsecsElapsed();
+    }
+
+    displayThroughput("PID lookup in map", totalPackets, mapNs);
+    displayThroughput("PID lookup in table", totalPackets, tableNs);
+    displayThroughput("Section demux", totalPackets, sectionNs);
+    displayThroughput("PES demux", totalPackets, pesNs);
+    displayThroughput("PES demux, 2 PID's", totalPackets, filteredNs);
+    displayThroughput("PES demux, 2 PID's, batch", totalPackets, batchNs);
+    out << _sectionCount << " sections, " << _pesCount << " PES packets" << endl;
+    return EXIT_SUCCESS;
+}
+
+//----------------------------------------------------------------------------
+// Generate a chunk of the synthetic mux.
+//----------------------------------------------------------------------------
+
+void TestDemuxRate::generate(QtsTsPacket* packets, int count, qint64 index, int pesPidCount)
+{
+    for (int i = 0; i < count; ++i, ++index) {
+        QtsTsPacket& pkt(packets[i]);
+        pkt = QtsNullPacket;
+        quint8* const pl = pkt.b + 4;
+
+        if (index % PAT_INTERVAL == 0) {
+            // One PAT section with one service: 0x0001 -> PMT PID 0x1000.
+            pkt.setPid(QTS_PID_PAT);
+            pkt.setPusi();
+            pl[0] = 0;                // pointer field
+            pl[1] = QTS_TID_PAT;
+            pl[2] = 0xB0;             // long section, section length = 13
+            pl[3] = 13;
+            pl[4] = 0x00; pl[5] = 0x01; // transport stream id
+            pl[6] = 0xC1;             // version 0, current
+            pl[7] = 0;                // section number
+            pl[8] = 0;                // last section number
+            pl[9] = 0x00; pl[10] = 0x01; // service id
+            pl[11] = 0xF0; pl[12] = 0x00; // PMT PID
+            qToBigEndian<quint32>(QtsCrc32(pl + 1, 12).value(), pl + 13);
+        }
+        else {
+            // Round-robin on PES PID's.
+            const qint64 pesIndex = index - index / PAT_INTERVAL - 1;
+            const QtsPid pid = FIRST_PES_PID + QtsPid(pesIndex % pesPidCount);
+            pkt.setPid(pid);
+            if ((pesIndex / pesPidCount) % PACKETS_PER_PES == 0) {
+                // Start of an unbounded video PES packet.
+                pkt.setPusi();
+                pl[0] = 0x00; pl[1] = 0x00; pl[2] = 0x01; pl[3] = 0xE0;
+                pl[4] = 0x00; pl[5] = 0x00; pl[6] = 0x80; pl[7] = 0x00; pl[8] = 0x00;
+            }
+        }
+        pkt.setCc(_cc[pkt.getPid()]);
+        _cc[pkt.getPid()] = (_cc[pkt.getPid()] + 1) % QTS_CC_MAX;
+    }
+}
+
+//----------------------------------------------------------------------------
+// Demux handlers.
+//----------------------------------------------------------------------------
+
+void TestDemuxRate::handleSection(QtsSectionDemux& demux, const QtsSection& section)
+{
+    Q_UNUSED(demux);
+    Q_UNUSED(section);
+    _sectionCount++;
+}
+
+void TestDemuxRate::handlePesPacket(QtsPesDemux& demux, const QtsPesPacket& packet)
+{
+    Q_UNUSED(demux);
+    Q_UNUSED(packet);
+    _pesCount++;
+}
+
+//----------------------------------------------------------------------------
+
+void TestDemuxRate::displayThroughput(const QString& name, qint64 packetCount, qint64 ns)
+{
+    const qint64 ms = ns / 1000000;
+    out << name << ": " << packetCount << " packets in " << ms << " ms";
+    if (ms > 0) {
+        out << ", " << ((packetCount * 1000) / ms) << " packets/s, "
+            << ((packetCount * QTS_PKT_SIZE) / (ms * 1000)) << " MB/s";
+    }
+    out << endl;
+}
+
+//----------------------------------------------------------------------------
+
+#include "TestDemuxRate.moc"
+namespace {TestDemuxRate thisTest;}
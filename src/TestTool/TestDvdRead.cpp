@@ -33,12 +33,18 @@
 #include "TestToolCommand.h"
 #include "QtsDvdMedia.h"
 #include "QtsDvdBandwidthReport.h"
+#include "QtsDvdReadAhead.h"
 
 class TestDvdRead : public TestToolCommand
 {
     Q_OBJECT
 public:
-    TestDvdRead() : TestToolCommand("dvdread", "device-name", "Evaluate transfer bandwidth from a DVD using libdvdcss.") {}
+    TestDvdRead() : TestToolCommand("dvdread",
+                                    "device-name [-readahead] [-delay ms]",
+                                    "Evaluate transfer bandwidth from a DVD using libdvdcss.\n"
+                                    "With -readahead, the DVD is read in advance in a separate thread.\n"
+                                    "With -delay, simulate a processing time of the specified\n"
+                                    "number of milliseconds after reading each chunk of sectors.") {}
     virtual int run(const QStringList& args) Q_DECL_OVERRIDE;
 private:
     void displayBandwidth(const QTime& timeAverage, const QTime& timeInstant, int sectorCount, int instantSectorCount);
@@ -48,11 +54,26 @@ private:
 
 int TestDvdRead::run(const QStringList& args)
 {
-    if (args.size() != 1) {
+    if (args.isEmpty()) {
         return syntaxError();
     }
     const QString deviceName(args[0]);
 
+    // Parse options.
+    bool readAhead = false;
+    int delay = 0;
+    for (int i = 1; i < args.size(); ++i) {
+        if (args[i] == "-readahead") {
+            readAhead = true;
+        }
+        else if (args[i] == "-delay" && i + 1 < args.size()) {
+            delay = args[++i].toInt();
+        }
+        else {
+            return syntaxError();
+        }
+    }
+
     // Open libdvdcss
     QtsDvdMedia dvd(QString(), &log);
     if (!dvd.openFromDevice(deviceName, true)) {
@@ -69,28 +90,45 @@ int TestDvdRead::run(const QStringList& args)
         return EXIT_FAILURE;
     }
 
+    // Read the complete DVD, possibly in advance in a separate thread.
+    const int sectorsPerRead = 256;
+    QtsDvdReadAhead reader(sectorsPerRead * QTS_DVD_SECTOR_SIZE, QTS_DVD_READ_AHEAD_CHUNKS, &log);
+    if (readAhead && !reader.start(&dvd, QtlRangeList(QtlRange(0, dvd.volumeSizeInSectors() - 1)))) {
+        out << "error starting read-ahead thread" << endl;
+        return EXIT_FAILURE;
+    }
+
     // Measure transfer bandwidth, both globally and instantly.
     QTime timeAverage;
     QTime timeInstant;
     timeAverage.start();
     timeInstant.start();
 
-    const int sectorsPerRead = 256;
     const int reportInterval = 50000;
 
-    char buffer[sectorsPerRead * QTS_DVD_SECTOR_SIZE];
+    QtlByteBlock buffer(sectorsPerRead * QTS_DVD_SECTOR_SIZE);
     int nextReport = reportInterval;
     int currentSector = 0;
     int lastInstantSector = 0;
     int count = 0;
 
     do {
-        count = dvd.readSectors(buffer, sectorsPerRead);
+        int requested = sectorsPerRead;
+        if (readAhead) {
+            count = reader.readChunk(buffer, requested);
+        }
+        else {
+            count = dvd.readSectors(buffer.data(), sectorsPerRead);
+        }
         if (count > 0) {
             currentSector += count;
         }
-        if (count != sectorsPerRead) {
-            out << "Requested " << sectorsPerRead << " sectors, got " << count << ", current sector: " << currentSector << endl;
+        if (count != requested) {
+            out << "Requested " << requested << " sectors, got " << count << ", current sector: " << currentSector << endl;
+        }
+        if (count > 0 && delay > 0) {
+            // Simulate the processing of the data.
+            QThread::msleep(delay);
         }
         if (currentSector >= nextReport) {
             displayBandwidth(timeAverage, timeInstant, currentSector, currentSector - lastInstantSector);
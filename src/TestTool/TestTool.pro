@@ -52,6 +52,8 @@ SOURCES += \
     TestPgcDemux.cpp \
     TestIfoDump.cpp \
     TestDvd.cpp \
+    TestTsRead.cpp \
+    TestDemuxRate.cpp \
     TestHelp.cpp
 
 HEADERS += \
@@ -0,0 +1,223 @@
+//----------------------------------------------------------------------------
+//
+// Copyright (c) 2013-2017, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//
+// Command line tool to evaluate the TS file read performances.
+//
+//----------------------------------------------------------------------------
+
+#include "TestToolCommand.h"
+#include "QtsTsFile.h"
+#include "QtsMappedTsFile.h"
+#include "QtlByteBlock.h"
+
+class TestTsRead : public TestToolCommand
+{
+    Q_OBJECT
+public:
+    TestTsRead() :
+        TestToolCommand("tsread",
+                        "input-file [packets-per-read]",
+                        "Evaluate the read throughput of a TS or M2TS file.\n"
+                        "Compare the bulk read of QtsTsFile and the memory mapping of\n"
+                        "QtsMappedTsFile with the former method which copied and removed\n"
+                        "each packet from an intermediate buffer.\n"
+                        "The file is read once before the measurements to load the system cache."),
+        _syncErrors(0)
+    {
+    }
+    virtual int run(const QStringList& args) Q_DECL_OVERRIDE;
+private:
+    qint64 _syncErrors;
+    qint64 readBulk(const QString& fileName, int packetsPerRead);
+    qint64 readMapped(const QString& fileName, int packetsPerRead);
+    qint64 readLegacy(const QString& fileName, int packetsPerRead, bool m2ts);
+    void displayThroughput(const QString& name, qint64 packetCount, int ms);
+};
+
+//----------------------------------------------------------------------------
+
+int TestTsRead::run(const QStringList& args)
+{
+    if (args.size() < 1 || args.size() > 2) {
+        return syntaxError();
+    }
+    const QString fileName(args[0]);
+    const int packetsPerRead = args.size() < 2 ? 1000 : args[1].toInt();
+    if (packetsPerRead <= 0) {
+        return syntaxError();
+    }
+
+    // Initial read to determine the file format and load the system cache.
+    QtsTsFile file(fileName);
+    if (!file.open()) {
+        err << "**** Error opening " << fileName << endl;
+        return EXIT_FAILURE;
+    }
+    QVector<QtsTsPacket> buffer(packetsPerRead);
+    qint64 packetCount = 0;
+    int count = 0;
+    while ((count = file.read(buffer.data(), packetsPerRead)) > 0) {
+        packetCount += count;
+    }
+    const bool m2ts = file.tsFileType() == QtsTsFile::M2tsFile;
+    file.close();
+
+    if (packetCount == 0) {
+        err << "**** No TS packet found in " << fileName << endl;
+        return EXIT_FAILURE;
+    }
+    out << "File format: " << (m2ts ? "M2TS" : "TS") << ", " << packetCount << " packets, " << packetsPerRead << " packets per read" << endl;
+
+    // Measure the throughput of each method.
+    QTime timer;
+    timer.start();
+    const qint64 legacyCount = readLegacy(fileName, packetsPerRead, m2ts);
+    displayThroughput("Legacy read", legacyCount, timer.elapsed());
+
+    timer.start();
+    const qint64 bulkCount = readBulk(fileName, packetsPerRead);
+    displayThroughput("Bulk read", bulkCount, timer.elapsed());
+
+    timer.start();
+    const qint64 mappedCount = readMapped(fileName, packetsPerRead);
+    displayThroughput("Mapped read", mappedCount, timer.elapsed());
+    if (_syncErrors > 0) {
+        out << _syncErrors << " packets with invalid sync byte" << endl;
+    }
+
+    if (legacyCount != packetCount || bulkCount != packetCount || mappedCount != packetCount) {
+        err << "**** Inconsistent packet counts" << endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
+
+//----------------------------------------------------------------------------
+// Read the file using QtsTsFile.
+//----------------------------------------------------------------------------
+
+qint64 TestTsRead::readBulk(const QString& fileName, int packetsPerRead)
+{
+    QtsTsFile file(fileName);
+    if (!file.open()) {
+        return 0;
+    }
+
+    QVector<QtsTsPacket> buffer(packetsPerRead);
+    qint64 packetCount = 0;
+    int count = 0;
+    while ((count = file.read(buffer.data(), packetsPerRead)) > 0) {
+        packetCount += count;
+    }
+    return packetCount;
+}
+
+//----------------------------------------------------------------------------
+// Read the file using QtsMappedTsFile. Access each packet to make sure
+// that mapped pages are actually loaded.
+//----------------------------------------------------------------------------
+
+qint64 TestTsRead::readMapped(const QString& fileName, int packetsPerRead)
+{
+    QtsMappedTsFile file(fileName);
+    if (!file.open()) {
+        return 0;
+    }
+
+    const QtsTsPacket* packets = 0;
+    qint64 packetCount = 0;
+    int count = 0;
+    _syncErrors = 0;
+    while ((count = file.mapPackets(packets, packetsPerRead)) > 0) {
+        for (int i = 0; i < count; ++i) {
+            if (!packets[i].hasValidSync()) {
+                _syncErrors++;
+            }
+        }
+        packetCount += count;
+    }
+    return packetCount;
+}
+
+//----------------------------------------------------------------------------
+// Read the file using the former method of QtsTsFile: each packet is
+// copied from an intermediate buffer and removed from its front.
+//----------------------------------------------------------------------------
+
+qint64 TestTsRead::readLegacy(const QString& fileName, int packetsPerRead, bool m2ts)
+{
+    QFile file(fileName);
+    if (!file.open(QFile::ReadOnly)) {
+        return 0;
+    }
+
+    const int headerSize = m2ts ? QTS_M2TS_HEADER_SIZE : 0;
+    const int packetSize = headerSize + QTS_PKT_SIZE;
+    QVector<QtsTsPacket> buffer(packetsPerRead);
+    QtlByteBlock inBuffer;
+    qint64 packetCount = 0;
+    bool eof = false;
+
+    while (!eof) {
+        int count = 0;
+        while (count < packetsPerRead) {
+            // Make sure at least one packet is in the buffer.
+            if (inBuffer.size() < packetSize) {
+                const int initialSize = inBuffer.size();
+                inBuffer.resize(packetSize);
+                const qint64 received = file.read(reinterpret_cast<char*>(inBuffer.data()) + initialSize, packetSize - initialSize);
+                inBuffer.resize(initialSize + int(qMax(Q_INT64_C(0), received)));
+            }
+            if (inBuffer.size() < packetSize) {
+                eof = true;
+                break;
+            }
+            ::memcpy(&buffer[count++], inBuffer.data() + headerSize, QTS_PKT_SIZE);
+            inBuffer.remove(0, packetSize);
+        }
+        packetCount += count;
+    }
+    return packetCount;
+}
+
+//----------------------------------------------------------------------------
+
+void TestTsRead::displayThroughput(const QString& name, qint64 packetCount, int ms)
+{
+    out << name << ": " << packetCount << " packets in " << ms << " ms";
+    if (ms > 0) {
+        out << ", " << ((packetCount * 1000) / ms) << " packets/s, "
+            << ((packetCount * QTS_PKT_SIZE) / (ms * 1000)) << " MB/s";
+    }
+    out << endl;
+}
+
+//----------------------------------------------------------------------------
+
+#include "TestTsRead.moc"
+namespace {TestTsRead thisTest;}
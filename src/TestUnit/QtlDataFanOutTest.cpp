@@ -0,0 +1,233 @@
+//----------------------------------------------------------------------------
+//
+// Copyright (c) 2013-2017, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//
+// Unit test for classes QtlDataFanOut and QtlFanOutDataPull
+//
+//----------------------------------------------------------------------------
+
+#include "QtlTest.h"
+#include "QtlDataFanOut.h"
+#include "QtlFanOutDataPull.h"
+
+class QtlDataFanOutTest : public QObject
+{
+    Q_OBJECT
+private slots:
+    void testAllConsumers();
+    void testDetach();
+    void testDropOnLag();
+};
+
+#include "QtlDataFanOutTest.moc"
+QTL_TEST_CLASS(QtlDataFanOutTest);
+
+//
+// A source which generates a predictable sequence of bytes.
+//
+namespace {
+    class PatternDataPull : public QtlDataPull
+    {
+    public:
+        PatternDataPull(qint64 totalSize, QObject* parent = 0) :
+            QtlDataPull(DEFAULT_MIN_BUFFER_SIZE, 0, parent),
+            _totalSize(totalSize),
+            _current(0)
+        {
+        }
+        static QByteArray expected(qint64 size)
+        {
+            QByteArray data(int(size), 0);
+            for (int i = 0; i < data.size(); ++i) {
+                data[i] = char(i % 251);
+            }
+            return data;
+        }
+    protected:
+        virtual bool needTransfer(qint64 maxSize) Q_DECL_OVERRIDE
+        {
+            qint64 size = qMin<qint64>(10000, _totalSize - _current);
+            if (maxSize >= 0) {
+                size = qMin(size, maxSize);
+            }
+            if (size <= 0) {
+                close();
+                return true;
+            }
+            QByteArray data(int(size), 0);
+            for (int i = 0; i < data.size(); ++i) {
+                data[i] = char((_current + i) % 251);
+            }
+            _current += size;
+            return write(data.constData(), data.size());
+        }
+    private:
+        qint64 _totalSize;
+        qint64 _current;
+    };
+
+    //
+    // A device which accepts all data but never reports them as written.
+    // A data pull into this device stops after its minimum buffer size.
+    //
+    class StalledDevice : public QIODevice
+    {
+    public:
+        StalledDevice(QObject* parent = 0) :
+            QIODevice(parent)
+        {
+        }
+        virtual bool isSequential() const Q_DECL_OVERRIDE
+        {
+            return true;
+        }
+    protected:
+        virtual qint64 readData(char* data, qint64 maxSize) Q_DECL_OVERRIDE
+        {
+            Q_UNUSED(data);
+            Q_UNUSED(maxSize);
+            return -1;
+        }
+        virtual qint64 writeData(const char* data, qint64 maxSize) Q_DECL_OVERRIDE
+        {
+            Q_UNUSED(data);
+            return maxSize;
+        }
+    };
+}
+
+void QtlDataFanOutTest::testAllConsumers()
+{
+    const qint64 size = 1000000;
+    PatternDataPull source(size);
+    QtlDataFanOut fanOut;
+
+    QBuffer buffer1;
+    QBuffer buffer2;
+    QVERIFY(buffer1.open(QIODevice::WriteOnly));
+    QVERIFY(buffer2.open(QIODevice::WriteOnly));
+
+    QtlFanOutDataPull pull1(&fanOut);
+    QtlFanOutDataPull pull2(&fanOut);
+    QCOMPARE(fanOut.consumerCount(), 2);
+
+    QSignalSpy spy1(&pull1, &QtlDataPull::completed);
+    QSignalSpy spy2(&pull2, &QtlDataPull::completed);
+    QSignalSpy spyFinished(&fanOut, &QtlDataFanOut::finished);
+
+    QVERIFY(pull1.start(&buffer1));
+    QVERIFY(pull2.start(&buffer2));
+    QVERIFY(fanOut.start(&source));
+
+    QTRY_COMPARE(spy1.count(), 1);
+    QTRY_COMPARE(spy2.count(), 1);
+    QCOMPARE(spy1.first().first().toBool(), true);
+    QCOMPARE(spy2.first().first().toBool(), true);
+    QTRY_COMPARE(spyFinished.count(), 1);
+
+    QCOMPARE(fanOut.totalSize(), size);
+    QCOMPARE(fanOut.retainedSize(), Q_INT64_C(0));
+    QCOMPARE(fanOut.consumerCount(), 0);
+    QCOMPARE(pull1.pulledSize(), size);
+    QCOMPARE(pull2.pulledSize(), size);
+    QVERIFY(buffer1.data() == PatternDataPull::expected(size));
+    QVERIFY(buffer2.data() == PatternDataPull::expected(size));
+}
+
+void QtlDataFanOutTest::testDetach()
+{
+    const qint64 size = 1000000;
+    PatternDataPull source(size);
+    QtlDataFanOut fanOut;
+
+    QBuffer buffer1;
+    QBuffer buffer2;
+    QVERIFY(buffer1.open(QIODevice::WriteOnly));
+    QVERIFY(buffer2.open(QIODevice::WriteOnly));
+
+    QtlFanOutDataPull pull1(&fanOut);
+    QtlFanOutDataPull pull2(&fanOut);
+
+    QSignalSpy spy1(&pull1, &QtlDataPull::completed);
+    QSignalSpy spy2(&pull2, &QtlDataPull::completed);
+
+    QVERIFY(pull1.start(&buffer1));
+    QVERIFY(pull2.start(&buffer2));
+
+    // The second consumer terminates early, the first one receives everything.
+    pull2.stop();
+    QTRY_COMPARE(spy2.count(), 1);
+    QCOMPARE(spy2.first().first().toBool(), false);
+    QCOMPARE(fanOut.consumerCount(), 1);
+
+    QVERIFY(fanOut.start(&source));
+    QTRY_COMPARE(spy1.count(), 1);
+    QCOMPARE(spy1.first().first().toBool(), true);
+    QVERIFY(buffer1.data() == PatternDataPull::expected(size));
+}
+
+void QtlDataFanOutTest::testDropOnLag()
+{
+    const qint64 size = 1000000;
+    const qint64 maxLag = 64 * 1024;
+    PatternDataPull source(size);
+    QtlDataFanOut fanOut(maxLag);
+
+    QBuffer buffer1;
+    StalledDevice stalled;
+    QVERIFY(buffer1.open(QIODevice::WriteOnly));
+    QVERIFY(stalled.open(QIODevice::WriteOnly));
+
+    // The second consumer stops pulling data after a few kB and lags on purpose.
+    QtlFanOutDataPull pull1(&fanOut, QtlDataFanOut::BlockOnLag);
+    QtlFanOutDataPull pull2(&fanOut, QtlDataFanOut::DropOnLag, 4096);
+
+    QSignalSpy spy1(&pull1, &QtlDataPull::completed);
+    QSignalSpy spy2(&pull2, &QtlDataPull::completed);
+    QSignalSpy spyFinished(&fanOut, &QtlDataFanOut::finished);
+
+    QVERIFY(pull1.start(&buffer1));
+    QVERIFY(pull2.start(&stalled));
+    QVERIFY(fanOut.start(&source));
+
+    // The lagging consumer is dropped, it does not block the source.
+    QTRY_COMPARE(spy2.count(), 1);
+    QCOMPARE(spy2.first().first().toBool(), false);
+    QVERIFY(pull2.isDropped());
+    QVERIFY(pull2.pulledSize() < size);
+
+    // The other consumer receives all data.
+    QTRY_COMPARE(spy1.count(), 1);
+    QCOMPARE(spy1.first().first().toBool(), true);
+    QVERIFY(!pull1.isDropped());
+    QCOMPARE(pull1.pulledSize(), size);
+    QVERIFY(buffer1.data() == PatternDataPull::expected(size));
+
+    QTRY_COMPARE(spyFinished.count(), 1);
+    QCOMPARE(fanOut.retainedSize(), Q_INT64_C(0));
+    QCOMPARE(fanOut.consumerCount(), 0);
+}
@@ -0,0 +1,127 @@
+//----------------------------------------------------------------------------
+//
+// Copyright (c) 2013-2017, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//
+// Unit test for class QtlMediaStreamInfo
+//
+//----------------------------------------------------------------------------
+
+#include "QtlTest.h"
+#include "QtlMediaStreamInfo.h"
+
+class QtlMediaStreamInfoTest : public QObject
+{
+    Q_OBJECT
+private slots:
+    void testSerialize();
+    void testDeserializeTruncated();
+};
+
+#include "QtlMediaStreamInfoTest.moc"
+QTL_TEST_CLASS(QtlMediaStreamInfoTest);
+
+namespace {
+    QtlMediaStreamInfoList sampleStreams()
+    {
+        QtlMediaStreamInfoList streams;
+
+        QtlMediaStreamInfoPtr video(new QtlMediaStreamInfo());
+        video->setStreamType(QtlMediaStreamInfo::Video);
+        video->setFFIndex(0);
+        video->setStreamId(0x100);
+        video->setCodecName("h264");
+        video->setWidth(1920);
+        video->setHeight(1080);
+        video->setDisplayAspectRatio(QTL_DAR_16_9);
+        video->setFrameRate(25.0);
+        streams << video;
+
+        QtlMediaStreamInfoPtr teletext(new QtlMediaStreamInfo());
+        teletext->setStreamType(QtlMediaStreamInfo::Subtitle);
+        teletext->setSubtitleType(QtlMediaStreamInfo::SubTeletext);
+        teletext->setFFIndex(2);
+        teletext->setStreamId(0x102);
+        teletext->setLanguage("fre");
+        teletext->setTeletextPage(888);
+        streams << teletext;
+
+        QtlMediaStreamInfoPtr cc(new QtlMediaStreamInfo());
+        cc->setStreamType(QtlMediaStreamInfo::Subtitle);
+        cc->setSubtitleType(QtlMediaStreamInfo::SubCc);
+        cc->setCcNumber(3);
+        streams << cc;
+
+        return streams;
+    }
+}
+
+void QtlMediaStreamInfoTest::testSerialize()
+{
+    const QtlMediaStreamInfoList ref(sampleStreams());
+
+    QByteArray data;
+    QDataStream out(&data, QIODevice::WriteOnly);
+    QtlMediaStreamInfo::serialize(out, ref);
+    QCOMPARE(out.status(), QDataStream::Ok);
+
+    QtlMediaStreamInfoList streams;
+    QDataStream in(data);
+    QVERIFY(QtlMediaStreamInfo::deserialize(in, streams));
+    QVERIFY(in.atEnd());
+    QCOMPARE(streams.size(), 3);
+
+    QCOMPARE(streams[0]->streamType(), QtlMediaStreamInfo::Video);
+    QCOMPARE(streams[0]->ffIndex(), 0);
+    QCOMPARE(streams[0]->streamId(), 0x100);
+    QCOMPARE(streams[0]->codecName(), QString("h264"));
+    QCOMPARE(streams[0]->width(), 1920);
+    QCOMPARE(streams[0]->height(), 1080);
+    QCOMPARE(streams[0]->displayAspectRatio(), ref[0]->displayAspectRatio());
+    QCOMPARE(streams[0]->frameRate(), ref[0]->frameRate());
+
+    QCOMPARE(streams[1]->streamType(), QtlMediaStreamInfo::Subtitle);
+    QCOMPARE(streams[1]->subtitleType(), QtlMediaStreamInfo::SubTeletext);
+    QCOMPARE(streams[1]->streamId(), 0x102);
+    QCOMPARE(streams[1]->language(), QString("fre"));
+    QCOMPARE(streams[1]->teletextPage(), 888);
+
+    QCOMPARE(streams[2]->subtitleType(), QtlMediaStreamInfo::SubCc);
+    QCOMPARE(streams[2]->ccNumber(), 3);
+}
+
+void QtlMediaStreamInfoTest::testDeserializeTruncated()
+{
+    QByteArray data;
+    QDataStream out(&data, QIODevice::WriteOnly);
+    QtlMediaStreamInfo::serialize(out, sampleStreams());
+
+    data.chop(10);
+    QtlMediaStreamInfoList streams;
+    QDataStream in(data);
+    QVERIFY(!QtlMediaStreamInfo::deserialize(in, streams));
+    QVERIFY(streams.isEmpty());
+}
@@ -41,6 +41,9 @@ private slots:
     void testDowncast();
     void testUpcast();
     void testChangeMutex();
+    void testAtomicLocker();
+    void benchmarkMutexContention();
+    void benchmarkAtomicContention();
 };
 
 #include "QtlSmartPointerTest.moc"
@@ -348,3 +351,90 @@ void QtlSmartPointerTest::testChangeMutex()
     pt.clear();
     QVERIFY(TestData::instanceCount() == 0);
 }
+
+// Test case: check atomic reference counting
+void QtlSmartPointerTest::testAtomicLocker()
+{
+    QVERIFY(TestData::instanceCount() == 0);
+    QtlSmartPointer<TestData,QtlAtomicLocker> p1(new TestData(999));
+    QVERIFY(TestData::instanceCount() == 1);
+    QVERIFY(p1.count() == 1);
+
+    QtlSmartPointer<TestData,QtlAtomicLocker> p2(p1);
+    QVERIFY(p1.count() == 2);
+    QVERIFY(p2->value() == 999);
+
+    p1.clear();
+    QVERIFY(p2.count() == 1);
+    QVERIFY(TestData::instanceCount() == 1);
+
+    QtlSmartPointer<TestData,QtlMutexLocker> pm(p2.changeMutex<QtlMutexLocker>());
+    QVERIFY(p2.isNull() == true);
+    QVERIFY(pm->value() == 999);
+
+    pm.clear();
+    QVERIFY(TestData::instanceCount() == 0);
+}
+
+//----------------------------------------------------------------------------
+
+// Copy and destroy smart pointers to the same object from several threads.
+namespace {
+    const int CONTENTION_THREADS = 4;
+    const int CONTENTION_COPIES = 100000;
+
+    template <class PTR>
+    class ContentionThread : public QThread
+    {
+    private:
+        const PTR& _ptr;
+    public:
+        ContentionThread(const PTR& ptr) : _ptr(ptr) {}
+    protected:
+        virtual void run() Q_DECL_OVERRIDE
+        {
+            for (int i = 0; i < CONTENTION_COPIES; ++i) {
+                PTR copy(_ptr);
+            }
+        }
+    };
+
+    template <class PTR>
+    bool contention(const PTR& ptr)
+    {
+        QList<QThread*> threads;
+        for (int i = 0; i < CONTENTION_THREADS; ++i) {
+            threads << new ContentionThread<PTR>(ptr);
+        }
+        foreach (QThread* thread, threads) {
+            thread->start();
+        }
+        foreach (QThread* thread, threads) {
+            thread->wait();
+            delete thread;
+        }
+        return ptr.count() == 1;
+    }
+}
+
+// Micro-benchmark of concurrent copies with a mutex-protected reference counter.
+void QtlSmartPointerTest::benchmarkMutexContention()
+{
+    const QtlSmartPointer<TestData,QtlMutexLocker> ptr(new TestData(1));
+    bool success = true;
+    QBENCHMARK {
+        success = contention(ptr) && success;
+    }
+    QVERIFY(success);
+}
+
+// Micro-benchmark of concurrent copies with an atomic reference counter.
+void QtlSmartPointerTest::benchmarkAtomicContention()
+{
+    const QtlSmartPointer<TestData,QtlAtomicLocker> ptr(new TestData(1));
+    bool success = true;
+    QBENCHMARK {
+        success = contention(ptr) && success;
+    }
+    QVERIFY(success);
+}
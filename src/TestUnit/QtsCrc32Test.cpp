@@ -0,0 +1,160 @@
+//----------------------------------------------------------------------------
+//
+// Copyright (c) 2013-2017, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//
+// Unit test for class QtsCrc32
+//
+//----------------------------------------------------------------------------
+
+#include "QtlTest.h"
+#include "QtsCrc32.h"
+#include "QtsData.h"
+
+class QtsCrc32Test : public QObject
+{
+    Q_OBJECT
+private slots:
+    void initTestCase();
+    void testReference();
+    void testIncremental();
+    void testSections();
+    void testSections_data();
+    void benchmarkReference();
+    void benchmarkCrc32();
+private:
+    QVector<quint8> _data;
+    quint32         _result;
+};
+
+#include "QtsCrc32Test.moc"
+QTL_TEST_CLASS(QtsCrc32Test);
+
+//----------------------------------------------------------------------------
+
+namespace {
+    // Reference implementation: bit-oriented, no table, slow but obviously correct.
+    quint32 referenceCrc32(const quint8* data, int size)
+    {
+        quint32 fcs = 0xFFFFFFFF;
+        while (size-- > 0) {
+            fcs ^= quint32(*data++) << 24;
+            for (int bit = 0; bit < 8; ++bit) {
+                fcs = (fcs & 0x80000000) != 0 ? (fcs << 1) ^ 0x04C11DB7 : fcs << 1;
+            }
+        }
+        return fcs;
+    }
+}
+
+// Build pseudo-random test data, always the same.
+void QtsCrc32Test::initTestCase()
+{
+    _data.resize(4096 + 8);
+    quint32 seed = 0x12345678;
+    for (int i = 0; i < _data.size(); ++i) {
+        seed = seed * 1103515245 + 12345;
+        _data[i] = quint8(seed >> 16);
+    }
+}
+
+// Compare with the reference implementation, all sizes and alignments.
+void QtsCrc32Test::testReference()
+{
+    for (int offset = 0; offset < 8; ++offset) {
+        for (int size = 0; size <= 1024; ++size) {
+            const quint8* data = _data.constData() + offset;
+            QCOMPARE(QtsCrc32(data, size).value(), referenceCrc32(data, size));
+        }
+    }
+    QCOMPARE(QtsCrc32(_data.constData(), 4096).value(), referenceCrc32(_data.constData(), 4096));
+}
+
+// Computing in several steps shall give the same result as in one step.
+void QtsCrc32Test::testIncremental()
+{
+    const quint8* data = _data.constData();
+    const quint32 expected = referenceCrc32(data, 1000);
+    for (int split = 0; split <= 1000; split += 7) {
+        QtsCrc32 crc;
+        crc.add(data, split);
+        crc.add(data + split, 1000 - split);
+        QCOMPARE(crc.value(), expected);
+    }
+}
+
+// The CRC32 of a complete MPEG section, including its CRC32 field, is zero.
+void QtsCrc32Test::testSections()
+{
+    QFETCH(ConstBytePtr, sectionsAddress);
+    QFETCH(int, sectionsSize);
+
+    int count = 0;
+    while (sectionsSize >= 3) {
+        const int size = 3 + (qFromBigEndian<quint16>(sectionsAddress + 1) & 0x0FFF);
+        QVERIFY(size <= sectionsSize);
+        QCOMPARE(QtsCrc32(sectionsAddress, size).value(), quint32(0));
+        QVERIFY(QtsCrc32(sectionsAddress, size - 4) == qFromBigEndian<quint32>(sectionsAddress + size - 4));
+        sectionsAddress += size;
+        sectionsSize -= size;
+        count++;
+    }
+    QVERIFY(count > 0);
+    QCOMPARE(sectionsSize, 0);
+}
+
+// Data-sets for testSections(). Only long sections have a CRC32.
+void QtsCrc32Test::testSections_data()
+{
+    QTest::addColumn<ConstBytePtr>("sectionsAddress");
+    QTest::addColumn<int>("sectionsSize");
+
+    QTest::newRow("pat_r4") << ConstBytePtr(psi_pat_r4_sections) << psi_pat_r4_sections_size;
+    QTest::newRow("pmt_planete") << ConstBytePtr(psi_pmt_planete_sections) << psi_pmt_planete_sections_size;
+    QTest::newRow("bat_tvnum") << ConstBytePtr(psi_bat_tvnum_sections) << psi_bat_tvnum_sections_size;
+    QTest::newRow("nit_tntv23") << ConstBytePtr(psi_nit_tntv23_sections) << psi_nit_tntv23_sections_size;
+    QTest::newRow("sdt_r6") << ConstBytePtr(psi_sdt_r6_sections) << psi_sdt_r6_sections_size;
+}
+
+// Micro-benchmark of the reference implementation on a 4 kB data area (max section size).
+void QtsCrc32Test::benchmarkReference()
+{
+    // Accumulate results in a member to make sure the computation is not optimized away.
+    _result = 0;
+    QBENCHMARK {
+        _result ^= referenceCrc32(_data.constData(), 4096);
+    }
+}
+
+// Micro-benchmark of QtsCrc32 on a 4 kB data area (max section size).
+void QtsCrc32Test::benchmarkCrc32()
+{
+    // Accumulate results in a member to make sure the computation is not optimized away.
+    _result = 0;
+    QBENCHMARK {
+        _result ^= QtsCrc32(_data.constData(), 4096).value();
+    }
+}
@@ -0,0 +1,193 @@
+//----------------------------------------------------------------------------
+//
+// Copyright (c) 2013-2017, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//
+// Unit test for class QtsDemuxHub
+//
+//----------------------------------------------------------------------------
+
+#include "QtlTest.h"
+#include "QtsDemuxHub.h"
+#include "QtsSectionDemux.h"
+#include "QtsTeletextDemux.h"
+#include "QtsTeletextFrame.h"
+#include "QtsProgramAssociationTable.h"
+#include "QtsProgramMapTable.h"
+#include "QtsTsFile.h"
+
+class QtsDemuxHubTest : public QObject, private QtsTableHandlerInterface, private QtsTeletextHandlerInterface
+{
+    Q_OBJECT
+public:
+    QtsDemuxHubTest();
+private slots:
+    void testRouting();
+    void testDetach();
+private:
+    int _patCount;
+    int _pmtCount;
+    int _frameCount;
+
+    virtual void handleTable(QtsSectionDemux& demux, const QtsTable& table) Q_DECL_OVERRIDE;
+    virtual void handleTeletextMessage(QtsTeletextDemux& demux, const QtsTeletextFrame& frame) Q_DECL_OVERRIDE;
+};
+
+#include "QtsDemuxHubTest.moc"
+QTL_TEST_CLASS(QtsDemuxHubTest);
+
+
+//----------------------------------------------------------------------------
+// Constructor
+//----------------------------------------------------------------------------
+
+QtsDemuxHubTest::QtsDemuxHubTest() :
+    _patCount(0),
+    _pmtCount(0),
+    _frameCount(0)
+{
+}
+
+
+//----------------------------------------------------------------------------
+// Route one reference stream to a section demux and a Teletext demux.
+// The PMT PID is added to the section demux when the PAT is found.
+//----------------------------------------------------------------------------
+
+void QtsDemuxHubTest::testRouting()
+{
+    _patCount = _pmtCount = _frameCount = 0;
+
+    QtsSectionDemux sectionDemux(this);
+    sectionDemux.addPid(QTS_PID_PAT);
+
+    QtsTeletextDemux teletextDemux(this);
+    teletextDemux.addPid(1068); // known Teletext PID for test stream
+
+    QtsDemuxHub hub;
+    QVERIFY(hub.addDemux(&sectionDemux));
+    QVERIFY(hub.addDemux(&teletextDemux));
+    QVERIFY(!hub.addDemux(&teletextDemux));
+    QVERIFY(!hub.addDemux(&hub));
+    QVERIFY(hub.demuxCount() == 2);
+    QVERIFY(hub.pidCount() == 2);
+
+    // The filter of the hub cannot be modified directly.
+    hub.addPid(100);
+    QVERIFY(hub.pidCount() == 2);
+
+    QtsTsFile file(":/test/test-teletext.stream");
+    QVERIFY(file.open(QFile::ReadOnly));
+    QtsTsPacket packets[64];
+    int count;
+    while ((count = file.read(packets, 64)) > 0) {
+        QVERIFY(hub.feedPackets(packets, count) == count);
+    }
+    teletextDemux.flushTeletext();
+    file.close();
+
+    QVERIFY(hub.pidCount() == 3);
+    QVERIFY(hub.packetCount() == 1987);
+    QVERIFY(sectionDemux.packetCount() == 1987);
+    QVERIFY(teletextDemux.packetCount() == 1987);
+    QVERIFY(_patCount > 0);
+    QVERIFY(_pmtCount > 0);
+    QVERIFY(_frameCount == 9);
+    QVERIFY(teletextDemux.frameCount(889, 1068) == 9);
+}
+
+
+//----------------------------------------------------------------------------
+// Detach demuxes from a hub.
+//----------------------------------------------------------------------------
+
+void QtsDemuxHubTest::testDetach()
+{
+    QtsSectionDemux sectionDemux(this);
+    sectionDemux.addPid(QTS_PID_PAT);
+
+    QtsTsPacket packet(QtsNullPacket);
+    packet.setPid(QTS_PID_PAT);
+    QtsDemuxHub* hub = new QtsDemuxHub;
+    {
+        QtsTeletextDemux teletextDemux(this);
+        teletextDemux.addPid(1068);
+        QVERIFY(hub->addDemux(&sectionDemux));
+        QVERIFY(hub->addDemux(&teletextDemux));
+        QVERIFY(hub->pidCount() == 2);
+        // Leaving the block deletes the Teletext demux, it must detach itself from the hub.
+    }
+    QVERIFY(hub->demuxCount() == 1);
+    QVERIFY(hub->pidCount() == 1);
+
+    hub->feedPacket(packet);
+    hub->feedPacket(packet);
+    QVERIFY(sectionDemux.packetCount() == 2);
+
+    // Deleting the hub detaches the section demux, it keeps the packet count.
+    delete hub;
+    QVERIFY(sectionDemux.packetCount() == 2);
+    sectionDemux.feedPacket(packet);
+    QVERIFY(sectionDemux.packetCount() == 3);
+}
+
+
+//----------------------------------------------------------------------------
+// PSI/SI table handler.
+//----------------------------------------------------------------------------
+
+void QtsDemuxHubTest::handleTable(QtsSectionDemux& demux, const QtsTable& table)
+{
+    switch (table.tableId()) {
+        case QTS_TID_PAT: {
+            const QtsProgramAssociationTable pat(table);
+            QVERIFY(pat.isValid());
+            QVERIFY(pat.serviceList.size() == 1);
+            demux.addPid(pat.serviceList.first().pmtPid);
+            _patCount++;
+            break;
+        }
+        case QTS_TID_PMT: {
+            const QtsProgramMapTable pmt(table);
+            QVERIFY(pmt.isValid());
+            QVERIFY(pmt.streams.last().pid == 1068);
+            _pmtCount++;
+            break;
+        }
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Teletext handler.
+//----------------------------------------------------------------------------
+
+void QtsDemuxHubTest::handleTeletextMessage(QtsTeletextDemux& demux, const QtsTeletextFrame& frame)
+{
+    QVERIFY(demux.packetCount() > 0);
+    QVERIFY(frame.pid() == 1068);
+    _frameCount++;
+}
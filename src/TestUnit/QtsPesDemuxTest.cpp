@@ -0,0 +1,222 @@
+//----------------------------------------------------------------------------
+//
+// Copyright (c) 2013-2017, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//
+// Unit test for class QtsPesDemux
+//
+//----------------------------------------------------------------------------
+
+#include "QtlTest.h"
+#include "QtsPesDemux.h"
+
+class QtsPesDemuxTest : public QObject, private QtsPesHandlerInterface
+{
+    Q_OBJECT
+public:
+    QtsPesDemuxTest() : _keepMode(KeepNone), _packets(), _buffers() {}
+private slots:
+    void testKeptPackets();
+    void testBufferReuse();
+    void testDetachedPackets();
+private:
+    //! What the PES handler does with the packets.
+    enum KeepMode {
+        KeepNone,      //!< Don't keep packets.
+        KeepHalf,      //!< Keep all packets, detach one out of two.
+        KeepDetached   //!< Keep and detach all packets.
+    };
+    KeepMode             _keepMode;
+    QList<QtsPesPacket>  _packets;  //!< Kept packets.
+    QList<const quint8*> _buffers;  //!< Address of the reassembly buffer of each PES packet.
+
+    void startTest(KeepMode keepMode);
+    void feedPesPacket(QtsPesDemux& demux, QtsPid pid, quint8& cc, int tsCount, quint8 value);
+    virtual void handlePesPacket(QtsPesDemux& demux, const QtsPesPacket& packet) Q_DECL_OVERRIDE;
+};
+
+#include "QtsPesDemuxTest.moc"
+QTL_TEST_CLASS(QtsPesDemuxTest);
+
+//----------------------------------------------------------------------------
+
+namespace {
+    const int headerSize = 9;
+    const int payloadPerTs = QTS_PKT_SIZE - 4;
+}
+
+// Reset the test context.
+void QtsPesDemuxTest::startTest(KeepMode keepMode)
+{
+    _keepMode = keepMode;
+    _packets.clear();
+    _buffers.clear();
+}
+
+// Feed the demux with one PES packet in tsCount TS packets, the payload is filled with value.
+// The PES packet is reported when the next one starts on the same PID.
+void QtsPesDemuxTest::feedPesPacket(QtsPesDemux& demux, QtsPid pid, quint8& cc, int tsCount, quint8 value)
+{
+    for (int ts = 0; ts < tsCount; ++ts) {
+        QtsTsPacket pkt(QtsNullPacket);
+        pkt.setPid(pid);
+        pkt.setCc(cc);
+        cc = (cc + 1) % QTS_CC_MAX;
+        quint8* data = pkt.b + 4;
+        int size = payloadPerTs;
+        if (ts == 0) {
+            // Unbounded video PES packet header.
+            static const quint8 header[headerSize] = {0x00, 0x00, 0x01, 0xE0, 0x00, 0x00, 0x80, 0x00, 0x00};
+            pkt.setPusi();
+            ::memcpy(data, header, headerSize);
+            data += headerSize;
+            size -= headerSize;
+        }
+        ::memset(data, value, size);
+        demux.feedPacket(pkt);
+    }
+}
+
+// PES handler: record the reassembly buffer, keep the packets according to the test.
+void QtsPesDemuxTest::handlePesPacket(QtsPesDemux& demux, const QtsPesPacket& packet)
+{
+    Q_UNUSED(demux);
+    _buffers << packet.header();
+    switch (_keepMode) {
+    case KeepNone:
+        break;
+    case KeepHalf:
+        _packets << packet;
+        if (_packets.size() % 2 == 0) {
+            _packets.last().detach();
+        }
+        break;
+    case KeepDetached:
+        _packets << packet;
+        _packets.last().detach();
+        break;
+    }
+}
+
+// Test case: PES packets which are kept by the handler are not modified by the demux.
+void QtsPesDemuxTest::testKeptPackets()
+{
+    const QtsPid pid = 0x0100;
+    const int pesCount = 10;
+    const int tsPerPes = 3;
+
+    QtsPesDemux demux(this);
+    startTest(KeepHalf);
+
+    // Generate PES packets, the payload of PES packet n is filled with value n.
+    quint8 cc = 0;
+    for (int pes = 0; pes <= pesCount; ++pes) {
+        feedPesPacket(demux, pid, cc, tsPerPes, quint8(pes));
+    }
+
+    // The last PES packet is not terminated.
+    QVERIFY(_packets.size() == pesCount);
+    for (int pes = 0; pes < pesCount; ++pes) {
+        const QtsPesPacket& pp(_packets[pes]);
+        QVERIFY(pp.isValid());
+        QVERIFY(pp.getSourcePid() == pid);
+        QVERIFY(pp.headerSize() == headerSize);
+        QVERIFY(pp.size() == tsPerPes * payloadPerTs);
+        for (int i = 0; i < pp.payloadSize(); ++i) {
+            QVERIFY(pp.payload()[i] == pes);
+        }
+    }
+
+    // Packets which are kept without detach (even indexes) retain their reassembly buffer,
+    // the next PES packet uses another one. After a detach (odd indexes), the reassembly
+    // buffer is reused for the next PES packet.
+    for (int pes = 0; pes < pesCount - 1; ++pes) {
+        if (pes % 2 == 0) {
+            QVERIFY(_packets[pes].header() == _buffers[pes]);
+            QVERIFY(_buffers[pes + 1] != _buffers[pes]);
+        }
+        else {
+            QVERIFY(_packets[pes].header() != _buffers[pes]);
+            QVERIFY(_buffers[pes + 1] == _buffers[pes]);
+        }
+    }
+}
+
+// Test case: when the packets are not kept, one single reassembly buffer is used on a PID.
+void QtsPesDemuxTest::testBufferReuse()
+{
+    const QtsPid pid = 0x0200;
+    const int largeTsCount = 400; // more than 64 kB, the buffer grows to 512 kB.
+    const int smallTsCount = 3;
+
+    QtsPesDemux demux(this);
+    startTest(KeepNone);
+
+    // Alternate large and small PES packets.
+    quint8 cc = 0;
+    for (int pes = 0; pes < 10; ++pes) {
+        feedPesPacket(demux, pid, cc, pes % 3 == 0 ? largeTsCount : smallTsCount, quint8(pes));
+    }
+    feedPesPacket(demux, pid, cc, smallTsCount, 0xFF);
+
+    // The buffer is allocated with the first (large) PES packet. Its capacity is retained
+    // through the small packets: the next large packets are reassembled without reallocation.
+    QVERIFY(_buffers.size() == 10);
+    QVERIFY(_buffers.first() != 0);
+    for (int pes = 1; pes < _buffers.size(); ++pes) {
+        QVERIFY(_buffers[pes] == _buffers.first());
+    }
+}
+
+// Test case: detached packets leave the reassembly buffer to the demux.
+void QtsPesDemuxTest::testDetachedPackets()
+{
+    const QtsPid pid = 0x0300;
+    const int pesCount = 10;
+    const int tsPerPes = 5;
+
+    QtsPesDemux demux(this);
+    startTest(KeepDetached);
+
+    quint8 cc = 0;
+    for (int pes = 0; pes <= pesCount; ++pes) {
+        feedPesPacket(demux, pid, cc, tsPerPes, quint8(pes));
+    }
+
+    // No new buffer after the first PES packet, the detached copies use their own buffers.
+    QVERIFY(_buffers.size() == pesCount);
+    QVERIFY(_packets.size() == pesCount);
+    for (int pes = 0; pes < pesCount; ++pes) {
+        const QtsPesPacket& pp(_packets[pes]);
+        QVERIFY(_buffers[pes] == _buffers.first());
+        QVERIFY(pp.header() != _buffers.first());
+        // The content of the detached packet is not modified by the next PES packets.
+        QVERIFY(pp.size() == tsPerPes * payloadPerTs);
+        for (int i = 0; i < pp.payloadSize(); ++i) {
+            QVERIFY(pp.payload()[i] == pes);
+        }
+    }
+}
@@ -33,6 +33,7 @@
 #include "QtlTest.h"
 #include "QtlHexa.h"
 #include "QtsStandaloneTableDemux.h"
+#include "QtsSectionHandlerInterface.h"
 #include "QtsData.h"
 
 class QtsSectionDemuxTest : public QObject
@@ -41,6 +42,22 @@ class QtsSectionDemuxTest : public QObject
 private slots:
     void testTables();
     void testTables_data();
+    void testTablesBatch();
+    void testTablesBatch_data();
+    void testReuseRepeatedSections();
+};
+
+// A section handler which records the addresses of all sections.
+class QtsSectionDemuxTestHandler : public QtsSectionHandlerInterface
+{
+public:
+    QList<const QtsSection*> sections;
+    virtual void handleSection(QtsSectionDemux& demux, const QtsSection& section) Q_DECL_OVERRIDE
+    {
+        Q_UNUSED(demux);
+        QVERIFY(section.isValid());
+        sections << &section;
+    }
 };
 
 #include "QtsSectionDemuxTest.moc"
@@ -87,6 +104,44 @@ void QtsSectionDemuxTest::testTables()
     QVERIFY(sectionData == sectionsAddress + sectionsSize);
 }
 
+// Test case: Demux various tables using batches of packets.
+void QtsSectionDemuxTest::testTablesBatch()
+{
+    QFETCH(ConstBytePtr, packetsAddress);
+    QFETCH(int, packetsSize);
+    QFETCH(ConstBytePtr, sectionsAddress);
+    QFETCH(int, sectionsSize);
+    QFETCH(QtsTableId, tid);
+
+    const QtsTsPacket* const refPackets = reinterpret_cast <const QtsTsPacket*>(packetsAddress);
+    const int refPacketsCount = packetsSize / QTS_PKT_SIZE;
+
+    // Demux all packets in one batch.
+    QtsStandaloneTableDemux demux(QtsAllPids);
+    QCOMPARE(demux.feedPackets(refPackets, refPacketsCount), refPacketsCount);
+    QCOMPARE(demux.packetCount(), QtsPacketCounter(refPacketsCount));
+
+    // Same result as packet per packet.
+    QVERIFY(demux.tableCount() == 1);
+    const QtsTablePtr table(demux.tableAt(0));
+    QVERIFY(table->tableId() == tid);
+
+    ConstBytePtr sectionData = sectionsAddress;
+    for (int si = 0; si < table->sectionCount(); ++si) {
+        const QtsSectionPtr section(table->sectionAt(si));
+        QVERIFY(sectionData + section->size() <= sectionsAddress + sectionsSize);
+        QVERIFY(::memcmp(section->content(), sectionData, section->size()) == 0);
+        sectionData += section->size();
+    }
+    QVERIFY(sectionData == sectionsAddress + sectionsSize);
+}
+
+// Data-sets for testTablesBatch()
+void QtsSectionDemuxTest::testTablesBatch_data()
+{
+    testTables_data();
+}
+
 // Data-sets for testTables()
 void QtsSectionDemuxTest::testTables_data()
 {
@@ -166,3 +221,35 @@ void QtsSectionDemuxTest::testTables_data()
             << psi_sdt_r6_sections_size
             << QTS_TID_SDT_ACT;
 }
+
+// Test case: Reuse repeated sections.
+void QtsSectionDemuxTest::testReuseRepeatedSections()
+{
+    const QtsTsPacket* const packets = reinterpret_cast <const QtsTsPacket*>(psi_pat_r4_packets);
+    const int packetsCount = psi_pat_r4_packets_size / QTS_PKT_SIZE;
+
+    QtsSectionDemuxTestHandler handler;
+    QtsSectionDemux demux(0, &handler, QtsAllPids);
+    QVERIFY(!demux.reuseRepeatedSections());
+    demux.setReuseRepeatedSections(true);
+    QVERIFY(demux.reuseRepeatedSections());
+
+    // Demux the same table twice. In the second pass, adjust the continuity
+    // counters so that the packets are not considered as duplicates.
+    for (int pass = 0; pass < 2; ++pass) {
+        for (int pi = 0; pi < packetsCount; ++pi) {
+            QtsTsPacket pkt(packets[pi]);
+            pkt.setCc((pkt.getCc() + pass * packetsCount) % QTS_CC_MAX);
+            demux.feedPacket(pkt);
+        }
+    }
+
+    // Repeated sections must be the same objects.
+    const int count = handler.sections.size();
+    QVERIFY(count > 0);
+    QVERIFY(count % 2 == 0);
+    for (int si = 0; si < count / 2; ++si) {
+        QVERIFY(handler.sections[si] == handler.sections[si + count / 2]);
+    }
+    QVERIFY(QtsSectionDemux::Status(demux).wrongCrc == 0);
+}
@@ -48,6 +48,7 @@ public:
     QtsTeletextDemuxTest();
 private slots:
     void testReferenceTeletext();
+    void testPageFilter();
 private:
     QString            _genString;
     QTextStream        _genStream;
@@ -121,6 +122,51 @@ void QtsTeletextDemuxTest::testReferenceTeletext()
 }
 
 
+//----------------------------------------------------------------------------
+// Test the selection of decoded Teletext pages.
+//----------------------------------------------------------------------------
+
+void QtsTeletextDemuxTest::testPageFilter()
+{
+    // Decode page 889 only, the subtitles of the test stream.
+    QtsTeletextDemux demux889;
+    demux889.addPid(1068);
+    QVERIFY(demux889.isPageDecoded(889));
+    QVERIFY(demux889.isPageDecoded(888));
+    demux889.addPage(889);
+    QVERIFY(demux889.isPageDecoded(889));
+    QVERIFY(!demux889.isPageDecoded(888));
+
+    // Decode page 888 only, not present in the test stream.
+    QtsTeletextDemux demux888;
+    demux888.addPid(1068);
+    demux888.addPage(888);
+    demux888.addPage(777);
+    demux888.removePage(777);
+    QVERIFY(demux888.isPageDecoded(888));
+    QVERIFY(!demux888.isPageDecoded(777));
+    QVERIFY(!demux888.isPageDecoded(889));
+
+    QtsTsFile file(":/test/test-teletext.stream");
+    QVERIFY(file.open(QFile::ReadOnly));
+    QtsTsPacket packet;
+    while (file.read(&packet) > 0) {
+        demux889.feedPacket(packet);
+        demux888.feedPacket(packet);
+    }
+    demux889.flushTeletext();
+    demux888.flushTeletext();
+    file.close();
+
+    QVERIFY(demux889.frameCount(889) == 9);
+    QVERIFY(demux888.frameCount(889) == 0);
+    QVERIFY(demux888.frameCount(888) == 0);
+
+    demux888.clearPageFilter();
+    QVERIFY(demux888.isPageDecoded(889));
+}
+
+
 //----------------------------------------------------------------------------
 // PSI/SI table handler.
 //----------------------------------------------------------------------------
@@ -46,10 +46,12 @@ DEFINES += SRCDIR=\\\"$$PWD/\\\"
 SOURCES += \
     QtlVariableTest.cpp \
     QtlSmartPointerTest.cpp \
+    QtlDataFanOutTest.cpp \
     QtsData.cpp \
     QtsSectionTest.cpp \
     QtlByteBlockTest.cpp \
     QtsSectionDemuxTest.cpp \
+    QtsDemuxHubTest.cpp \
     main.cpp \
     QtlTest.cpp \
     QtsProgramMapTableTest.cpp \
@@ -60,7 +62,10 @@ SOURCES += \
     QtlStringUtilsTest.cpp \
     QtsTeletextDemuxTest.cpp \
     QtlSubStationAlphaParserTest.cpp \
-    QtlRangeTest.cpp
+    QtlRangeTest.cpp \
+    QtsCrc32Test.cpp \
+    QtsPesDemuxTest.cpp \
+    QtlMediaStreamInfoTest.cpp
 
 HEADERS += \
     QtlTest.h \
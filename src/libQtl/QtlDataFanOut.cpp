@@ -0,0 +1,373 @@
+//----------------------------------------------------------------------------
+//
+// Copyright (c) 2013-2017, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//
+// Qtl, Qt utility library.
+// Define the class QtlDataFanOut.
+//
+//----------------------------------------------------------------------------
+
+#include "QtlDataFanOut.h"
+#include "QtlFanOutDataPull.h"
+
+
+//----------------------------------------------------------------------------
+// Constructors and destructor.
+//----------------------------------------------------------------------------
+
+QtlDataFanOut::QtlDataFanOut(qint64 maxLag, QtlLogger* log, QObject* parent) :
+    QIODevice(parent),
+    _nullLog(),
+    _log(log == 0 ? &_nullLog : log),
+    _maxLag(qMax<qint64>(1024, maxLag)),
+    _mutex(),
+    _chunks(),
+    _ringStart(0),
+    _head(0),
+    _acknowledged(0),
+    _consumers(),
+    _ended(false),
+    _success(false),
+    _ackPosted(false),
+    _finishPosted(false)
+{
+}
+
+QtlDataFanOut::Consumer::Consumer(QtlFanOutDataPull* pull_, LagPolicy policy_, qint64 position_) :
+    pull(pull_),
+    policy(policy_),
+    position(position_)
+{
+}
+
+QtlDataFanOut::~QtlDataFanOut()
+{
+    // Abort all remaining consumers.
+    QMutexLocker lock(&_mutex);
+    foreach (const Consumer& c, _consumers) {
+        QMetaObject::invokeMethod(c.pull, "stop", Qt::QueuedConnection);
+    }
+    _consumers.clear();
+    _chunks.clear();
+}
+
+
+//----------------------------------------------------------------------------
+// Start the transfer from the source into all consumers.
+//----------------------------------------------------------------------------
+
+bool QtlDataFanOut::start(QtlDataPull* source)
+{
+    if (source == 0 || isOpen() || !open(QIODevice::WriteOnly)) {
+        return false;
+    }
+
+    connect(source, &QtlDataPull::completed, this, &QtlDataFanOut::sourceCompleted);
+    if (source->start(this)) {
+        return true;
+    }
+    else {
+        // The source is never started, abort all consumers.
+        disconnect(source, 0, this, 0);
+        sourceCompleted(false);
+        return false;
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Invoked when the source completes.
+//----------------------------------------------------------------------------
+
+void QtlDataFanOut::sourceCompleted(bool success)
+{
+    QList<QtlFanOutDataPull*> pulls;
+    qint64 size = 0;
+    {
+        QMutexLocker lock(&_mutex);
+        _ended = true;
+        _success = success;
+        size = _head;
+        foreach (const Consumer& c, _consumers) {
+            pulls << c.pull;
+        }
+        checkFinishedLocked();
+    }
+
+    _log->debug(tr("Fan-out source %1 after %2 bytes, %3 consumers remaining").arg(success ? tr("completed") : tr("aborted")).arg(size).arg(pulls.size()));
+
+    // On success, the consumers transfer the remaining data and close. On error, they abort.
+    foreach (QtlFanOutDataPull* pull, pulls) {
+        if (success) {
+            pull->notify();
+        }
+        else {
+            QMetaObject::invokeMethod(pull, "stop", Qt::QueuedConnection);
+        }
+    }
+
+    if (isOpen()) {
+        close();
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Get some global state.
+//----------------------------------------------------------------------------
+
+int QtlDataFanOut::consumerCount() const
+{
+    QMutexLocker lock(&_mutex);
+    return _consumers.size();
+}
+
+qint64 QtlDataFanOut::totalSize() const
+{
+    QMutexLocker lock(&_mutex);
+    return _head;
+}
+
+qint64 QtlDataFanOut::retainedSize() const
+{
+    QMutexLocker lock(&_mutex);
+    return _head - _ringStart;
+}
+
+
+//----------------------------------------------------------------------------
+// Reimplemented from QIODevice.
+//----------------------------------------------------------------------------
+
+bool QtlDataFanOut::isSequential() const
+{
+    return true;
+}
+
+qint64 QtlDataFanOut::bytesToWrite() const
+{
+    QMutexLocker lock(&_mutex);
+    return _head - _acknowledged;
+}
+
+qint64 QtlDataFanOut::readData(char* data, qint64 maxSize)
+{
+    Q_UNUSED(data);
+    Q_UNUSED(maxSize);
+    return -1;
+}
+
+
+//----------------------------------------------------------------------------
+// Write data from the source.
+//----------------------------------------------------------------------------
+
+qint64 QtlDataFanOut::writeData(const char* data, qint64 maxSize)
+{
+    QList<QtlFanOutDataPull*> pulls;
+    {
+        QMutexLocker lock(&_mutex);
+
+        // When all consumers are gone, report an error to abort the source.
+        if (_ended || _consumers.isEmpty()) {
+            return -1;
+        }
+        if (data == 0 || maxSize <= 0) {
+            return 0;
+        }
+
+        // Add a new chunk in the ring. The data are copied only once for all consumers.
+        _chunks.append(QByteArray(data, int(maxSize)));
+        _head += maxSize;
+
+        // Drop the consumers which are too late, notify the others.
+        for (int index = 0; index < _consumers.size(); ++index) {
+            const Consumer& c(_consumers[index]);
+            if (c.policy == DropOnLag && _head - c.position > _maxLag) {
+                _log->debug(tr("Fan-out consumer dropped, lag: %1 bytes").arg(_head - c.position));
+                QMetaObject::invokeMethod(c.pull, "dropTransfer", Qt::QueuedConnection);
+                _consumers.removeAt(index);
+                --index;
+            }
+            else {
+                pulls << c.pull;
+            }
+        }
+        updateRingLocked();
+    }
+
+    foreach (QtlFanOutDataPull* pull, pulls) {
+        pull->notify();
+    }
+    return maxSize;
+}
+
+
+//----------------------------------------------------------------------------
+// Attach and detach consumers.
+//----------------------------------------------------------------------------
+
+void QtlDataFanOut::attach(QtlFanOutDataPull* pull, LagPolicy policy)
+{
+    QMutexLocker lock(&_mutex);
+    if (pull != 0 && indexOfLocked(pull) < 0) {
+        _consumers.append(Consumer(pull, policy, _head));
+    }
+}
+
+void QtlDataFanOut::detach(QtlFanOutDataPull* pull)
+{
+    QMutexLocker lock(&_mutex);
+    const int index = indexOfLocked(pull);
+    if (index >= 0) {
+        _consumers.removeAt(index);
+        updateRingLocked();
+        checkFinishedLocked();
+    }
+}
+
+void QtlDataFanOut::checkFinishedLocked()
+{
+    // The signal is queued: consumers detach from any thread, possibly in their cleanup.
+    if (_ended && _consumers.isEmpty() && !_finishPosted) {
+        _finishPosted = true;
+        QMetaObject::invokeMethod(this, "finished", Qt::QueuedConnection);
+    }
+}
+
+int QtlDataFanOut::indexOfLocked(const QtlFanOutDataPull* pull) const
+{
+    for (int index = 0; index < _consumers.size(); ++index) {
+        if (_consumers[index].pull == pull) {
+            return index;
+        }
+    }
+    return -1;
+}
+
+
+//----------------------------------------------------------------------------
+// Get the next data for a consumer.
+//----------------------------------------------------------------------------
+
+QtlDataFanOut::FetchStatus QtlDataFanOut::fetch(QtlFanOutDataPull* pull, qint64 maxSize, QByteArray& chunk, int& offset, int& size, qint64& lag)
+{
+    QMutexLocker lock(&_mutex);
+
+    // A consumer which is no longer attached was dropped.
+    const int index = indexOfLocked(pull);
+    if (index < 0 || (_ended && !_success)) {
+        return FetchAbort;
+    }
+
+    Consumer& c(_consumers[index]);
+    lag = _head - c.position;
+    if (lag <= 0 || maxSize == 0) {
+        return _ended && lag <= 0 ? FetchEnd : FetchWait;
+    }
+
+    // Locate the chunk containing the position of the consumer.
+    // The chunks before the position of the slowest consumer are already released.
+    qint64 chunkStart = _ringStart;
+    for (int i = 0; i < _chunks.size(); ++i) {
+        const int chunkSize = _chunks[i].size();
+        if (c.position < chunkStart + chunkSize) {
+            // Return a reference to the shared chunk, no data copy.
+            chunk = _chunks[i];
+            offset = int(c.position - chunkStart);
+            size = chunkSize - offset;
+            if (maxSize > 0 && maxSize < size) {
+                size = int(maxSize);
+            }
+            c.position += size;
+            updateRingLocked();
+            return FetchData;
+        }
+        chunkStart += chunkSize;
+    }
+
+    // Should not get there, the chunk at the position of a consumer is never released.
+    return FetchAbort;
+}
+
+
+//----------------------------------------------------------------------------
+// Release unused chunks and acknowledge data to the source.
+//----------------------------------------------------------------------------
+
+void QtlDataFanOut::updateRingLocked()
+{
+    // Compute the positions of the slowest consumer and slowest blocking consumer.
+    qint64 slowest = _head;
+    qint64 slowestBlocking = _head;
+    foreach (const Consumer& c, _consumers) {
+        slowest = qMin(slowest, c.position);
+        if (c.policy == BlockOnLag) {
+            slowestBlocking = qMin(slowestBlocking, c.position);
+        }
+    }
+
+    // Release the chunks which were transferred by all consumers.
+    // A consumer which is still writing a released chunk keeps its own reference on it.
+    while (!_chunks.isEmpty() && _ringStart + _chunks.first().size() <= slowest) {
+        _ringStart += _chunks.first().size();
+        _chunks.removeFirst();
+    }
+
+    // The data which were transferred by all blocking consumers are acknowledged to the source.
+    if (slowestBlocking > _acknowledged && !_ackPosted) {
+        _ackPosted = true;
+        QMetaObject::invokeMethod(this, "acknowledge", Qt::QueuedConnection);
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Invoked in the thread of this object to acknowledge data to the source.
+//----------------------------------------------------------------------------
+
+void QtlDataFanOut::acknowledge()
+{
+    qint64 bytes = 0;
+    {
+        QMutexLocker lock(&_mutex);
+        _ackPosted = false;
+        qint64 slowestBlocking = _head;
+        foreach (const Consumer& c, _consumers) {
+            if (c.policy == BlockOnLag) {
+                slowestBlocking = qMin(slowestBlocking, c.position);
+            }
+        }
+        bytes = slowestBlocking - _acknowledged;
+        if (bytes > 0) {
+            _acknowledged = slowestBlocking;
+        }
+    }
+    if (bytes > 0) {
+        emit bytesWritten(bytes);
+    }
+}
@@ -0,0 +1,277 @@
+//----------------------------------------------------------------------------
+//
+// Copyright (c) 2013-2017, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//!
+//! @file QtlDataFanOut.h
+//!
+//! Declare the class QtlDataFanOut.
+//! Qtl, Qt utility library.
+//!
+//----------------------------------------------------------------------------
+
+#ifndef QTLDATAFANOUT_H
+#define QTLDATAFANOUT_H
+
+#include "QtlDataPull.h"
+
+class QtlFanOutDataPull;
+
+//!
+//! A fan-out stage which feeds several consumers from one single QtlDataPull source.
+//!
+//! The source QtlDataPull writes into this object, a write-only sequential device.
+//! The data are kept in a ring of shared chunks (QByteArray are reference-counted).
+//! Each consumer is a QtlFanOutDataPull which transfers the data into its own device,
+//! at its own pace, using its own position in the ring. A chunk is released when all
+//! consumers have transferred it.
+//!
+//! Back-pressure: By default, a consumer blocks the source. The bytes which are written
+//! into this object are acknowledged to the source (using the bytesWritten() signal)
+//! only when all blocking consumers have transferred them. So, the source is pulled
+//! at the pace of the slowest blocking consumer and the lag of a consumer is bounded by
+//! the minimum buffer size of the source.
+//!
+//! Consumers which are created with the DropOnLag policy never slow down the source.
+//! When such a consumer lags behind the most recent data by more than the maximum
+//! lag of the fan-out, its transfer is aborted.
+//!
+//! Consumers which finish early (a process which terminates before the end of the
+//! data for instance) are detached from the fan-out and no longer retain data.
+//! When all consumers are detached, the source is aborted.
+//!
+//! Usage: create the fan-out, create all consumers, start all consumers on their
+//! devices and finally start the fan-out with the source. A consumer which is
+//! created after the start of the fan-out receives the data from that point only.
+//!
+//! The consumers may be used from other threads than the fan-out.
+//!
+//! The signal finished() is emitted when the source has completed and all consumers
+//! are detached. The fan-out, typically with its consumers and source as children,
+//! can then be deleted.
+//!
+//! @see QtlFanOutDataPull
+//!
+class QtlDataFanOut : public QIODevice
+{
+    Q_OBJECT
+
+public:
+    //!
+    //! Default maximum lag in bytes of DropOnLag consumers (16 MB).
+    //!
+    static const int DEFAULT_MAX_LAG = 16 * 1024 * 1024;
+
+    //!
+    //! Policy of a consumer which is late compared to the most recent data.
+    //!
+    enum LagPolicy {
+        BlockOnLag,   //!< The consumer slows down the source.
+        DropOnLag     //!< The consumer is aborted when its lag exceeds the maximum lag.
+    };
+
+    //!
+    //! Constructor.
+    //! @param [in] maxLag Maximum lag in bytes of DropOnLag consumers.
+    //! @param [in] log Optional message logger.
+    //! @param [in] parent Optional parent object.
+    //!
+    explicit QtlDataFanOut(qint64 maxLag = DEFAULT_MAX_LAG, QtlLogger* log = 0, QObject* parent = 0);
+
+    //!
+    //! Destructor.
+    //!
+    virtual ~QtlDataFanOut();
+
+    //!
+    //! Start the transfer from the source into all consumers.
+    //! @param [in] source The source of data. Not owned by this object.
+    //! @return True on success, false on error.
+    //!
+    bool start(QtlDataPull* source);
+
+    //!
+    //! Get the number of consumers which are currently attached.
+    //! @return The number of attached consumers.
+    //!
+    int consumerCount() const;
+
+    //!
+    //! Get the total size of data from the source.
+    //! @return The total size in bytes of data from the source.
+    //!
+    qint64 totalSize() const;
+
+    //!
+    //! Get the size of data which are currently retained in the ring.
+    //! @return The size in bytes of data which are not yet transferred by all consumers.
+    //!
+    qint64 retainedSize() const;
+
+    //!
+    //! Check if the device is sequential.
+    //! Reimplemented from QIODevice.
+    //! @return Always true.
+    //!
+    virtual bool isSequential() const Q_DECL_OVERRIDE;
+
+    //!
+    //! Get the number of bytes which are not yet acknowledged to the source.
+    //! Reimplemented from QIODevice.
+    //! @return The number of bytes waiting for blocking consumers.
+    //!
+    virtual qint64 bytesToWrite() const Q_DECL_OVERRIDE;
+
+signals:
+    //!
+    //! Emitted once, in the thread of this object, when the source has completed
+    //! and all consumers are detached.
+    //!
+    void finished();
+
+protected:
+    //!
+    //! Read data, not supported.
+    //! Reimplemented from QIODevice.
+    //! @param [out] data Not used.
+    //! @param [in] maxSize Not used.
+    //! @return Always -1.
+    //!
+    virtual qint64 readData(char* data, qint64 maxSize) Q_DECL_OVERRIDE;
+
+    //!
+    //! Write data from the source.
+    //! Reimplemented from QIODevice.
+    //! @param [in] data Address of data.
+    //! @param [in] maxSize Size in bytes of data.
+    //! @return The number of written bytes or -1 when no consumer is attached.
+    //!
+    virtual qint64 writeData(const char* data, qint64 maxSize) Q_DECL_OVERRIDE;
+
+private slots:
+    //!
+    //! Invoked when the source completes.
+    //! @param [in] success True if all data were successfully read.
+    //!
+    void sourceCompleted(bool success);
+
+    //!
+    //! Invoked in the thread of this object to acknowledge transferred data to the source.
+    //!
+    void acknowledge();
+
+private:
+    friend class QtlFanOutDataPull;
+
+    //!
+    //! Status of a fetch() operation.
+    //!
+    enum FetchStatus {
+        FetchData,      //!< Some data were returned.
+        FetchWait,      //!< No data for now, the consumer will be notified.
+        FetchEnd,       //!< All data were transferred, the consumer shall close.
+        FetchAbort      //!< The source failed or the consumer was dropped.
+    };
+
+    //!
+    //! Describe the context of one consumer.
+    //!
+    class Consumer
+    {
+    public:
+        QtlFanOutDataPull* pull;      //!< Consumer object.
+        LagPolicy          policy;    //!< Policy when the consumer is late.
+        qint64             position;  //!< Position of the next data to transfer.
+        //!
+        //! Constructor.
+        //! @param [in] pull Consumer object.
+        //! @param [in] policy Policy when the consumer is late.
+        //! @param [in] position Position of the next data to transfer.
+        //!
+        Consumer(QtlFanOutDataPull* pull = 0, LagPolicy policy = BlockOnLag, qint64 position = 0);
+    };
+
+    QtlNullLogger     _nullLog;        //!< Default logger.
+    QtlLogger*        _log;            //!< Message logger.
+    const qint64      _maxLag;         //!< Maximum lag of DropOnLag consumers.
+    mutable QMutex    _mutex;          //!< Protect the following fields.
+    QList<QByteArray> _chunks;         //!< Ring of shared data chunks.
+    qint64            _ringStart;      //!< Position of the first chunk in the ring.
+    qint64            _head;           //!< Total size of data from the source.
+    qint64            _acknowledged;   //!< Total size of data acknowledged to the source.
+    QList<Consumer>   _consumers;      //!< Attached consumers.
+    bool              _ended;          //!< The source has completed.
+    bool              _success;        //!< The source has successfully completed.
+    bool              _ackPosted;      //!< acknowledge() is posted for execution.
+    bool              _finishPosted;   //!< finished() is posted for emission.
+
+    //!
+    //! Attach a consumer, invoked by the constructor of QtlFanOutDataPull.
+    //! @param [in] pull Consumer object.
+    //! @param [in] policy Policy when the consumer is late.
+    //!
+    void attach(QtlFanOutDataPull* pull, LagPolicy policy);
+
+    //!
+    //! Detach a consumer, invoked at the end of the transfer of a QtlFanOutDataPull.
+    //! @param [in] pull Consumer object.
+    //!
+    void detach(QtlFanOutDataPull* pull);
+
+    //!
+    //! Get the next data for a consumer and move its position after them.
+    //! @param [in] pull Consumer object.
+    //! @param [in] maxSize Maximum size in bytes to return. If negative, no limit.
+    //! @param [out] chunk Receive the shared chunk containing the data.
+    //! @param [out] offset Offset of the data in @a chunk.
+    //! @param [out] size Size of the data in @a chunk.
+    //! @param [out] lag Lag in bytes of the consumer before the operation.
+    //! @return Status of the operation.
+    //!
+    FetchStatus fetch(QtlFanOutDataPull* pull, qint64 maxSize, QByteArray& chunk, int& offset, int& size, qint64& lag);
+
+    //!
+    //! Release unused chunks and acknowledge data to the source. The mutex must be held.
+    //!
+    void updateRingLocked();
+
+    //!
+    //! Post the signal finished() if the source and all consumers are done. The mutex must be held.
+    //!
+    void checkFinishedLocked();
+
+    //!
+    //! Find the index of a consumer. The mutex must be held.
+    //! @param [in] pull Consumer object.
+    //! @return Index of the consumer in _consumers or -1 if not found.
+    //!
+    int indexOfLocked(const QtlFanOutDataPull* pull) const;
+
+    // Unaccessible operations.
+    Q_DISABLE_COPY(QtlDataFanOut)
+};
+
+#endif // QTLDATAFANOUT_H
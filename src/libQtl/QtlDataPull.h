@@ -296,6 +296,13 @@ protected:
     //!
     void close();
 
+    //!
+    //! The appropriate processing of the new state will be performed later, after returning in the event loop.
+    //! A subclass which receives its input asynchronously calls it when new input data become
+    //! available after a previous invocation of needTransfer() returned without writing anything.
+    //!
+    void processNewStateLater();
+
 private slots:
     //!
     //! Invoked when a device has written data.
@@ -314,11 +321,6 @@ private slots:
     void processNewState();
 
 private:
-    //!
-    //! The appropriate processing of the new state will be performed later, after returning in the event loop.
-    //!
-    void processNewStateLater();
-
     //!
     //! Invoked when a device has written data.
     //! @param [in] dev Destination device.
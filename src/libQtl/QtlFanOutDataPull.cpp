@@ -0,0 +1,192 @@
+//----------------------------------------------------------------------------
+//
+// Copyright (c) 2013-2017, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//
+// Qtl, Qt utility library.
+// Define the class QtlFanOutDataPull.
+//
+//----------------------------------------------------------------------------
+
+#include "QtlFanOutDataPull.h"
+
+
+//----------------------------------------------------------------------------
+// Constructor and destructor.
+//----------------------------------------------------------------------------
+
+QtlFanOutDataPull::QtlFanOutDataPull(QtlDataFanOut* fanOut, QtlDataFanOut::LagPolicy policy, int minBufferSize, QtlLogger* log, QObject* parent) :
+    QtlDataPull(minBufferSize, log, parent),
+    _fanOut(fanOut),
+    _policy(policy),
+    _notifyPosted(0),
+    _attached(false),
+    _dropped(false),
+    _maxLag(0),
+    _timer(),
+    _duration(-1)
+{
+    if (fanOut != 0) {
+        fanOut->attach(this, policy);
+        _attached = true;
+    }
+}
+
+QtlFanOutDataPull::~QtlFanOutDataPull()
+{
+    detach();
+}
+
+
+//----------------------------------------------------------------------------
+// Detach from the fan-out.
+//----------------------------------------------------------------------------
+
+void QtlFanOutDataPull::detach()
+{
+    if (_attached) {
+        _attached = false;
+        if (!_fanOut.isNull()) {
+            _fanOut->detach(this);
+        }
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Notifications from the fan-out.
+//----------------------------------------------------------------------------
+
+void QtlFanOutDataPull::notify()
+{
+    // Don't queue it several times.
+    if (_notifyPosted.testAndSetOrdered(0, 1)) {
+        QMetaObject::invokeMethod(this, "dataAvailable", Qt::QueuedConnection);
+    }
+}
+
+void QtlFanOutDataPull::dataAvailable()
+{
+    _notifyPosted.store(0);
+    processNewStateLater();
+}
+
+void QtlFanOutDataPull::dropTransfer()
+{
+    _dropped = true;
+    stop();
+}
+
+
+//----------------------------------------------------------------------------
+// Transfer statistics.
+//----------------------------------------------------------------------------
+
+qint64 QtlFanOutDataPull::elapsedMilliseconds() const
+{
+    if (_duration >= 0) {
+        return _duration;
+    }
+    else {
+        return _timer.isValid() ? _timer.elapsed() : 0;
+    }
+}
+
+qint64 QtlFanOutDataPull::bytesPerSecond() const
+{
+    const qint64 ms = elapsedMilliseconds();
+    return ms <= 0 ? 0 : (pulledSize() * 1000) / ms;
+}
+
+
+//----------------------------------------------------------------------------
+// Initialize the transfer.
+//----------------------------------------------------------------------------
+
+bool QtlFanOutDataPull::initializeTransfer()
+{
+    // A consumer cannot be restarted once detached from the fan-out.
+    if (!_attached || _fanOut.isNull()) {
+        return false;
+    }
+    _timer.start();
+    _duration = -1;
+    _maxLag = 0;
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Invoked when more data is needed.
+//----------------------------------------------------------------------------
+
+bool QtlFanOutDataPull::needTransfer(qint64 maxSize)
+{
+    if (_fanOut.isNull()) {
+        return false;
+    }
+
+    QByteArray chunk;
+    int offset = 0;
+    int size = 0;
+    qint64 lag = 0;
+
+    switch (_fanOut->fetch(this, maxSize, chunk, offset, size, lag)) {
+        case QtlDataFanOut::FetchData:
+            // The chunk is shared with the fan-out, the data remain valid during the write.
+            _maxLag = qMax(_maxLag, lag);
+            return write(chunk.constData() + offset, size);
+        case QtlDataFanOut::FetchEnd:
+            // All data transferred.
+            close();
+            return true;
+        case QtlDataFanOut::FetchWait:
+            // Nothing to transfer for now, dataAvailable() will restart the transfer.
+            return true;
+        case QtlDataFanOut::FetchAbort:
+        default:
+            return false;
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Cleanup the transfer.
+//----------------------------------------------------------------------------
+
+void QtlFanOutDataPull::cleanupTransfer(bool closed)
+{
+    // Release our position in the fan-out, the data are no longer retained for us.
+    _duration = _timer.isValid() ? _timer.elapsed() : 0;
+    detach();
+
+    log()->debug(tr("Fan-out consumer %1, %2 bytes, max lag: %3 bytes, time: %4 ms, throughput: %5 B/s")
+                 .arg(closed ? tr("completed") : (_dropped ? tr("dropped") : tr("aborted")))
+                 .arg(pulledSize())
+                 .arg(_maxLag)
+                 .arg(_duration)
+                 .arg(bytesPerSecond()));
+}
@@ -0,0 +1,182 @@
+//----------------------------------------------------------------------------
+//
+// Copyright (c) 2013-2017, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//!
+//! @file QtlFanOutDataPull.h
+//!
+//! Declare the class QtlFanOutDataPull.
+//! Qtl, Qt utility library.
+//!
+//----------------------------------------------------------------------------
+
+#ifndef QTLFANOUTDATAPULL_H
+#define QTLFANOUTDATAPULL_H
+
+#include "QtlDataPull.h"
+#include "QtlDataFanOut.h"
+
+//!
+//! A class to pull data from a QtlDataFanOut into one asynchronous device such as QProcess.
+//!
+//! Each instance is one consumer of the fan-out with its own position in the
+//! shared data. The consumer is attached to the fan-out by the constructor and
+//! detached at the end of its transfer, whether the transfer is complete or not.
+//!
+//! Some statistics are maintained during the transfer: maximum lag behind the
+//! most recent data of the fan-out and throughput.
+//!
+//! @see QtlDataFanOut
+//!
+class QtlFanOutDataPull : public QtlDataPull
+{
+    Q_OBJECT
+
+public:
+    //!
+    //! Constructor.
+    //! @param [in] fanOut The fan-out which provides the data. Must be non-zero.
+    //! @param [in] policy Policy when the consumer is late compared to the most recent data.
+    //! @param [in] minBufferSize The minimum buffer size is the lower limit of the
+    //! buffered data. When the amount of data not yet written to the device is lower
+    //! than this size, new data is pulled from the fan-out.
+    //! @param [in] log Optional message logger.
+    //! @param [in] parent Optional parent object.
+    //!
+    explicit QtlFanOutDataPull(QtlDataFanOut* fanOut,
+                               QtlDataFanOut::LagPolicy policy = QtlDataFanOut::BlockOnLag,
+                               int minBufferSize = DEFAULT_MIN_BUFFER_SIZE,
+                               QtlLogger* log = 0,
+                               QObject* parent = 0);
+
+    //!
+    //! Destructor.
+    //!
+    virtual ~QtlFanOutDataPull();
+
+    //!
+    //! Get the policy of this consumer when it is late.
+    //! @return The lag policy.
+    //!
+    QtlDataFanOut::LagPolicy lagPolicy() const
+    {
+        return _policy;
+    }
+
+    //!
+    //! Check if the transfer was aborted because the consumer lagged too much.
+    //! @return True if the consumer was dropped by the fan-out.
+    //!
+    bool isDropped() const
+    {
+        return _dropped;
+    }
+
+    //!
+    //! Get the maximum observed lag of this consumer.
+    //! @return The maximum number of bytes between the position of this
+    //! consumer and the most recent data of the fan-out.
+    //!
+    qint64 maxObservedLag() const
+    {
+        return _maxLag;
+    }
+
+    //!
+    //! Get the duration of the transfer.
+    //! @return The duration in milliseconds since the start of the transfer,
+    //! up to the end of the transfer when it is completed.
+    //!
+    qint64 elapsedMilliseconds() const;
+
+    //!
+    //! Get the throughput of the transfer.
+    //! @return The average throughput in bytes per second.
+    //!
+    qint64 bytesPerSecond() const;
+
+protected:
+    //!
+    //! Initialize the transfer.
+    //! Reimplemented from QtlDataPull.
+    //! @return True on success, false on error.
+    //!
+    virtual bool initializeTransfer() Q_DECL_OVERRIDE;
+
+    //!
+    //! Invoked when more data is needed.
+    //! Reimplemented from QtlDataPull.
+    //! @param [in] maxSize Maximum size in bytes of the requested transfer.
+    //! @return True on success, false on error.
+    //!
+    virtual bool needTransfer(qint64 maxSize) Q_DECL_OVERRIDE;
+
+    //!
+    //! Cleanup the transfer.
+    //! Reimplemented from QtlDataPull.
+    //! @param [in] closed If true, this is a clean termination.
+    //!
+    virtual void cleanupTransfer(bool closed) Q_DECL_OVERRIDE;
+
+private slots:
+    //!
+    //! Invoked in the thread of this object when new data are available in the fan-out.
+    //!
+    void dataAvailable();
+
+    //!
+    //! Invoked in the thread of this object when the fan-out drops this consumer.
+    //!
+    void dropTransfer();
+
+private:
+    friend class QtlDataFanOut;
+
+    QPointer<QtlDataFanOut>        _fanOut;        //!< Source of data.
+    const QtlDataFanOut::LagPolicy _policy;        //!< Policy when the consumer is late.
+    QAtomicInt                     _notifyPosted;  //!< dataAvailable() is posted for execution.
+    bool                           _attached;      //!< Attached to the fan-out.
+    bool                           _dropped;       //!< Dropped by the fan-out.
+    qint64                         _maxLag;        //!< Maximum observed lag.
+    QElapsedTimer                  _timer;         //!< Started with the transfer.
+    qint64                         _duration;      //!< Duration of a terminated transfer, -1 if not terminated.
+
+    //!
+    //! Post an invocation of dataAvailable(), from any thread.
+    //!
+    void notify();
+
+    //!
+    //! Detach from the fan-out.
+    //!
+    void detach();
+
+    // Unaccessible operations.
+    QtlFanOutDataPull() Q_DECL_EQ_DELETE;
+    Q_DISABLE_COPY(QtlFanOutDataPull)
+};
+
+#endif // QTLFANOUTDATAPULL_H
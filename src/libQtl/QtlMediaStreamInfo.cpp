@@ -518,3 +518,121 @@ void QtlMediaStreamInfo::setSamplingRate(int samplingRate)
 {
     _samplingRate = samplingRate < 9 ? 0 : samplingRate;
 }
+
+
+//----------------------------------------------------------------------------
+// Serialize a list of stream informations into a binary data stream.
+//----------------------------------------------------------------------------
+
+void QtlMediaStreamInfo::serialize(QDataStream& stream, const QtlMediaStreamInfoList& streams)
+{
+    // Null pointers in the list are serialized as default stream descriptions.
+    static const QtlMediaStreamInfo defaultInfo;
+
+    stream << qint32(streams.size());
+    foreach (const QtlMediaStreamInfoPtr& info, streams) {
+        const QtlMediaStreamInfo& si(info.isNull() ? defaultInfo : *info);
+        stream << qint32(si._streamType)
+               << si._title
+               << si._codecName
+               << si._language
+               << qint32(si._ffIndex)
+               << qint32(si._streamId)
+               << qint32(si._subtitleType)
+               << qint32(si._teletextPage)
+               << qint32(si._ccNumber)
+               << qint32(si._width)
+               << qint32(si._height)
+               << si._dar
+               << si._forcedDar
+               << qint32(si._rotation)
+               << si._forced
+               << si._impaired
+               << qint32(si._bitRate)
+               << si._frameRate
+               << si._originalAudio
+               << si._dubbedAudio
+               << qint32(si._audioChannels)
+               << qint32(si._samplingRate)
+               << si._commentary;
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Deserialize a list of stream informations from a binary data stream.
+//----------------------------------------------------------------------------
+
+bool QtlMediaStreamInfo::deserialize(QDataStream& stream, QtlMediaStreamInfoList& streams)
+{
+    streams.clear();
+
+    qint32 count = 0;
+    stream >> count;
+
+    for (qint32 index = 0; stream.status() == QDataStream::Ok && index < count; ++index) {
+        QtlMediaStreamInfoPtr info(new QtlMediaStreamInfo());
+        qint32 streamType = 0;
+        qint32 ffIndex = 0;
+        qint32 streamId = 0;
+        qint32 subtitleType = 0;
+        qint32 teletextPage = 0;
+        qint32 ccNumber = 0;
+        qint32 width = 0;
+        qint32 height = 0;
+        qint32 rotation = 0;
+        qint32 bitRate = 0;
+        qint32 audioChannels = 0;
+        qint32 samplingRate = 0;
+
+        stream >> streamType
+               >> info->_title
+               >> info->_codecName
+               >> info->_language
+               >> ffIndex
+               >> streamId
+               >> subtitleType
+               >> teletextPage
+               >> ccNumber
+               >> width
+               >> height
+               >> info->_dar
+               >> info->_forcedDar
+               >> rotation
+               >> info->_forced
+               >> info->_impaired
+               >> bitRate
+               >> info->_frameRate
+               >> info->_originalAudio
+               >> info->_dubbedAudio
+               >> audioChannels
+               >> samplingRate
+               >> info->_commentary;
+
+        // Reject out-of-range enumeration values.
+        if (streamType < Video || streamType > Other || subtitleType < SubRip || subtitleType > SubNone) {
+            stream.setStatus(QDataStream::ReadCorruptData);
+            break;
+        }
+
+        info->_streamType = StreamType(streamType);
+        info->_ffIndex = ffIndex;
+        info->_streamId = streamId;
+        info->_subtitleType = SubtitleType(subtitleType);
+        info->_teletextPage = teletextPage;
+        info->_ccNumber = ccNumber;
+        info->_width = width;
+        info->_height = height;
+        info->_rotation = rotation;
+        info->_bitRate = bitRate;
+        info->_audioChannels = audioChannels;
+        info->_samplingRate = samplingRate;
+        streams << info;
+    }
+
+    if (stream.status() != QDataStream::Ok) {
+        streams.clear();
+        return false;
+    }
+    return true;
+}
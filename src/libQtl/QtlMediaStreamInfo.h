@@ -49,12 +49,14 @@
 class QtlMediaStreamInfo;
 
 //!
-//! Smart pointer to a QtlMediaStreamInfo (non thread-safe).
+//! Smart pointer to a QtlMediaStreamInfo (thread-safe).
+//! Stream descriptions are built in the demux thread of Teletext searches.
 //!
-typedef QtlSmartPointer<QtlMediaStreamInfo,QtlNullMutexLocker> QtlMediaStreamInfoPtr;
+typedef QtlSmartPointer<QtlMediaStreamInfo,QtlAtomicLocker> QtlMediaStreamInfoPtr;
+Q_DECLARE_METATYPE(QtlMediaStreamInfoPtr)
 
 //!
-//! List of smart pointers to QtlMediaStreamInfo (non thread-safe).
+//! List of smart pointers to QtlMediaStreamInfo (thread-safe).
 //!
 typedef QList<QtlMediaStreamInfoPtr> QtlMediaStreamInfoList;
 
@@ -556,6 +558,21 @@ public:
     //!
     static void merge(QtlMediaStreamInfoList& destination, const QtlMediaStreamInfoList& source);
 
+    //!
+    //! Serialize a list of stream informations into a binary data stream.
+    //! @param [in,out] stream The data stream to write.
+    //! @param [in] streams The list of stream informations to serialize.
+    //!
+    static void serialize(QDataStream& stream, const QtlMediaStreamInfoList& streams);
+
+    //!
+    //! Deserialize a list of stream informations from a binary data stream.
+    //! @param [in,out] stream The data stream to read, as written by serialize().
+    //! @param [out] streams The list of deserialized stream informations.
+    //! @return True on success, false on error (truncated or corrupted stream).
+    //!
+    static bool deserialize(QDataStream& stream, QtlMediaStreamInfoList& streams);
+
 private:
     StreamType   _streamType;       //!< Stream type (audio, video, etc.)
     QString      _title;            //!< Free format readable description.
@@ -40,9 +40,10 @@
 
 //!
 //! The QtlMutexLocker class is a direct subclass of QMutexLocker.
-//! The only addition is the definition of the Mutex typedef.
+//! The only additions are the definitions of the Mutex and RefCount types.
 //! QtlMutexLocker is designed to be API-compatible with QtlNullMutexLocker
-//! so that they can be both used as template parameters to QtlSmartPointer.
+//! and QtlAtomicLocker so that they can be all used as template parameters
+//! to QtlSmartPointer.
 //!
 class QtlMutexLocker: public QMutexLocker
 {
@@ -52,6 +53,38 @@ public:
     //!
     typedef QMutex Mutex;
     //!
+    //! A reference counter which is protected by the mutex.
+    //!
+    class RefCount
+    {
+    public:
+        //!
+        //! Constructor.
+        //! @param [in] value Initial value.
+        //!
+        RefCount(int value) : _value(value) {}
+        //!
+        //! Increment the reference counter.
+        //! @param [in,out] mutex The associated mutex.
+        //! @return The new value of the counter.
+        //!
+        int ref(Mutex* mutex) {QMutexLocker lock(mutex); return ++_value;}
+        //!
+        //! Decrement the reference counter.
+        //! @param [in,out] mutex The associated mutex.
+        //! @return The new value of the counter.
+        //!
+        int deref(Mutex* mutex) {QMutexLocker lock(mutex); return --_value;}
+        //!
+        //! Get the value of the reference counter.
+        //! @param [in,out] mutex The associated mutex.
+        //! @return The value of the counter.
+        //!
+        int load(Mutex* mutex) {QMutexLocker lock(mutex); return _value;}
+    private:
+        int _value; //!< Counter value.
+    };
+    //!
     //! Constructor.
     //! @param [in,out] mutex The associated mutex.
     //!
@@ -80,6 +113,38 @@ public:
     {
     };
     //!
+    //! A non thread-safe reference counter.
+    //!
+    class RefCount
+    {
+    public:
+        //!
+        //! Constructor.
+        //! @param [in] value Initial value.
+        //!
+        RefCount(int value) : _value(value) {}
+        //!
+        //! Increment the reference counter.
+        //! @param [in,out] mutex Unused.
+        //! @return The new value of the counter.
+        //!
+        int ref(Mutex* mutex) {Q_UNUSED(mutex); return ++_value;}
+        //!
+        //! Decrement the reference counter.
+        //! @param [in,out] mutex Unused.
+        //! @return The new value of the counter.
+        //!
+        int deref(Mutex* mutex) {Q_UNUSED(mutex); return --_value;}
+        //!
+        //! Get the value of the reference counter.
+        //! @param [in,out] mutex Unused.
+        //! @return The value of the counter.
+        //!
+        int load(Mutex* mutex) {Q_UNUSED(mutex); return _value;}
+    private:
+        int _value; //!< Counter value.
+    };
+    //!
     //! Constructor.
     //! @param [in,out] mutex The associated mutex.
     //!
@@ -92,6 +157,74 @@ private:
     Q_DISABLE_COPY(QtlNullMutexLocker)
 };
 
+//!
+//! The QtlAtomicLocker class is a thread-safe locker with a lock-free reference counter.
+//!
+//! With QtlMutexLocker, each copy and destruction of a smart pointer locks a mutex.
+//! With QtlAtomicLocker, the reference counter is an atomic integer and the copy
+//! and destruction of smart pointers never lock, even when several threads share
+//! the same object. The mutex is used only for the operations which modify the
+//! pointed object reference (release, reset, casts) and for their readers.
+//!
+//! QtlAtomicLocker is API-compatible with QtlMutexLocker and QtlNullMutexLocker
+//! so that they can be all used as template parameters to QtlSmartPointer.
+//!
+class QtlAtomicLocker: public QMutexLocker
+{
+public:
+    //!
+    //! The Mutex type for this locker class.
+    //!
+    typedef QMutex Mutex;
+    //!
+    //! A lock-free reference counter.
+    //! The increment has no ordering constraint: a new reference can only be created from
+    //! an existing one. The decrement has acquire and release semantics so that all accesses
+    //! to the object from other threads are complete before the last reference deletes it.
+    //!
+    class RefCount
+    {
+    public:
+        //!
+        //! Constructor.
+        //! @param [in] value Initial value.
+        //!
+        RefCount(int value) : _value(value) {}
+        //!
+        //! Increment the reference counter.
+        //! @param [in,out] mutex Unused.
+        //! @return The new value of the counter.
+        //!
+        int ref(Mutex* mutex) {Q_UNUSED(mutex); return _value.fetchAndAddRelaxed(1) + 1;}
+        //!
+        //! Decrement the reference counter.
+        //! @param [in,out] mutex Unused.
+        //! @return The new value of the counter.
+        //!
+        int deref(Mutex* mutex) {Q_UNUSED(mutex); return _value.fetchAndAddOrdered(-1) - 1;}
+        //!
+        //! Get the value of the reference counter.
+        //! @param [in,out] mutex Unused.
+        //! @return The value of the counter.
+        //!
+        int load(Mutex* mutex) {Q_UNUSED(mutex); return _value.loadAcquire();}
+    private:
+        QAtomicInt _value; //!< Counter value.
+    };
+    //!
+    //! Constructor.
+    //! @param [in,out] mutex The associated mutex.
+    //!
+    QtlAtomicLocker(Mutex* mutex) :
+        QMutexLocker(mutex)
+    {
+    }
+private:
+    // Unaccessible operations.
+    QtlAtomicLocker() Q_DECL_EQ_DELETE;
+    Q_DISABLE_COPY(QtlAtomicLocker)
+};
+
 //!
 //! Template smart pointer (reference-counted, auto-delete, optionally thread-safe).
 //!
@@ -127,12 +260,14 @@ private:
 //!
 //! The QtlSmartPointer template class can be made thread-safe using a mutex.
 //! The type of mutex to use is given by the template parameter @a MUTEXLOCKER.
+//! The type of reference counter is also defined by @a MUTEXLOCKER.
 //!
 //! @tparam T The type of the pointed object. Cannot be an array type.
 //! @tparam MUTEXLOCKER A class which is used to synchronize access to the
-//! smart pointer internal state. Typically either QtlMutexLocker (for
-//! thread-safe smart pointers) or QtlNullMutexLocker (for non-thread-safe
-//! smart pointers).
+//! smart pointer internal state. Typically either QtlAtomicLocker (for
+//! thread-safe smart pointers with lock-free reference counting),
+//! QtlMutexLocker (for thread-safe smart pointers) or QtlNullMutexLocker
+//! (for non-thread-safe smart pointers).
 //!
 template <typename T, class MUTEXLOCKER>
 class QtlSmartPointer
@@ -497,7 +632,7 @@ private:
     {
     private:
         T*  _ptr;       //!< Pointer to actual object.
-        int _refCount;  //!< Reference counter.
+        typename MUTEXLOCKER::RefCount _refCount; //!< Reference counter.
         typename MUTEXLOCKER::Mutex _mutex; //!< Protect the SmartShared.
 
     public:
@@ -140,8 +140,7 @@ T* QtlSmartPointer<T,MUTEXLOCKER>::SmartShared::pointer()
 template <typename T, class MUTEXLOCKER>
 int QtlSmartPointer<T,MUTEXLOCKER>::SmartShared::count()
 {
-    MUTEXLOCKER lock(&_mutex);
-    return _refCount;
+    return _refCount.load(&_mutex);
 }
 
 
@@ -216,8 +215,7 @@ QtlSmartPointer<T,NEWMUTEXLOCKER> QtlSmartPointer<T,MUTEXLOCKER>::SmartShared::c
 template <typename T, class MUTEXLOCKER>
 typename QtlSmartPointer<T,MUTEXLOCKER>::SmartShared* QtlSmartPointer<T,MUTEXLOCKER>::SmartShared::attach()
 {
-    MUTEXLOCKER lock(&_mutex);
-    _refCount++;
+    _refCount.ref(&_mutex);
     return this;
 }
 
@@ -230,12 +228,8 @@ typename QtlSmartPointer<T,MUTEXLOCKER>::SmartShared* QtlSmartPointer<T,MUTEXLOC
 template <typename T, class MUTEXLOCKER>
 void QtlSmartPointer<T,MUTEXLOCKER>::SmartShared::detach()
 {
-    int refCount;
-    {
-        MUTEXLOCKER lock(&_mutex);
-        refCount = --_refCount;
-    }
-    if (refCount == 0) {
+    // The reference counter may be lock-free, depending on MUTEXLOCKER.
+    if (_refCount.deref(&_mutex) == 0) {
         delete this;
     }
 }
@@ -0,0 +1,192 @@
+//----------------------------------------------------------------------------
+//
+// Copyright (c) 2013-2017, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//
+// Qtl, Qt utility library.
+// Define the class QtlThreadDataPull.
+//
+//----------------------------------------------------------------------------
+
+#include "QtlThreadDataPull.h"
+
+
+//----------------------------------------------------------------------------
+// Constructor.
+//----------------------------------------------------------------------------
+
+QtlThreadDataPull::QtlThreadDataPull(int maxQueuedSize, int minBufferSize, QtlLogger* log, QObject* parent) :
+    QtlDataPull(minBufferSize, log, parent),
+    _maxQueued(qMax(1024, maxQueuedSize)),
+    _mutex(),
+    _notFull(),
+    _chunks(),
+    _chunkOffset(0),
+    _queuedSize(0),
+    _ended(false),
+    _terminated(false),
+    _notifyPosted(false)
+{
+}
+
+
+//----------------------------------------------------------------------------
+// Push data to transfer, from any thread.
+//----------------------------------------------------------------------------
+
+bool QtlThreadDataPull::push(const void* data, int dataSize)
+{
+    QMutexLocker lock(&_mutex);
+
+    // Wait until there is room in the queue. Periodically check if the thread is interrupted.
+    while (!_terminated && !_ended && _queuedSize > 0 && _queuedSize + dataSize > _maxQueued) {
+        _notFull.wait(&_mutex, 100);
+        if (QThread::currentThread()->isInterruptionRequested()) {
+            return false;
+        }
+    }
+    if (_terminated || _ended) {
+        return false;
+    }
+
+    // Queue the data and notify the thread of this object.
+    if (data != 0 && dataSize > 0) {
+        _chunks.append(QByteArray(reinterpret_cast<const char*>(data), dataSize));
+        _queuedSize += dataSize;
+        notifyLocked();
+    }
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Declare the end of data, from any thread.
+//----------------------------------------------------------------------------
+
+void QtlThreadDataPull::pushEnd()
+{
+    QMutexLocker lock(&_mutex);
+    _ended = true;
+    notifyLocked();
+}
+
+
+//----------------------------------------------------------------------------
+// Post an invocation of dataAvailable(), mutex must be held.
+//----------------------------------------------------------------------------
+
+void QtlThreadDataPull::notifyLocked()
+{
+    if (!_notifyPosted) {
+        _notifyPosted = true;
+        QMetaObject::invokeMethod(this, "dataAvailable", Qt::QueuedConnection);
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Invoked in the thread of this object when data are pushed.
+//----------------------------------------------------------------------------
+
+void QtlThreadDataPull::dataAvailable()
+{
+    {
+        QMutexLocker lock(&_mutex);
+        _notifyPosted = false;
+    }
+    processNewStateLater();
+}
+
+
+//----------------------------------------------------------------------------
+// Initialize the transfer.
+//----------------------------------------------------------------------------
+
+bool QtlThreadDataPull::initializeTransfer()
+{
+    QMutexLocker lock(&_mutex);
+    return !_terminated;
+}
+
+
+//----------------------------------------------------------------------------
+// Invoked when more data is needed.
+//----------------------------------------------------------------------------
+
+bool QtlThreadDataPull::needTransfer(qint64 maxSize)
+{
+    QByteArray data;
+    bool ended = false;
+
+    // Extract data from the queue, do not hold the mutex while writing.
+    {
+        QMutexLocker lock(&_mutex);
+        if (!_chunks.isEmpty()) {
+            const QByteArray& first(_chunks.first());
+            int size = first.size() - _chunkOffset;
+            if (maxSize >= 0 && maxSize < size) {
+                size = int(maxSize);
+            }
+            data = first.mid(_chunkOffset, size);
+            _chunkOffset += size;
+            if (_chunkOffset >= first.size()) {
+                _chunks.removeFirst();
+                _chunkOffset = 0;
+            }
+            _queuedSize -= size;
+            _notFull.wakeAll();
+        }
+        ended = _ended && _chunks.isEmpty();
+    }
+
+    if (!data.isEmpty()) {
+        return write(data.constData(), data.size());
+    }
+    else if (ended) {
+        // All data transferred.
+        close();
+    }
+    // Otherwise, nothing to transfer for now, dataAvailable() will restart the transfer.
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Cleanup the transfer.
+//----------------------------------------------------------------------------
+
+void QtlThreadDataPull::cleanupTransfer(bool closed)
+{
+    Q_UNUSED(closed);
+
+    // No more data accepted, release a blocked producer.
+    QMutexLocker lock(&_mutex);
+    _terminated = true;
+    _chunks.clear();
+    _chunkOffset = 0;
+    _queuedSize = 0;
+    _notFull.wakeAll();
+}
@@ -0,0 +1,140 @@
+//----------------------------------------------------------------------------
+//
+// Copyright (c) 2013-2017, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//!
+//! @file QtlThreadDataPull.h
+//!
+//! Declare the class QtlThreadDataPull.
+//! Qtl, Qt utility library.
+//!
+//----------------------------------------------------------------------------
+
+#ifndef QTLTHREADDATAPULL_H
+#define QTLTHREADDATAPULL_H
+
+#include "QtlDataPull.h"
+
+//!
+//! A class to pull data which are pushed by another thread into an asynchronous device such as QProcess.
+//!
+//! The producer thread calls push() and pushEnd(). The data are queued and transferred
+//! to the devices from the thread of this object. The queue is bounded: push() blocks
+//! the producer thread while the queue is full. When the transfer terminates before
+//! the end of the data (a device stopped reading for instance), push() returns false
+//! and the producer should stop pushing data.
+//!
+//! @see QtlDataPull
+//!
+class QtlThreadDataPull : public QtlDataPull
+{
+    Q_OBJECT
+
+public:
+    //!
+    //! Default maximum size in bytes of queued data (8 MB).
+    //!
+    static const int DEFAULT_MAX_QUEUED_SIZE = 8 * 1024 * 1024;
+
+    //!
+    //! Constructor.
+    //! @param [in] maxQueuedSize Maximum size in bytes of data which are pushed but not yet transferred.
+    //! @param [in] minBufferSize The minimum buffer size is the lower limit of the
+    //! buffered data. When the amount of data not yet written to the device is lower
+    //! than this size, new data is pulled from the queue.
+    //! @param [in] log Optional message logger.
+    //! @param [in] parent Optional parent object.
+    //!
+    explicit QtlThreadDataPull(int maxQueuedSize = DEFAULT_MAX_QUEUED_SIZE,
+                               int minBufferSize = DEFAULT_MIN_BUFFER_SIZE,
+                               QtlLogger* log = 0,
+                               QObject* parent = 0);
+
+    //!
+    //! Push data to transfer, from any thread.
+    //! Block while the queue is full. Also return when the calling thread is interrupted.
+    //! @param [in] data Address of data to transfer.
+    //! @param [in] dataSize Size in bytes of data to transfer.
+    //! @return True on success, false if the transfer is terminated or the calling thread is interrupted.
+    //!
+    bool push(const void* data, int dataSize);
+
+    //!
+    //! Declare the end of data, from any thread.
+    //! The transfer is properly closed when all queued data are transferred.
+    //!
+    void pushEnd();
+
+protected:
+    //!
+    //! Initialize the transfer.
+    //! Reimplemented from QtlDataPull.
+    //! @return True on success, false on error.
+    //!
+    virtual bool initializeTransfer() Q_DECL_OVERRIDE;
+
+    //!
+    //! Invoked when more data is needed.
+    //! Reimplemented from QtlDataPull.
+    //! @param [in] maxSize Maximum size in bytes of the requested transfer.
+    //! @return True on success, false on error.
+    //!
+    virtual bool needTransfer(qint64 maxSize) Q_DECL_OVERRIDE;
+
+    //!
+    //! Cleanup the transfer.
+    //! Reimplemented from QtlDataPull.
+    //! @param [in] closed If true, this is a clean termination.
+    //!
+    virtual void cleanupTransfer(bool closed) Q_DECL_OVERRIDE;
+
+private slots:
+    //!
+    //! Invoked in the thread of this object when data are pushed in an empty queue.
+    //!
+    void dataAvailable();
+
+private:
+    const qint64      _maxQueued;    //!< Maximum size of queued data.
+    QMutex            _mutex;        //!< Protect the following fields.
+    QWaitCondition    _notFull;      //!< Signaled when some queued data are transferred.
+    QList<QByteArray> _chunks;       //!< Queued data.
+    int               _chunkOffset;  //!< Number of bytes already transferred in first chunk.
+    qint64            _queuedSize;   //!< Total size of queued data.
+    bool              _ended;        //!< pushEnd() was called.
+    bool              _terminated;   //!< The transfer is terminated, no more data accepted.
+    bool              _notifyPosted; //!< dataAvailable() is posted for execution.
+
+    //!
+    //! Post an invocation of dataAvailable(), mutex must be held.
+    //!
+    void notifyLocked();
+
+    // Unaccessible operations.
+    Q_DISABLE_COPY(QtlThreadDataPull)
+};
+
+#endif // QTLTHREADDATAPULL_H
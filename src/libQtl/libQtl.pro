@@ -74,6 +74,9 @@ SOURCES += \
     QtlMediaStreamInfo.cpp \
     QtlDataPull.cpp \
     QtlFileDataPull.cpp \
+    QtlThreadDataPull.cpp \
+    QtlDataFanOut.cpp \
+    QtlFanOutDataPull.cpp \
     QtlLayoutUtils.cpp \
     QtlCheckableHeaderView.cpp \
     QtlFileDialogUtils.cpp \
@@ -148,6 +151,9 @@ HEADERS += \
     QtlStdoutLogger.h \
     QtlDataPull.h \
     QtlFileDataPull.h \
+    QtlThreadDataPull.h \
+    QtlDataFanOut.h \
+    QtlFanOutDataPull.h \
     QtlLayoutUtils.h \
     QtlCheckableHeaderView.h \
     QtlFileDialogUtils.h \
@@ -31,6 +31,7 @@
 //----------------------------------------------------------------------------
 
 #include "QtsDemux.h"
+#include "QtsDemuxHub.h"
 
 
 //----------------------------------------------------------------------------
@@ -40,12 +41,19 @@
 QtsDemux::QtsDemux(const QtsPidSet& pidFilter) :
     _packetCount(0),
     _lastPcr(-1),
-    _pidFilter(pidFilter)
+    _pidFilter(pidFilter),
+    _interrupted(false),
+    _hub(0),
+    _counters(this)
 {
 }
 
 QtsDemux::~QtsDemux()
 {
+    // Make sure the hub no longer references this demux.
+    if (_hub != 0) {
+        _hub->removeDemux(this);
+    }
 }
 
 
@@ -70,6 +78,66 @@ void QtsDemux::feedPacket(const QtsTsPacket& packet)
 }
 
 
+//-----------------------------------------------------------------------------
+// Feed the demux with a batch of contiguous TS packets.
+//-----------------------------------------------------------------------------
+
+int QtsDemux::feedPackets(const QtsTsPacket* packets, int count)
+{
+    // Packet counter before the batch.
+    const QtsPacketCounter base = _packetCount;
+
+    // Index of the last packet with a PCR, not yet decoded.
+    int pcrIndex = -1;
+
+    _interrupted = false;
+    int index = 0;
+    while (index < count && !_interrupted) {
+        const quint8* const b = packets[index].b;
+
+        // Same as QtsTsPacket::hasPcr(): adaptation field present, not empty, with PCR flag.
+        // Only remember the packet, the PCR is decoded when a filtered packet needs it.
+        if ((b[3] & 0x20) != 0 && b[4] != 0 && (b[5] & 0x10) != 0) {
+            pcrIndex = index;
+        }
+
+        // Same as QtsTsPacket::getPid(), process the packet if from a filtered PID.
+        if (_pidFilter[(QtsPid(b[1] & 0x1F) << 8) | QtsPid(b[2])]) {
+            // Make lastPcr() and packetCount() consistent for the handlers.
+            if (pcrIndex >= 0) {
+                _lastPcr = packets[pcrIndex].getPcr();
+                pcrIndex = -1;
+            }
+            _packetCount = base + index;
+            processTsPacket(packets[index]);
+        }
+        ++index;
+    }
+
+    // Final state after the batch.
+    if (pcrIndex >= 0) {
+        _lastPcr = packets[pcrIndex].getPcr();
+    }
+    _packetCount = base + index;
+    return index;
+}
+
+
+//----------------------------------------------------------------------------
+// Interrupt the current feedPackets().
+//----------------------------------------------------------------------------
+
+void QtsDemux::interruptFeed()
+{
+    if (_hub != 0) {
+        _hub->interruptFeed();
+    }
+    else {
+        _interrupted = true;
+    }
+}
+
+
 //-----------------------------------------------------------------------------
 // Set a completely new PID filter
 //-----------------------------------------------------------------------------
@@ -81,6 +149,9 @@ void QtsDemux::setPidFilter(const QtsPidSet& newPidFilter)
 
     // Set the new filter
     _pidFilter = newPidFilter;
+    if (_hub != 0) {
+        _hub->updatePidFilter();
+    }
 
     // Reset context of all removed PID's
     if (removedPids.any()) {
@@ -100,6 +171,9 @@ void QtsDemux::setPidFilter(const QtsPidSet& newPidFilter)
 void QtsDemux::addPid(QtsPid pid)
 {
     _pidFilter.set(pid);
+    if (_hub != 0) {
+        _hub->updatePidFilter();
+    }
 }
 
 
@@ -112,6 +186,9 @@ void QtsDemux::removePid(QtsPid pid)
     // If the PID was actually filtered, we need to reset the context
     if (_pidFilter[pid]) {
         _pidFilter.reset(pid);
+        if (_hub != 0) {
+            _hub->updatePidFilter();
+        }
         resetPid(pid);
     }
 }
@@ -38,6 +38,8 @@
 #include "QtsCore.h"
 #include "QtsTsPacket.h"
 
+class QtsDemuxHub;
+
 //!
 //! Abstract base class for transport stream demultiplexers.
 //!
@@ -62,6 +64,29 @@ public:
     //!
     void feedPacket(const QtsTsPacket& packet);
 
+    //!
+    //! Feed the demux with a batch of contiguous TS packets.
+    //! This is equivalent to calling feedPacket() on each packet but faster:
+    //! the PID filtering and the PCR detection are done directly on the packet
+    //! headers and the PCR values are decoded only when required. Packets from
+    //! PID's which are not in the PID filter cost almost nothing.
+    //! @param [in] packets Address of the first TS packet.
+    //! @param [in] count Number of TS packets.
+    //! @return The number of processed packets. This is less than @a count
+    //! when interruptFeed() was called during the processing of a packet.
+    //! @see interruptFeed()
+    //!
+    int feedPackets(const QtsTsPacket* packets, int count);
+
+    //!
+    //! Interrupt the current feedPackets().
+    //! Typically invoked by a handler which no longer needs packets.
+    //! The current packet is completely processed but the next packets in
+    //! the batch are ignored. When the demux is attached to a QtsDemuxHub,
+    //! the current feedPackets() of the hub is interrupted.
+    //!
+    void interruptFeed();
+
     //!
     //! Set the list of PID's to filter.
     //! @param [in] pidFilter Set of PID's to filter.
@@ -80,6 +105,15 @@ public:
     //!
     virtual void removePid(QtsPid pid);
 
+    //!
+    //! Get the set of PID's which are filtered by the demux.
+    //! @return A constant reference to the PID filter.
+    //!
+    const QtsPidSet& pidFilter() const
+    {
+        return _pidFilter;
+    }
+
     //!
     //! Get the number of PID's which are filtered by the demux.
     //! @return The number of PID's which are filtered by the demux.
@@ -108,16 +142,17 @@ public:
     //!
     qint64 lastPcr() const
     {
-        return _lastPcr;
+        return _counters->_lastPcr;
     }
 
     //!
     //! Get the number of process TS packets.
+    //! When the demux is attached to a QtsDemuxHub, this is the number of packets in the hub.
     //! @return The number of process TS packets.
     //!
     QtsPacketCounter packetCount() const
     {
-        return _packetCount;
+        return _counters->_packetCount;
     }
 
     //!
@@ -129,9 +164,14 @@ public:
     }
 
 private:
+    friend class QtsDemuxHub;
+
     QtsPacketCounter _packetCount; //!< Number of TS packets in demultiplexed stream.
     qint64           _lastPcr;     //!< Last PCR is any TS packet, any PID.
     QtsPidSet        _pidFilter;   //!< PIDs to filter.
+    bool             _interrupted; //!< Interrupt the current feedPackets().
+    QtsDemuxHub*     _hub;         //!< The hub which feeds this demux, if any.
+    const QtsDemux*  _counters;    //!< Where to get packetCount() and lastPcr(), this object or the hub.
 
     //!
     //! Feed the demux with a TS packet (PID already filtered).
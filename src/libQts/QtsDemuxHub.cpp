@@ -0,0 +1,181 @@
+//----------------------------------------------------------------------------
+//
+// Copyright (c) 2013-2017, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//
+// Qts, the Qt MPEG Transport Stream library.
+// Define the class QtsDemuxHub.
+//
+//----------------------------------------------------------------------------
+
+#include "QtsDemuxHub.h"
+
+
+//----------------------------------------------------------------------------
+// Constructor and destructor.
+//----------------------------------------------------------------------------
+
+QtsDemuxHub::QtsDemuxHub() :
+    QtsDemux(QtsNoPid),
+    _demuxes(),
+    _routes(),
+    _routesValid(true)
+{
+}
+
+QtsDemuxHub::~QtsDemuxHub()
+{
+    // Detach all demuxes.
+    foreach (QtsDemux* demux, _demuxes) {
+        demux->_hub = 0;
+        demux->_counters = demux;
+    }
+    _demuxes.clear();
+}
+
+
+//----------------------------------------------------------------------------
+// Attach and detach demuxes.
+//----------------------------------------------------------------------------
+
+bool QtsDemuxHub::addDemux(QtsDemux* demux)
+{
+    if (demux == 0 || demux == this || demux->_hub != 0) {
+        return false;
+    }
+    demux->_hub = this;
+    demux->_counters = this;
+    _demuxes.append(demux);
+    updatePidFilter();
+    return true;
+}
+
+void QtsDemuxHub::removeDemux(QtsDemux* demux)
+{
+    if (demux != 0 && demux->_hub == this) {
+        // Keep the stream counters of the hub in the demux.
+        demux->_packetCount = packetCount();
+        demux->_lastPcr = lastPcr();
+        demux->_hub = 0;
+        demux->_counters = demux;
+        _demuxes.removeAll(demux);
+        updatePidFilter();
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// The PID filter of the hub cannot be modified directly.
+//----------------------------------------------------------------------------
+
+void QtsDemuxHub::setPidFilter(const QtsPidSet& pidFilter)
+{
+    Q_UNUSED(pidFilter);
+}
+
+void QtsDemuxHub::addPid(QtsPid pid)
+{
+    Q_UNUSED(pid);
+}
+
+void QtsDemuxHub::removePid(QtsPid pid)
+{
+    Q_UNUSED(pid);
+}
+
+
+//----------------------------------------------------------------------------
+// Reset the analysis context of the hub and all attached demuxes.
+//----------------------------------------------------------------------------
+
+void QtsDemuxHub::reset()
+{
+    QtsDemux::reset();
+    foreach (QtsDemux* demux, _demuxes) {
+        demux->reset();
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Recompute the PID filter of the hub after a change in an attached demux.
+//----------------------------------------------------------------------------
+
+void QtsDemuxHub::updatePidFilter()
+{
+    QtsPidSet filter;
+    foreach (const QtsDemux* demux, _demuxes) {
+        filter |= demux->pidFilter();
+    }
+
+    // Don't rebuild the routes now, we may be called by a handler while a packet is routed.
+    QtsDemux::setPidFilter(filter);
+    _routesValid = false;
+}
+
+
+//----------------------------------------------------------------------------
+// Rebuild the routes from the PID filters of the attached demuxes.
+//----------------------------------------------------------------------------
+
+void QtsDemuxHub::buildRoutes()
+{
+    _routes.clear();
+    const QtsPidSet& filter(pidFilter());
+    for (QtsPid pid = 0; pid < QTS_PID_MAX; ++pid) {
+        if (filter[pid]) {
+            DemuxList& list(_routes[pid]);
+            foreach (QtsDemux* demux, _demuxes) {
+                if (demux->pidFilter()[pid]) {
+                    list.append(demux);
+                }
+            }
+        }
+    }
+    _routesValid = true;
+}
+
+
+//----------------------------------------------------------------------------
+// Route a TS packet to the attached demuxes.
+//----------------------------------------------------------------------------
+
+void QtsDemuxHub::processTsPacket(const QtsTsPacket& packet)
+{
+    if (!_routesValid) {
+        buildRoutes();
+    }
+
+    // Work on a copy of the list (implicitly shared, not copied), the routes
+    // can be rebuilt while the packet is processed by one demux.
+    const DemuxList* const route = _routes.find(packet.getPid());
+    if (route != 0) {
+        const DemuxList demuxes(*route);
+        foreach (QtsDemux* demux, demuxes) {
+            demux->processTsPacket(packet);
+        }
+    }
+}
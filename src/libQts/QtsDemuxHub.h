@@ -0,0 +1,156 @@
+//----------------------------------------------------------------------------
+//
+// Copyright (c) 2013-2017, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//!
+//! @file QtsDemuxHub.h
+//!
+//! Declare the class QtsDemuxHub.
+//! Qts, the Qt MPEG Transport Stream library.
+//!
+//----------------------------------------------------------------------------
+
+#ifndef QTSDEMUXHUB_H
+#define QTSDEMUXHUB_H
+
+#include "QtsDemux.h"
+#include "QtsPidContextTable.h"
+
+//!
+//! A demux which routes each TS packet to several other demuxes.
+//!
+//! Several analyses of the same transport stream (sections, PES packets, Teletext, etc.)
+//! can be performed in one single pass: the stream is fed into the hub and each packet
+//! is routed to all attached demuxes which filter its PID. A table, directly indexed by
+//! PID, gives the list of demuxes for each PID. This table is rebuilt only when the PID
+//! filter of an attached demux changes. Packets from PID's which are filtered by no demux
+//! cost only one bit lookup.
+//!
+//! The PID filter of the hub is the union of the PID filters of the attached demuxes.
+//! It cannot be modified directly. The attached demuxes report the packet counter and
+//! the last PCR of the hub, ie. of the complete stream.
+//!
+//! An attached demux must not be deleted by a handler while the hub processes a packet.
+//!
+class QtsDemuxHub : public QtsDemux
+{
+public:
+    //!
+    //! Constructor.
+    //!
+    QtsDemuxHub();
+
+    //!
+    //! Destructor.
+    //! All demuxes are detached.
+    //!
+    virtual ~QtsDemuxHub();
+
+    //!
+    //! Attach a demux to the hub.
+    //! A demux can be attached to one single hub at a time.
+    //! @param [in] demux The demux to attach. Not owned by the hub.
+    //! @return True on success, false if @a demux is null, the hub itself or already attached to a hub.
+    //!
+    bool addDemux(QtsDemux* demux);
+
+    //!
+    //! Detach a demux from the hub.
+    //! @param [in] demux The demux to detach.
+    //!
+    void removeDemux(QtsDemux* demux);
+
+    //!
+    //! Get the number of attached demuxes.
+    //! @return The number of attached demuxes.
+    //!
+    int demuxCount() const
+    {
+        return _demuxes.size();
+    }
+
+    //!
+    //! Set the list of PID's to filter.
+    //! Reimplemented from QtsDemux. Does nothing, the PID filter of the hub cannot be modified directly.
+    //! @param [in] pidFilter Ignored.
+    //!
+    virtual void setPidFilter(const QtsPidSet& pidFilter) Q_DECL_OVERRIDE;
+
+    //!
+    //! Add a PID to filter.
+    //! Reimplemented from QtsDemux. Does nothing, the PID filter of the hub cannot be modified directly.
+    //! @param [in] pid Ignored.
+    //!
+    virtual void addPid(QtsPid pid) Q_DECL_OVERRIDE;
+
+    //!
+    //! Remove a PID to filter.
+    //! Reimplemented from QtsDemux. Does nothing, the PID filter of the hub cannot be modified directly.
+    //! @param [in] pid Ignored.
+    //!
+    virtual void removePid(QtsPid pid) Q_DECL_OVERRIDE;
+
+    //!
+    //! Reset the analysis context of the hub and all attached demuxes.
+    //! Reimplemented from QtsDemux.
+    //!
+    virtual void reset() Q_DECL_OVERRIDE;
+
+private:
+    friend class QtsDemux;
+
+    //!
+    //! List of demuxes on one PID.
+    //!
+    typedef QList<QtsDemux*> DemuxList;
+
+    QList<QtsDemux*>              _demuxes;      //!< All attached demuxes.
+    QtsPidContextTable<DemuxList> _routes;       //!< Demuxes per PID.
+    bool                          _routesValid;  //!< The routes match the PID filters of the demuxes.
+
+    //!
+    //! Recompute the PID filter of the hub after a change in an attached demux.
+    //! The routes are rebuilt later, before processing the next packet.
+    //!
+    void updatePidFilter();
+
+    //!
+    //! Rebuild the routes from the PID filters of the attached demuxes.
+    //!
+    void buildRoutes();
+
+    //!
+    //! Route a TS packet to the attached demuxes.
+    //! Reimplemented from QtsDemux.
+    //! @param [in] packet The TS packet to process.
+    //!
+    virtual void processTsPacket(const QtsTsPacket& packet) Q_DECL_OVERRIDE;
+
+    // Unaccessible operations.
+    Q_DISABLE_COPY(QtsDemuxHub)
+};
+
+#endif // QTSDEMUXHUB_H
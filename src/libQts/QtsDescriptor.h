@@ -217,6 +217,6 @@ typedef QtlSmartPointer<QtsDescriptor,QtlNullMutexLocker> QtsDescriptorPtr;
 //!
 //! Smart pointer to a QtsDescriptor (thread-safe).
 //!
-typedef QtlSmartPointer<QtsDescriptor,QtlMutexLocker> QtsDescriptorSafePtr;
+typedef QtlSmartPointer<QtsDescriptor,QtlAtomicLocker> QtsDescriptorSafePtr;
 
 #endif // QTSDESCRIPTOR_H
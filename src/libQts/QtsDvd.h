@@ -54,6 +54,11 @@ static const int QTS_DVD_TRANSFER_RATE = 1385000;
 //!
 static const int QTS_DEFAULT_DVD_TRANSFER_SIZE = 512 * 1024;
 
+//!
+//! Default number of transfer chunks which are read in advance from a DVD media.
+//!
+static const int QTS_DVD_READ_AHEAD_CHUNKS = 8;
+
 //!
 //! Qts namespace.
 //!
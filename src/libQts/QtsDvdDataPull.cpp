@@ -71,12 +71,12 @@ QtsDvdDataPull::QtsDvdDataPull(const QString& deviceName,
     _deviceName(deviceName),
     _sectorList(sectorList),
     _badSectorPolicy(badSectorPolicy),
-    _sectorChunk(qMax(1, transferSize / QTS_DVD_SECTOR_SIZE)),
     _maxReadSpeed(useMaxReadSpeed),
-    _currentRange(_sectorList.begin()),
-    _nextSector(-1),
-    _buffer(_sectorChunk * QTS_DVD_SECTOR_SIZE),
-    _dvd(QString(), log),
+    _buffer(),
+    _bufferNext(0),
+    _bufferEnd(0),
+    _readAhead(transferSize, QTS_DVD_READ_AHEAD_CHUNKS, log),
+    _dvd(QString(), &_readAhead),
     _report(30000, log) // report transfer bandwidth every 30 seconds.
 {
     // Set total transfer size in bytes. In case of ignored bad sectors, the
@@ -88,6 +88,17 @@ QtsDvdDataPull::QtsDvdDataPull(const QString& deviceName,
 }
 
 
+//----------------------------------------------------------------------------
+// Destructor.
+//----------------------------------------------------------------------------
+
+QtsDvdDataPull::~QtsDvdDataPull()
+{
+    // The reader thread uses _dvd, which is destroyed before _readAhead.
+    _readAhead.stop();
+}
+
+
 //----------------------------------------------------------------------------
 // Initialize the transfer.
 //----------------------------------------------------------------------------
@@ -102,11 +113,9 @@ bool QtsDvdDataPull::initializeTransfer()
     // Start timers.
     _report.start();
 
-    // Set position to first sector to read.
-    _currentRange = _sectorList.begin();
-    _nextSector = -1;
-
-    return true;
+    // Start reading sectors in advance.
+    _bufferNext = _bufferEnd = 0;
+    return _readAhead.start(&_dvd, _sectorList, _badSectorPolicy);
 }
 
 
@@ -116,56 +125,37 @@ bool QtsDvdDataPull::initializeTransfer()
 
 bool QtsDvdDataPull::needTransfer(qint64 maxSize)
 {
-    // Move forward in sector list until we find something to read.
-    while (_currentRange != _sectorList.end()) {
-        if (_currentRange->isEmpty() || _nextSector > _currentRange->last()) {
-            // Empty range or already completely read, look at next one.
-            ++_currentRange;
-            _nextSector = -1;
+    // When the previous chunk is completely written, get the next one.
+    if (_bufferNext >= _bufferEnd) {
+        int requested = 0;
+        const int count = _readAhead.readChunk(_buffer, requested);
+        if (requested == 0) {
+            // End of sector list, the transfer is completed.
+            close();
+            return true;
         }
-        else if (_nextSector >= 0) {
-            // Currently in the middle of this range of sectors, continue reading.
-            break;
+        else if (count <= 0) {
+            // Read error.
+            return false;
         }
-        else {
-            // Current range of sectors not yet started, need to seek here.
-            log()->debug(tr("Starting transfer of DVD sectors %1").arg(_currentRange->toString()));
-            _nextSector = _currentRange->first();
-            if (!_dvd.seekSector(_nextSector)) {
-                return false;
-            }
-            break;
-        }
-    }
-
-    // Is the transfer completed?
-    if (_currentRange == _sectorList.end()) {
-        close();
-        return true;
+        _report.transfered(count);
+        _bufferNext = 0;
+        _bufferEnd = count * QTS_DVD_SECTOR_SIZE;
     }
 
-    Q_ASSERT(_currentRange->first() <= _currentRange->last());
-    Q_ASSERT(_nextSector >= _currentRange->first());
-    Q_ASSERT(_nextSector <= _currentRange->last());
-
-    // Compute maximum number of sectors to read.
-    int count = qMin<int>(_sectorChunk, _currentRange->last() - _nextSector + 1);
+    // Compute maximum number of bytes to write.
+    int size = _bufferEnd - _bufferNext;
     if (maxSize >= 0) {
-        count = qMin(count, int(maxSize / QTS_DVD_SECTOR_SIZE));
+        size = int(qMin<qint64>(size, maxSize));
     }
-    if (count <= 0) {
+    if (size <= 0) {
         return true;
     }
 
-    // Read sectors.
-    if ((count = _dvd.readSectors(_buffer.data(), count, -1, _badSectorPolicy)) <= 0) {
-        return false;
-    }
-    _nextSector += count;
-    _report.transfered(count);
-
     // Write sectors.
-    return write(_buffer.data(), count * QTS_DVD_SECTOR_SIZE);
+    const int start = _bufferNext;
+    _bufferNext += size;
+    return write(_buffer.data() + start, size);
 }
 
 
@@ -175,6 +165,7 @@ bool QtsDvdDataPull::needTransfer(qint64 maxSize)
 
 void QtsDvdDataPull::cleanupTransfer(bool clean)
 {
+    _readAhead.stop();
     _report.reportBandwidth();
     _dvd.close();
 }
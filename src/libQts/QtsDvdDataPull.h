@@ -39,12 +39,15 @@
 #include "QtlDataPull.h"
 #include "QtlByteBlock.h"
 #include "QtsDvdMedia.h"
+#include "QtsDvdReadAhead.h"
 #include "QtsDvdBandwidthReport.h"
 #include "QtsDvd.h"
 
 //!
 //! A class to pull data from an encrypted DVD into an asynchronous device such as QProcess.
+//! The DVD sectors are read in advance in a separate thread.
 //! @see QtlDataPull
+//! @see QtsDvdReadAhead
 //!
 class QtsDvdDataPull : public QtlDataPull
 {
@@ -101,6 +104,12 @@ public:
                    QObject* parent = 0,
                    bool useMaxReadSpeed = false);
 
+    //!
+    //! Destructor.
+    //! Stop reading the DVD in advance, if still running.
+    //!
+    virtual ~QtsDvdDataPull();
+
 protected:
     //!
     //! Initialize the transfer.
@@ -128,11 +137,11 @@ private:
     const QString               _deviceName;      //!< DVD device name.
     const QtlRangeList          _sectorList;      //!< List of sectors to read.
     const Qts::BadSectorPolicy  _badSectorPolicy; //!< How to handle bad sectors.
-    const int                   _sectorChunk;     //!< Number of sectors per transfer.
     const bool                  _maxReadSpeed;    //!< Set the DVD reader to maximum speed.
-    QtlRangeList::ConstIterator _currentRange;    //!< Current pointer in _sectorList.
-    int                         _nextSector;      //!< Next sector in _currentRange, -1 means at beginning.
-    QtlByteBlock                _buffer;          //!< Transfer buffer.
+    QtlByteBlock                _buffer;          //!< Transfer buffer, swapped with read-ahead chunks.
+    int                         _bufferNext;      //!< Index in _buffer of next byte to write.
+    int                         _bufferEnd;       //!< Index in _buffer after last valid byte.
+    QtsDvdReadAhead             _readAhead;       //!< Read DVD sectors in advance. Also used as logger for _dvd.
     QtsDvdMedia                 _dvd;             //!< Access to DVD media.
     QtsDvdBandwidthReport       _report;          //!< To report transfer bandwidth.
 
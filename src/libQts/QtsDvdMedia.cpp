@@ -67,6 +67,12 @@
 #define DVD_ROOTDIRDESC_SIZE                34
 #define DVD_BAD_SECTOR_RETRY                64
 
+//
+// Persistent cache of DVD encryption keys.
+//
+bool QtsDvdMedia::_keyCacheSet = false;
+QString QtsDvdMedia::_keyCacheDirectory;
+
 
 //----------------------------------------------------------------------------
 // Constructor & destructor.
@@ -85,6 +91,7 @@ QtsDvdMedia::QtsDvdMedia(const QString& fileName, QtlLogger* log, QObject* paren
     _dvdcss(0),
     _nextSector(0),
     _rootDirectory(),
+    _badSectors(),
     _allFiles(),
     _currentFile(_allFiles.end())
 {
@@ -214,6 +221,23 @@ bool QtsDvdMedia::openFromDevice(const QString& deviceName, bool useMaxReadSpeed
 {
     // Close previous media if necessary.
     close();
+    _badSectors.clear();
+
+    // Configure the cache of encryption keys. libdvdcss reads it when the device is open.
+    // libdvdcss creates only the last level of the cache directory, create all parents.
+    // If the directory cannot be created, fall back to the default cache of libdvdcss.
+    if (_keyCacheSet) {
+        if (_keyCacheDirectory.isEmpty()) {
+            qputenv("DVDCSS_CACHE", QByteArray("off"));
+        }
+        else if (QDir().mkpath(_keyCacheDirectory)) {
+            qputenv("DVDCSS_CACHE", QFile::encodeName(_keyCacheDirectory));
+        }
+        else {
+            _log->line(tr("Cannot create DVD key cache %1, using default cache").arg(_keyCacheDirectory));
+            qunsetenv("DVDCSS_CACHE");
+        }
+    }
 
     // Initialize libdvdcss.
     const QByteArray name(deviceName.toUtf8());
@@ -458,6 +482,7 @@ int QtsDvdMedia::readSectors(void* buffer, int count, int position, Qts::BadSect
             // Let's ignore it if we can explicitly seek to next sector.
             if (dvdcss_seek(_dvdcss, _nextSector + 1, seekFlags) > 0) {
                 badSectorMax--;
+                addBadSector(_nextSector);
                 switch (badSectorPolicy) {
                     case Qts::SkipBadSectors:
                         got = 0;
@@ -490,6 +515,58 @@ int QtsDvdMedia::readSectors(void* buffer, int count, int position, Qts::BadSect
 }
 
 
+//----------------------------------------------------------------------------
+// Persistent cache of DVD encryption keys.
+//----------------------------------------------------------------------------
+
+void QtsDvdMedia::setKeyCacheDirectory(const QString& directory)
+{
+    _keyCacheSet = true;
+    _keyCacheDirectory = directory;
+}
+
+bool QtsDvdMedia::purgeKeyCache(const QString& directory, QtlLogger* log)
+{
+    QtlNullLogger nullLog;
+    if (log == 0) {
+        log = &nullLog;
+    }
+
+    if (directory.isEmpty()) {
+        log->line(tr("No DVD key cache directory"));
+        return false;
+    }
+    else if (!QDir(directory).exists()) {
+        // Nothing to purge if the cache was never created.
+        log->line(tr("DVD key cache %1 is already empty").arg(directory));
+        return true;
+    }
+    else if (QDir(directory).removeRecursively()) {
+        log->line(tr("Purged DVD key cache %1").arg(directory));
+        return true;
+    }
+    else {
+        log->line(tr("Error purging DVD key cache %1").arg(directory));
+        return false;
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Record a bad sector.
+//----------------------------------------------------------------------------
+
+void QtsDvdMedia::addBadSector(int sector)
+{
+    if (!_badSectors.isEmpty() && _badSectors.last().last() + 1 == sector) {
+        _badSectors.last().setLast(sector);
+    }
+    else {
+        _badSectors << QtlRange(sector, sector);
+    }
+}
+
+
 //----------------------------------------------------------------------------
 // Read the file structure under the specified directory.
 //----------------------------------------------------------------------------
@@ -37,6 +37,7 @@
 #define QTSDVDMEDIA_H
 
 #include "QtlNullLogger.h"
+#include "QtlRangeList.h"
 #include "QtsDvdDirectory.h"
 #include "QtsDvd.h"
 
@@ -178,6 +179,16 @@ public:
     //!
     int readSectors(void *buffer, int count, int position = -1, Qts::BadSectorPolicy badSectorPolicy = Qts::SkipBadSectors);
 
+    //!
+    //! Get the list of bad sectors which were skipped or replaced by zeroes.
+    //! The list is cleared when a new media is open, it remains available after close().
+    //! @return The list of bad sectors, in reading order, adjacent sectors are merged in one range.
+    //!
+    QtlRangeList badSectors() const
+    {
+        return _badSectors;
+    }
+
     //!
     //! Get the number of Video Title Sets (VTS) on the DVD.
     //! @return The number of Video Title Sets (VTS) on the DVD.
@@ -266,6 +277,37 @@ public:
     //!
     bool loadAllEncryptionKeys();
 
+    //!
+    //! Set the directory of the persistent cache of DVD encryption keys.
+    //! This is a global setting which applies to all DVD media which are open later.
+    //! libdvdcss creates one subdirectory per DVD, named after the volume id, the
+    //! manufacturing date and the serial number of the disc. Re-opening a known DVD
+    //! reuses the title keys from the cache. Unless this method is called,
+    //! the default cache of libdvdcss is used.
+    //! @param [in] directory Cache directory. If empty, the cache of keys is disabled.
+    //!
+    static void setKeyCacheDirectory(const QString& directory);
+
+    //!
+    //! Get the directory of the persistent cache of DVD encryption keys.
+    //! @return The cache directory or an empty string if the cache is disabled or not configured.
+    //! @see setKeyCacheDirectory()
+    //!
+    static QString keyCacheDirectory()
+    {
+        return _keyCacheDirectory;
+    }
+
+    //!
+    //! Purge a persistent cache of DVD encryption keys.
+    //! The cache may be purged even if it is currently disabled in setKeyCacheDirectory().
+    //! @param [in] directory Cache directory to purge.
+    //! @param [in] log Optional message logger.
+    //! @return True on success, false on error.
+    //! @see setKeyCacheDirectory()
+    //!
+    static bool purgeKeyCache(const QString& directory, QtlLogger* log = 0);
+
 signals:
     //!
     //! Emitted when a new DVD media is open.
@@ -290,8 +332,17 @@ private:
     struct dvdcss_s* _dvdcss;        //!< Handle to libdvdcss (don't include dvdcss.h in this .h).
     int              _nextSector;    //!< Next sector to read.
     QtsDvdDirectory  _rootDirectory; //!< Description of root directory.
+    QtlRangeList     _badSectors;    //!< Bad sectors which were skipped or replaced by zeroes.
     QList<QtsDvdFilePtr> _allFiles;  //!< List of all files on DVD.
     QList<QtsDvdFilePtr>::ConstIterator _currentFile; //!< File area where _nextSector is.
+    static bool      _keyCacheSet;       //!< The cache of keys was configured by the application.
+    static QString   _keyCacheDirectory; //!< Cache directory of keys, empty if disabled.
+
+    //!
+    //! Record a bad sector in _badSectors.
+    //! @param [in] sector Bad sector index.
+    //!
+    void addBadSector(int sector);
 
     //!
     //! Read the file structure under the specified directory.
@@ -57,8 +57,12 @@ QtsDvdProgramChainDemux::QtsDvdProgramChainDemux(const QtsDvdTitleSet& vts,
     _maxReadSpeed(useMaxReadSpeed),
     _vobStartSector(-1),
     _buffer(_sectorChunk * QTS_DVD_SECTOR_SIZE),
+    _bufferNext(0),
+    _bufferEnd(0),
+    _bufferRequested(0),
     _inputSectors(log()),
-    _dvd(QString(), log()),
+    _readAhead(transferSize, QTS_DVD_READ_AHEAD_CHUNKS, log()),
+    _dvd(QString(), &_readAhead),
     _vobs(_vts.vobFileNames(), log()),
     _report(30000, log()),  // report transfer bandwidth every 30 seconds.
     _inPgcContent(false),
@@ -81,6 +85,17 @@ QtsDvdProgramChainDemux::QtsDvdProgramChainDemux(const QtsDvdTitleSet& vts,
 }
 
 
+//----------------------------------------------------------------------------
+// Destructor.
+//----------------------------------------------------------------------------
+
+QtsDvdProgramChainDemux::~QtsDvdProgramChainDemux()
+{
+    // The reader thread uses _dvd, which is destroyed before _readAhead.
+    _readAhead.stop();
+}
+
+
 //----------------------------------------------------------------------------
 // Initialize the transfer.
 //----------------------------------------------------------------------------
@@ -105,6 +120,7 @@ bool QtsDvdProgramChainDemux::initializeTransfer()
     // VOB/cell ids, it will be set to false.
     _inPgcContent = true;
     _writtenSectors = 0;
+    _bufferNext = _bufferEnd = _bufferRequested = 0;
 
     // Open the input media.
     if (_vts.isEncrypted()) {
@@ -121,6 +137,22 @@ bool QtsDvdProgramChainDemux::initializeTransfer()
 
         // Start bandwidth reporting (do that only on DVD media, not on files).
         _report.start();
+
+        // Build the list of sectors on DVD media, in the order of the cells,
+        // and start reading them in advance.
+        QtlRangeList sectors;
+        foreach (const QtsDvdProgramCellPtr& cell, _pgc->cells()) {
+            if (!cell.isNull()) {
+                foreach (const QtlRange& range, cell->sectors()) {
+                    if (!range.isEmpty()) {
+                        sectors << QtlRange(_vobStartSector + range.first(), _vobStartSector + range.last());
+                    }
+                }
+            }
+        }
+        if (!_readAhead.start(&_dvd, sectors, Qts::SkipBadSectors)) {
+            return false;
+        }
     }
 
     return true;
@@ -133,17 +165,26 @@ bool QtsDvdProgramChainDemux::initializeTransfer()
 
 bool QtsDvdProgramChainDemux::needTransfer(qint64 maxSize)
 {
-    // Get next sector to read.
-    const int sectorAddress = _inputSectors.currentSectorAddress();
+    // When the previous chunk of sectors is completely demuxed, read the next one.
+    if (_bufferNext >= _bufferEnd) {
+        // Move forward within input list of sectors.
+        _inputSectors.advance(_bufferRequested);
+        _bufferNext = _bufferEnd = _bufferRequested = 0;
+
+        // Is the transfer completed?
+        if (_inputSectors.currentSectorAddress() < 0) {
+            close();
+            return true;
+        }
 
-    // Is the transfer completed?
-    if (sectorAddress < 0) {
-        close();
-        return true;
+        // Read sectors.
+        if (!readChunk()) {
+            return false;
+        }
     }
 
-    // Maximum number of contiguous sectors to read.
-    int sectorCount = qMin(_sectorChunk, _inputSectors.currentSectorCount());
+    // Maximum number of sectors to demux from the current chunk.
+    int sectorCount = _bufferEnd - _bufferNext;
     if (maxSize >= 0) {
         sectorCount = qMin(sectorCount, int(maxSize / QTS_DVD_SECTOR_SIZE));
     }
@@ -151,33 +192,46 @@ bool QtsDvdProgramChainDemux::needTransfer(qint64 maxSize)
         return sectorCount;
     }
 
-    // Read sectors.
+    // Demux buffer content.
+    const int firstSector = _bufferNext;
+    _bufferNext += sectorCount;
+    return demuxBuffer(firstSector, sectorCount);
+}
+
+
+//----------------------------------------------------------------------------
+// Read the next chunk of sectors in the buffer.
+//----------------------------------------------------------------------------
+
+bool QtsDvdProgramChainDemux::readChunk()
+{
+    int sectorCount = 0;
+
     if (_vobStartSector >= 0) {
-        // Reading DVD media. Compute logical sector address on DVD media.
-        const int lba = _vobStartSector + sectorAddress;
-        // Seek (if required) and read.
-        sectorCount = _dvd.readSectors(_buffer.data(), sectorCount, (lba == _dvd.nextSector() ? -1 : lba), Qts::SkipBadSectors);
+        // Reading DVD media. The chunks come in the same order as the input
+        // sectors, get the next one from the read-ahead thread.
+        sectorCount = _readAhead.readChunk(_buffer, _bufferRequested);
+        if (_bufferRequested <= 0) {
+            log()->line(tr("Unexpected end of DVD sectors"));
+            return false;
+        }
     }
     else {
-        // Reading VOB files.
-        sectorCount = _vobs.read(sectorAddress, _buffer.data(), sectorCount);
+        // Reading VOB files. Maximum number of contiguous sectors to read.
+        sectorCount = qMin(_sectorChunk, _inputSectors.currentSectorCount());
+        sectorCount = _vobs.read(_inputSectors.currentSectorAddress(), _buffer.data(), sectorCount);
+        _bufferRequested = sectorCount;
     }
 
     // Read status?
-    bool success = sectorCount > 0;
-
-    if (success) {
-        // Successful read. Report transfered data size.
-        _report.transfered(sectorCount);
-
-        // Demux buffer content.
-        success = demuxBuffer(sectorCount);
-
-        // Move forward within input list of sectors.
-        _inputSectors.advance(sectorCount);
+    if (sectorCount <= 0) {
+        return false;
     }
 
-    return success;
+    // Successful read. Report transfered data size.
+    _report.transfered(sectorCount);
+    _bufferEnd = sectorCount;
+    return true;
 }
 
 
@@ -187,6 +241,9 @@ bool QtsDvdProgramChainDemux::needTransfer(qint64 maxSize)
 
 void QtsDvdProgramChainDemux::cleanupTransfer(bool clean)
 {
+    // Stop reading in advance.
+    _readAhead.stop();
+
     // Final bandwidth report.
     _report.reportBandwidth();
 
@@ -206,10 +263,11 @@ void QtsDvdProgramChainDemux::cleanupTransfer(bool clean)
 // Demux the sectors in the buffer, write demuxed sectors to superclass.
 //----------------------------------------------------------------------------
 
-bool QtsDvdProgramChainDemux::demuxBuffer(int sectorCount)
+bool QtsDvdProgramChainDemux::demuxBuffer(int firstSector, int sectorCount)
 {
-    // End of read sectors in buffers.
-    const int bufferEnd = sectorCount * QTS_DVD_SECTOR_SIZE;
+    // Range of sectors to demux in buffer.
+    const int bufferStart = firstSector * QTS_DVD_SECTOR_SIZE;
+    const int bufferEnd = (firstSector + sectorCount) * QTS_DVD_SECTOR_SIZE;
     Q_ASSERT(bufferEnd <= _buffer.size());
 
     // Original VOB id and cell id in the current cell.
@@ -217,8 +275,13 @@ bool QtsDvdProgramChainDemux::demuxBuffer(int sectorCount)
     int cellId = 0;
     _inputSectors.getCurrentOriginalIds(vobId, cellId);
 
+    // Start of current run of contiguous sectors to write. Navigation packs
+    // are fixed in place, so all kept sectors in a run are contiguous in
+    // the buffer and the run is written at once.
+    int runStart = bufferStart;
+
     // Now process all sectors one by one.
-    for (int sectorStart = 0; sectorStart < bufferEnd; sectorStart += QTS_DVD_SECTOR_SIZE) {
+    for (int sectorStart = bufferStart; sectorStart < bufferEnd; sectorStart += QTS_DVD_SECTOR_SIZE) {
 
         // A VOB sector is an MPEG-2 program stream pack (ISO 13818-1, §2.5.3.3).
         // The pack header is 14 bytes long, followed by a PES packet.
@@ -226,6 +289,7 @@ bool QtsDvdProgramChainDemux::demuxBuffer(int sectorCount)
         // Check that the start code is correct.
         if (_buffer.fromBigEndian<quint32>(sectorStart) != 0x000001BA) {
             log()->line(tr("Invalid pack start code encountered"));
+            writeRun(runStart, sectorStart);
             return false;
         }
 
@@ -266,17 +330,31 @@ bool QtsDvdProgramChainDemux::demuxBuffer(int sectorCount)
             }
         }
 
-        // Write sectors which are part of the PGC content.
+        // Keep sectors which are part of the PGC content in the current run.
+        // When a sector is dropped, write the run of sectors before it.
         if (_inPgcContent && (!isNavPack || _demuxPolicy != Qts::NavPacksRemoved)) {
-            if (!write(&_buffer[sectorStart], QTS_DVD_SECTOR_SIZE)) {
+            ++_writtenSectors;
+        }
+        else {
+            if (!writeRun(runStart, sectorStart)) {
                 return false;
             }
-            ++_writtenSectors;
+            runStart = sectorStart + QTS_DVD_SECTOR_SIZE;
         }
     }
 
-    // Success.
-    return true;
+    // Write the last run of sectors.
+    return writeRun(runStart, bufferEnd);
+}
+
+
+//----------------------------------------------------------------------------
+// Write a run of contiguous sectors from the buffer.
+//----------------------------------------------------------------------------
+
+bool QtsDvdProgramChainDemux::writeRun(int start, int end)
+{
+    return start >= end || write(&_buffer[start], end - start);
 }
 
 
@@ -40,12 +40,15 @@
 #include "QtlByteBlock.h"
 #include "QtsDvdTitleSet.h"
 #include "QtsDvdBandwidthReport.h"
+#include "QtsDvdReadAhead.h"
 #include "QtsDvd.h"
 
 //!
 //! A class to demultiplex a Program Chain (PGC) from a DVD Video Title Set (VTS).
 //! This class pulls data from either an encrypted DVD or regular VTS files into asynchronous devices such as QProcess.
+//! On DVD media, the sectors are read in advance in a separate thread.
 //! @see QtlDataPull
+//! @see QtsDvdReadAhead
 //!
 class QtsDvdProgramChainDemux : public QtlDataPull
 {
@@ -81,6 +84,12 @@ public:
                             QObject* parent = 0,
                             bool useMaxReadSpeed = false);
 
+    //!
+    //! Destructor.
+    //! Stop reading the DVD in advance, if still running.
+    //!
+    virtual ~QtsDvdProgramChainDemux();
+
 protected:
     //!
     //! Initialize the transfer.
@@ -105,12 +114,27 @@ protected:
     virtual void cleanupTransfer(bool clean) Q_DECL_OVERRIDE;
 
 private:
+    //!
+    //! Read the next chunk of sectors in the buffer.
+    //! @return True on success, false on error.
+    //!
+    bool readChunk();
+
     //!
     //! Demux the sectors in the buffer, write demuxed sectors to superclass.
+    //! @param [in] firstSector Index of first sector to demux in buffer.
     //! @param [in] sectorCount Number of sectors to demux in buffer.
     //! @return True on success, false on error.
     //!
-    bool demuxBuffer(int sectorCount);
+    bool demuxBuffer(int firstSector, int sectorCount);
+
+    //!
+    //! Write a run of contiguous sectors from the buffer to superclass.
+    //! @param [in] start Index in buffer of the first byte to write.
+    //! @param [in] end Index in buffer after the last byte to write.
+    //! @return True on success, false on error.
+    //!
+    bool writeRun(int start, int end);
 
     //!
     //! A class which is used to read from VOB files.
@@ -212,7 +236,11 @@ private:
     const bool             _maxReadSpeed;    //!< Set the DVD reader to maximum speed.
     int                    _vobStartSector;  //!< First sector of VOB files on DVD media.
     QtlByteBlock           _buffer;          //!< Transfer buffer.
+    int                    _bufferNext;      //!< Index in _buffer of next sector to demux.
+    int                    _bufferEnd;       //!< Index in _buffer after last read sector.
+    int                    _bufferRequested; //!< Number of input sectors which were requested to fill _buffer.
     InputSectors           _inputSectors;    //!< Computation of input sectors to read.
+    QtsDvdReadAhead        _readAhead;       //!< Read DVD sectors in advance. Also used as logger for _dvd.
     QtsDvdMedia            _dvd;             //!< Access through DVD media.
     VobFileSet             _vobs;            //!< Access through VOB files.
     QtsDvdBandwidthReport  _report;          //!< To report transfer bandwidth.
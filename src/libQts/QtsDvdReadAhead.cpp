@@ -0,0 +1,264 @@
+//----------------------------------------------------------------------------
+//
+// Copyright (c) 2013-2017, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//
+// Qts, the Qt MPEG Transport Stream library.
+// Define the class QtsDvdReadAhead.
+//
+//----------------------------------------------------------------------------
+
+#include "QtsDvdReadAhead.h"
+
+
+//----------------------------------------------------------------------------
+// Constructor and destructor.
+//----------------------------------------------------------------------------
+
+QtsDvdReadAhead::QtsDvdReadAhead(int transferSize, int chunkCount, QtlLogger* log, QObject* parent) :
+    QObject(parent),
+    _nullLog(),
+    _log(log != 0 ? log : &_nullLog),
+    _chunkSectors(qMax(1, transferSize / QTS_DVD_SECTOR_SIZE)),
+    _thread(this),
+    _dvd(0),
+    _sectorList(),
+    _badSectorPolicies(),
+    _mutex(),
+    _chunkFilled(),
+    _chunkFreed(),
+    _chunks(qMax(2, chunkCount)),
+    _readIndex(0),
+    _filledCount(0),
+    _endOfList(true)
+{
+}
+
+QtsDvdReadAhead::~QtsDvdReadAhead()
+{
+    stop();
+}
+
+
+//----------------------------------------------------------------------------
+// Start reading in the reader thread.
+//----------------------------------------------------------------------------
+
+bool QtsDvdReadAhead::start(QtsDvdMedia* dvd, const QtlRangeList& sectorList, Qts::BadSectorPolicy badSectorPolicy)
+{
+    QList<Qts::BadSectorPolicy> policies;
+    for (int i = 0; i < sectorList.size(); ++i) {
+        policies << badSectorPolicy;
+    }
+    return start(dvd, sectorList, policies);
+}
+
+bool QtsDvdReadAhead::start(QtsDvdMedia* dvd, const QtlRangeList& sectorList, const QList<Qts::BadSectorPolicy>& badSectorPolicies)
+{
+    if (dvd == 0 || _thread.isRunning() || badSectorPolicies.size() != sectorList.size()) {
+        return false;
+    }
+
+    _dvd = dvd;
+    _sectorList = sectorList;
+    _badSectorPolicies = badSectorPolicies;
+    _readIndex = 0;
+    _filledCount = 0;
+    _endOfList = false;
+
+    _thread.start();
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Stop the reader thread and wait for its termination.
+//----------------------------------------------------------------------------
+
+void QtsDvdReadAhead::stop()
+{
+    if (!inReaderThread() && _thread.isRunning()) {
+        _thread.requestInterruption();
+        {
+            // Wake up the reader thread if it waits for a free chunk.
+            QMutexLocker lock(&_mutex);
+            _chunkFreed.wakeAll();
+        }
+        _thread.wait();
+    }
+
+    // Drop all unread chunks.
+    QMutexLocker lock(&_mutex);
+    _filledCount = 0;
+    _endOfList = true;
+}
+
+
+//----------------------------------------------------------------------------
+// Get the next chunk of sectors.
+//----------------------------------------------------------------------------
+
+int QtsDvdReadAhead::readChunk(QtlByteBlock& buffer, int& requestedCount)
+{
+    QMutexLocker lock(&_mutex);
+
+    // Wait for the reader thread to fill a chunk.
+    while (_filledCount == 0 && !_endOfList) {
+        _chunkFilled.wait(&_mutex);
+    }
+
+    // End of sector list, or error in previous chunk.
+    if (_filledCount == 0) {
+        requestedCount = 0;
+        return 0;
+    }
+
+    // Swap the chunk buffer with the caller's one. The caller's buffer
+    // is recycled in the ring and will be filled later by the reader thread.
+    Chunk& chunk(_chunks[_readIndex]);
+    buffer.swap(chunk.data);
+    requestedCount = chunk.requested;
+    const int count = chunk.count;
+
+    // Give the chunk back to the reader thread.
+    _readIndex = (_readIndex + 1) % _chunks.size();
+    _filledCount--;
+    _chunkFreed.wakeAll();
+
+    return count;
+}
+
+
+//----------------------------------------------------------------------------
+// Read all sectors, executed in the reader thread.
+//----------------------------------------------------------------------------
+
+void QtsDvdReadAhead::readSectors()
+{
+    int writeIndex = 0;
+    bool success = true;
+
+    for (int index = 0; success && index < _sectorList.size(); ++index) {
+
+        const QtlRange& range(_sectorList[index]);
+        const Qts::BadSectorPolicy badSectorPolicy = _badSectorPolicies[index];
+
+        if (!range.isEmpty()) {
+            debug(tr("Starting transfer of DVD sectors %1").arg(range.toString()));
+        }
+
+        // Read the range chunk by chunk.
+        for (qint64 sector = range.first(); success && !range.isEmpty() && sector <= range.last(); ) {
+
+            // Wait for a free chunk in the ring.
+            {
+                QMutexLocker lock(&_mutex);
+                while (_filledCount >= _chunks.size() && !_thread.isInterruptionRequested()) {
+                    _chunkFreed.wait(&_mutex);
+                }
+            }
+            if (_thread.isInterruptionRequested()) {
+                success = false;
+                break;
+            }
+
+            // The chunk at writeIndex is free, it is not accessed by the consumer
+            // until we declare it filled. We can access it without lock.
+            Chunk& chunk(_chunks[writeIndex]);
+            const int requested = int(qMin<qint64>(_chunkSectors, range.last() - sector + 1));
+            chunk.data.resize(requested * QTS_DVD_SECTOR_SIZE);
+            chunk.requested = requested;
+            chunk.count = _dvd->readSectors(chunk.data.data(), requested, sector == _dvd->nextSector() ? -1 : int(sector), badSectorPolicy);
+
+            // Stop on read error. The chunk is still delivered to the consumer to report the error.
+            success = chunk.count > 0;
+            sector += requested;
+
+            // Declare the chunk as filled.
+            {
+                QMutexLocker lock(&_mutex);
+                _filledCount++;
+                _chunkFilled.wakeAll();
+            }
+            writeIndex = (writeIndex + 1) % _chunks.size();
+        }
+    }
+
+    // Notify the end of reading to the consumer.
+    QMutexLocker lock(&_mutex);
+    _endOfList = true;
+    _chunkFilled.wakeAll();
+}
+
+
+//----------------------------------------------------------------------------
+// Logging, can be invoked from the reader thread.
+//----------------------------------------------------------------------------
+
+void QtsDvdReadAhead::text(const QString& text)
+{
+    if (inReaderThread()) {
+        QMetaObject::invokeMethod(this, "logFromThread", Qt::QueuedConnection, Q_ARG(int, 0), Q_ARG(QString, text), Q_ARG(QColor, QColor()));
+    }
+    else {
+        _log->text(text);
+    }
+}
+
+void QtsDvdReadAhead::line(const QString& line, const QColor& color)
+{
+    if (inReaderThread()) {
+        QMetaObject::invokeMethod(this, "logFromThread", Qt::QueuedConnection, Q_ARG(int, 1), Q_ARG(QString, line), Q_ARG(QColor, color));
+    }
+    else {
+        _log->line(line, color);
+    }
+}
+
+void QtsDvdReadAhead::debug(const QString& line, const QColor& color)
+{
+    if (inReaderThread()) {
+        QMetaObject::invokeMethod(this, "logFromThread", Qt::QueuedConnection, Q_ARG(int, 2), Q_ARG(QString, line), Q_ARG(QColor, color));
+    }
+    else {
+        _log->debug(line, color);
+    }
+}
+
+void QtsDvdReadAhead::logFromThread(int type, const QString& line, const QColor& color)
+{
+    switch (type) {
+    case 0:
+        _log->text(line);
+        break;
+    case 1:
+        _log->line(line, color);
+        break;
+    default:
+        _log->debug(line, color);
+        break;
+    }
+}
@@ -0,0 +1,231 @@
+//----------------------------------------------------------------------------
+//
+// Copyright (c) 2013-2017, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//!
+//! @file QtsDvdReadAhead.h
+//!
+//! Declare the class QtsDvdReadAhead.
+//! Qts, the Qt MPEG Transport Stream library.
+//!
+//----------------------------------------------------------------------------
+
+#ifndef QTSDVDREADAHEAD_H
+#define QTSDVDREADAHEAD_H
+
+#include <QtCore>
+#include "QtlLogger.h"
+#include "QtlNullLogger.h"
+#include "QtlByteBlock.h"
+#include "QtlRangeList.h"
+#include "QtsDvdMedia.h"
+#include "QtsDvd.h"
+
+//!
+//! A class which reads DVD sectors ahead of their consumption in a separate thread.
+//!
+//! A reader thread reads a list of sector ranges from a DVD media into a ring
+//! of chunks. The consumer picks the filled chunks one by one using readChunk().
+//! The chunk buffers are swapped with the buffer of the consumer, the data are
+//! never copied. Thus, the DVD drive keeps reading while the consumer processes
+//! the previous chunks.
+//!
+//! While the reader thread is running, the QtsDvdMedia object shall not be used
+//! by anyone else. To get messages from the media object in the right thread,
+//! the media object should use the QtsDvdReadAhead object as logger. Messages
+//! which are logged from the reader thread are forwarded to the thread of this object.
+//!
+class QtsDvdReadAhead : public QObject, public QtlLogger
+{
+    Q_OBJECT
+
+public:
+    //!
+    //! Constructor.
+    //! @param [in] transferSize Size in bytes of each chunk of sectors.
+    //! @param [in] chunkCount Number of chunks in the ring, ie. number of chunks which are read in advance.
+    //! @param [in] log Optional message logger.
+    //! @param [in] parent Optional parent object.
+    //!
+    explicit QtsDvdReadAhead(int transferSize = QTS_DEFAULT_DVD_TRANSFER_SIZE,
+                             int chunkCount = QTS_DVD_READ_AHEAD_CHUNKS,
+                             QtlLogger* log = 0,
+                             QObject* parent = 0);
+
+    //!
+    //! Destructor.
+    //! Stop the reader thread if still running.
+    //!
+    virtual ~QtsDvdReadAhead();
+
+    //!
+    //! Start reading in the reader thread.
+    //! @param [in] dvd DVD media to read. Must be open. It must not be used by the
+    //! caller until the reader thread is stopped or all chunks are read.
+    //! @param [in] sectorList List of sector ranges to read. A chunk never spans two ranges.
+    //! @param [in] badSectorPolicy How to handle bad sectors.
+    //! @return True on success, false on error.
+    //!
+    bool start(QtsDvdMedia* dvd, const QtlRangeList& sectorList, Qts::BadSectorPolicy badSectorPolicy = Qts::SkipBadSectors);
+
+    //!
+    //! Start reading in the reader thread, using a distinct bad sector policy per range.
+    //! @param [in] dvd DVD media to read. Must be open. It must not be used by the
+    //! caller until the reader thread is stopped or all chunks are read.
+    //! @param [in] sectorList List of sector ranges to read. A chunk never spans two ranges.
+    //! @param [in] badSectorPolicies How to handle bad sectors, one value per range in @a sectorList.
+    //! @return True on success, false on error.
+    //!
+    bool start(QtsDvdMedia* dvd, const QtlRangeList& sectorList, const QList<Qts::BadSectorPolicy>& badSectorPolicies);
+
+    //!
+    //! Stop the reader thread and wait for its termination.
+    //! Unread chunks are dropped.
+    //!
+    void stop();
+
+    //!
+    //! Get the next chunk of sectors, wait for the reader thread if necessary.
+    //! @param [in,out] buffer A buffer which is swapped with the buffer of the chunk.
+    //! On return, it contains the data of the chunk. On input, its previous content
+    //! is recycled in the ring. Its size can change.
+    //! @param [out] requestedCount Number of sectors which were requested from the media
+    //! for this chunk. Zero at end of sector list.
+    //! @return Number of sectors which were actually read in @a buffer. With some bad
+    //! sector policies, this can be less than @a requestedCount. When @a requestedCount
+    //! is not zero, a zero or negative value means a read error.
+    //!
+    int readChunk(QtlByteBlock& buffer, int& requestedCount);
+
+    //!
+    //! Log text.
+    //! Reimplemented from QtlLogger, can be invoked from the reader thread.
+    //! @param [in] text Text to log.
+    //!
+    virtual void text(const QString& text) Q_DECL_OVERRIDE;
+
+    //!
+    //! Log a line of text.
+    //! Reimplemented from QtlLogger, can be invoked from the reader thread.
+    //! @param [in] line Line to log. No need to contain a trailing new-line character.
+    //! @param [in] color When a valid color is passed, try to display the text in this color.
+    //!
+    virtual void line(const QString& line, const QColor& color = QColor()) Q_DECL_OVERRIDE;
+
+    //!
+    //! Log a line of debug text.
+    //! Reimplemented from QtlLogger, can be invoked from the reader thread.
+    //! @param [in] line Line to log. No need to contain a trailing new-line character.
+    //! @param [in] color When a valid color is passed, try to display the text in this color.
+    //!
+    virtual void debug(const QString& line, const QColor& color = QColor()) Q_DECL_OVERRIDE;
+
+private slots:
+    //!
+    //! Log text, from the reader thread.
+    //! @param [in] type Type of log (0: text, 1: line, 2: debug).
+    //! @param [in] line Text to log.
+    //! @param [in] color Optional color.
+    //!
+    void logFromThread(int type, const QString& line, const QColor& color);
+
+private:
+    //!
+    //! The thread which reads the DVD sectors.
+    //!
+    class ReaderThread : public QThread
+    {
+    public:
+        //!
+        //! Constructor.
+        //! @param [in] readAhead The object which is run in this thread.
+        //!
+        ReaderThread(QtsDvdReadAhead* readAhead) :
+            QThread(),
+            _readAhead(readAhead)
+        {
+        }
+    protected:
+        //!
+        //! Thread main code.
+        //! Reimplemented from QThread.
+        //!
+        virtual void run() Q_DECL_OVERRIDE
+        {
+            _readAhead->readSectors();
+        }
+    private:
+        QtsDvdReadAhead* _readAhead; //!< The object to run.
+    };
+
+    //!
+    //! Description of a chunk of sectors in the ring.
+    //!
+    struct Chunk
+    {
+        QtlByteBlock data;      //!< Sector data.
+        int          requested; //!< Number of requested sectors.
+        int          count;     //!< Number of read sectors, -1 on error.
+        //!
+        //! Constructor.
+        //!
+        Chunk() : data(), requested(0), count(0) {}
+    };
+
+    QtlNullLogger               _nullLog;           //!< Dummy null logger if none specified by caller.
+    QtlLogger*                  _log;               //!< Message logger.
+    const int                   _chunkSectors;      //!< Max number of sectors per chunk.
+    ReaderThread                _thread;            //!< Reader thread.
+    QtsDvdMedia*                _dvd;               //!< DVD media to read.
+    QtlRangeList                _sectorList;        //!< List of sectors to read.
+    QList<Qts::BadSectorPolicy> _badSectorPolicies; //!< How to handle bad sectors, per range.
+    QMutex                      _mutex;             //!< Protect the ring of chunks.
+    QWaitCondition              _chunkFilled;       //!< Signaled by the reader thread when a chunk is filled.
+    QWaitCondition              _chunkFreed;        //!< Signaled by the consumer when a chunk is freed.
+    QVector<Chunk>              _chunks;            //!< Ring of chunks.
+    int                         _readIndex;         //!< Index of next chunk to consume.
+    int                         _filledCount;       //!< Number of filled chunks, not yet consumed.
+    bool                        _endOfList;         //!< The reader thread has completed (end of list or error).
+
+    //!
+    //! Read all sectors, executed in the reader thread.
+    //!
+    void readSectors();
+
+    //!
+    //! Check if the current thread is the reader thread.
+    //! @return True if the current thread is the reader thread.
+    //!
+    bool inReaderThread() const
+    {
+        return QThread::currentThread() == &_thread;
+    }
+
+    // Unaccessible operations.
+    Q_DISABLE_COPY(QtsDvdReadAhead)
+};
+
+#endif // QTSDVDREADAHEAD_H
@@ -0,0 +1,156 @@
+//----------------------------------------------------------------------------
+//
+// Copyright (c) 2013-2017, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//
+// Qts, the Qt MPEG Transport Stream library.
+// Define the class QtsDvdStreamScanner.
+//
+//----------------------------------------------------------------------------
+
+#include "QtsDvdStreamScanner.h"
+
+
+//----------------------------------------------------------------------------
+// Constructor.
+//----------------------------------------------------------------------------
+
+QtsDvdStreamScanner::QtsDvdStreamScanner(QObject* parent) :
+    QIODevice(parent),
+    _sector(),
+    _sectorCount(0),
+    _streamIds()
+{
+    _sector.reserve(QTS_DVD_SECTOR_SIZE);
+}
+
+
+//----------------------------------------------------------------------------
+// Reimplemented from QIODevice.
+//----------------------------------------------------------------------------
+
+bool QtsDvdStreamScanner::isSequential() const
+{
+    return true;
+}
+
+qint64 QtsDvdStreamScanner::readData(char* data, qint64 maxSize)
+{
+    Q_UNUSED(data);
+    Q_UNUSED(maxSize);
+    return -1;
+}
+
+
+//----------------------------------------------------------------------------
+// Write DVD content.
+//----------------------------------------------------------------------------
+
+qint64 QtsDvdStreamScanner::writeData(const char* data, qint64 maxSize)
+{
+    const quint8* cur = reinterpret_cast<const quint8*>(data);
+    qint64 remain = maxSize;
+
+    // Complete a partial sector from a previous write.
+    if (!_sector.isEmpty()) {
+        const int size = int(qMin<qint64>(remain, QTS_DVD_SECTOR_SIZE - _sector.size()));
+        _sector.append(reinterpret_cast<const char*>(cur), size);
+        cur += size;
+        remain -= size;
+        if (_sector.size() < QTS_DVD_SECTOR_SIZE) {
+            return maxSize;
+        }
+        scanSector(reinterpret_cast<const quint8*>(_sector.constData()));
+        _sector.clear();
+    }
+
+    // Scan complete sectors in place.
+    while (remain >= QTS_DVD_SECTOR_SIZE) {
+        scanSector(cur);
+        cur += QTS_DVD_SECTOR_SIZE;
+        remain -= QTS_DVD_SECTOR_SIZE;
+    }
+
+    // Keep a trailing partial sector for the next write.
+    if (remain > 0) {
+        _sector.append(reinterpret_cast<const char*>(cur), int(remain));
+    }
+    return maxSize;
+}
+
+
+//----------------------------------------------------------------------------
+// Scan one sector.
+//----------------------------------------------------------------------------
+
+void QtsDvdStreamScanner::scanSector(const quint8* sector)
+{
+    _sectorCount++;
+
+    // Each sector starts with a pack header. Ignore invalid sectors.
+    if (sector[0] != 0x00 || sector[1] != 0x00 || sector[2] != 0x01 || sector[3] != 0xBA) {
+        return;
+    }
+
+    // Size of the pack header: MPEG-2 (with stuffing) or MPEG-1.
+    int pos = (sector[4] & 0xC0) == 0x40 ? 14 + (sector[13] & 0x07) : 12;
+
+    // Loop on all PES packets in the pack.
+    while (pos + 6 <= QTS_DVD_SECTOR_SIZE && sector[pos] == 0x00 && sector[pos + 1] == 0x00 && sector[pos + 2] == 0x01) {
+
+        const quint8 sid = sector[pos + 3];
+        const int end = pos + 6 + qFromBigEndian<quint16>(sector + pos + 4);
+        int streamId = -1;
+
+        if (sid == 0xB9) {
+            // Program end code.
+            break;
+        }
+        else if (sid >= 0xE0 && sid <= 0xEF) {
+            // Video stream, same as ffprobe.
+            streamId = 0x0100 | sid;
+        }
+        else if (sid >= 0xC0 && sid <= 0xDF) {
+            // MPEG audio stream.
+            streamId = sid;
+        }
+        else if (sid == 0xBD && pos + 9 <= QTS_DVD_SECTOR_SIZE) {
+            // Private stream 1, the substream id is the first byte after the PES header.
+            const int sub = pos + 9 + sector[pos + 8];
+            if (sub < end && sub < QTS_DVD_SECTOR_SIZE) {
+                streamId = sector[sub];
+            }
+        }
+
+        // Report new streams.
+        if (streamId >= 0 && !_streamIds.contains(streamId)) {
+            _streamIds.append(streamId);
+            emit streamFound(streamId);
+        }
+
+        pos = end;
+    }
+}
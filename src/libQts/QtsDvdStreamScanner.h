@@ -0,0 +1,132 @@
+//----------------------------------------------------------------------------
+//
+// Copyright (c) 2013-2017, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//!
+//! @file QtsDvdStreamScanner.h
+//!
+//! Declare the class QtsDvdStreamScanner.
+//! Qts, the Qt MPEG Transport Stream library.
+//!
+//----------------------------------------------------------------------------
+
+#ifndef QTSDVDSTREAMSCANNER_H
+#define QTSDVDSTREAMSCANNER_H
+
+#include <QtCore>
+#include "QtsDvd.h"
+
+//!
+//! A write-only device which discovers the elementary streams in DVD VOB content.
+//!
+//! The DVD content (MPEG-2 program stream, one pack per sector) is written into
+//! this device, typically by a QtlDataPull. Each pack is parsed on the fly and the
+//! signal streamFound() is emitted as soon as a new elementary stream appears.
+//! The stream ids use the same conventions as the streams from QtsDvdTitleSet
+//! and ffprobe: 0x1E0 for video, the substream id for private stream 1 (0x80 + n
+//! for AC-3, 0x20 + n for subpictures, etc.) and the stream id for MPEG audio.
+//!
+//! This is much faster than ffprobe and the first streams are found after a few
+//! sectors. However, the characteristics of the streams are not analyzed.
+//!
+class QtsDvdStreamScanner : public QIODevice
+{
+    Q_OBJECT
+
+public:
+    //!
+    //! Constructor.
+    //! @param [in] parent Optional parent object.
+    //!
+    explicit QtsDvdStreamScanner(QObject* parent = 0);
+
+    //!
+    //! Get the stream ids which were found so far.
+    //! @return The list of stream ids, in order of first appearance.
+    //!
+    QList<int> streamIds() const
+    {
+        return _streamIds;
+    }
+
+    //!
+    //! Get the number of sectors which were scanned so far.
+    //! @return The number of scanned sectors.
+    //!
+    qint64 sectorCount() const
+    {
+        return _sectorCount;
+    }
+
+    //!
+    //! Check if the device is sequential.
+    //! Reimplemented from QIODevice.
+    //! @return Always true.
+    //!
+    virtual bool isSequential() const Q_DECL_OVERRIDE;
+
+signals:
+    //!
+    //! Emitted when a new elementary stream is found.
+    //! @param [in] streamId Stream id, see the class description.
+    //!
+    void streamFound(int streamId);
+
+protected:
+    //!
+    //! Read data, not supported.
+    //! Reimplemented from QIODevice.
+    //! @param [out] data Not used.
+    //! @param [in] maxSize Not used.
+    //! @return Always -1.
+    //!
+    virtual qint64 readData(char* data, qint64 maxSize) Q_DECL_OVERRIDE;
+
+    //!
+    //! Write DVD content.
+    //! Reimplemented from QIODevice.
+    //! @param [in] data Address of data.
+    //! @param [in] maxSize Size in bytes of data.
+    //! @return The number of written bytes.
+    //!
+    virtual qint64 writeData(const char* data, qint64 maxSize) Q_DECL_OVERRIDE;
+
+private:
+    QByteArray _sector;       //!< Partial sector from previous write.
+    qint64     _sectorCount;  //!< Number of scanned sectors.
+    QList<int> _streamIds;    //!< Stream ids in order of first appearance.
+
+    //!
+    //! Scan one sector.
+    //! @param [in] sector Address of a complete sector.
+    //!
+    void scanSector(const quint8* sector);
+
+    // Unaccessible operations.
+    Q_DISABLE_COPY(QtsDvdStreamScanner)
+};
+
+#endif // QTSDVDSTREAMSCANNER_H
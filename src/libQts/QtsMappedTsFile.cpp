@@ -0,0 +1,340 @@
+//----------------------------------------------------------------------------
+//
+// Copyright (c) 2013-2017, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//
+// Qts, the Qt MPEG Transport Stream library.
+// Define the class QtsMappedTsFile.
+//
+//----------------------------------------------------------------------------
+
+#include "QtsMappedTsFile.h"
+
+#if defined(Q_OS_UNIX)
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace {
+    //!
+    //! Default size in bytes of the mapped windows.
+    //!
+    const qint64 QTS_DEFAULT_WINDOW_SIZE = 32 * 1024 * 1024;
+}
+
+
+//----------------------------------------------------------------------------
+// Constructors and destructor.
+//----------------------------------------------------------------------------
+
+QtsMappedTsFile::QtsMappedTsFile(QObject* parent) :
+    QFile(parent),
+    _tsFileType(QtsTsFile::AutoDetect),
+    _windowMaxSize(QTS_DEFAULT_WINDOW_SIZE),
+    _useMap(true),
+    _position(0),
+    _window(0),
+    _windowStart(0),
+    _windowSize(0),
+    _buffer(),
+    _packets()
+{
+}
+
+QtsMappedTsFile::QtsMappedTsFile(const QString& name, QtsTsFile::TsFileType type, QObject* parent) :
+    QFile(name, parent),
+    _tsFileType(type),
+    _windowMaxSize(QTS_DEFAULT_WINDOW_SIZE),
+    _useMap(true),
+    _position(0),
+    _window(0),
+    _windowStart(0),
+    _windowSize(0),
+    _buffer(),
+    _packets()
+{
+}
+
+QtsMappedTsFile::~QtsMappedTsFile()
+{
+    close();
+}
+
+
+//----------------------------------------------------------------------------
+// Set the TS packet format or window size. Must be called before open().
+//----------------------------------------------------------------------------
+
+void QtsMappedTsFile::setTsFileType(QtsTsFile::TsFileType tsFileType)
+{
+    if (!isOpen()) {
+        _tsFileType = tsFileType;
+    }
+}
+
+void QtsMappedTsFile::setWindowSize(qint64 size)
+{
+    if (!isOpen()) {
+        // Make sure that a window can contain at least the auto-detection data.
+        _windowMaxSize = qMax(size, qint64(QtsTsFile::autoDetectSize()));
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Open the file. Reimplemented from QIODevice.
+//----------------------------------------------------------------------------
+
+bool QtsMappedTsFile::open(QIODevice::OpenMode mode)
+{
+    // Only read-only is supported.
+    if ((mode & ReadWrite) != ReadOnly) {
+        return false;
+    }
+
+    // Open in superclass. Clear unsupported options.
+    const bool success = QFile::open(mode & ~Text);
+
+    // Reset internal state.
+    if (success) {
+        _useMap = !isSequential();
+        _position = 0;
+        _windowStart = 0;
+        _windowSize = 0;
+        _buffer.clear();
+        _packets.clear();
+    }
+
+    return success;
+}
+
+
+//----------------------------------------------------------------------------
+// Close the file. Reimplemented from QIODevice.
+//----------------------------------------------------------------------------
+
+void QtsMappedTsFile::close()
+{
+    unmapWindow();
+    _buffer.clear();
+    _packets.clear();
+    QFile::close();
+}
+
+
+//----------------------------------------------------------------------------
+// Set the position of the next packet to read in the file.
+//----------------------------------------------------------------------------
+
+bool QtsMappedTsFile::seek(qint64 pos)
+{
+    if (pos < 0 || isSequential()) {
+        return false;
+    }
+
+    // Drop the current window, the next one will start at the new position.
+    unmapWindow();
+    _buffer.clear();
+    _position = _windowStart = pos;
+    _windowSize = 0;
+
+    // When reading in the internal buffer, move the file position as well.
+    return _useMap || QFile::seek(pos);
+}
+
+
+//----------------------------------------------------------------------------
+// Unmap the current window, if any.
+//----------------------------------------------------------------------------
+
+void QtsMappedTsFile::unmapWindow()
+{
+    if (_window != 0) {
+        unmap(_window);
+        _window = 0;
+        _windowStart = _position;
+        _windowSize = 0;
+    }
+}
+
+
+//----------------------------------------------------------------------------
+// Load a new window, starting at the current position.
+//----------------------------------------------------------------------------
+
+bool QtsMappedTsFile::loadWindow(qint64 minSize)
+{
+    // Try to map the next window.
+    if (_useMap) {
+        unmapWindow();
+
+        // Size of the new window, empty at end of file.
+        const qint64 length = qMin(_windowMaxSize, size() - _position);
+        if (length <= 0) {
+            return true;
+        }
+
+        _window = map(_position, length);
+        if (_window != 0) {
+            _windowStart = _position;
+            _windowSize = length;
+#if defined(Q_OS_UNIX)
+            // The window will be read only once, sequentially. The address passed
+            // to madvise() must be aligned on a page boundary.
+            const long pageSize = ::sysconf(_SC_PAGESIZE);
+            if (pageSize > 0) {
+                const qint64 shift = _windowStart % pageSize;
+                ::madvise(_window - shift, size_t(_windowSize + shift), MADV_SEQUENTIAL);
+            }
+#endif
+            return true;
+        }
+
+        // The file cannot be mapped, revert to plain read at the same position.
+        _useMap = false;
+        if (!QFile::seek(_position)) {
+            return false;
+        }
+    }
+
+    // Plain read in the internal buffer.
+    return readBuffer(qMax(minSize, qint64(QtsTsFile::autoDetectSize())));
+}
+
+
+//----------------------------------------------------------------------------
+// Read raw data in the internal buffer.
+//----------------------------------------------------------------------------
+
+bool QtsMappedTsFile::readBuffer(qint64 size)
+{
+    // Move the unread data at the beginning of the buffer.
+    // This is typically a partial packet, when not empty.
+    const int initialSize = int(_windowStart + _windowSize - _position);
+    if (initialSize > 0 && _position > _windowStart) {
+        ::memmove(_buffer.data(), _buffer.data() + (_position - _windowStart), initialSize);
+    }
+    _windowStart = _position;
+    _windowSize = initialSize;
+
+    // Read data from the file until the requested size is reached or end of file.
+    _buffer.resize(int(size));
+    while (_windowSize < size) {
+        const qint64 received = QIODevice::read(reinterpret_cast<char*>(_buffer.data()) + _windowSize, size - _windowSize);
+        if (received < 0) {
+            _buffer.resize(int(_windowSize));
+            return false;
+        }
+        else if (received == 0) {
+            break;
+        }
+        _windowSize += received;
+    }
+    _buffer.resize(int(_windowSize));
+    return true;
+}
+
+
+//----------------------------------------------------------------------------
+// Get the address and size of the unread data.
+//----------------------------------------------------------------------------
+
+const quint8* QtsMappedTsFile::unreadData(qint64& size) const
+{
+    const qint64 offset = _position - _windowStart;
+    size = _windowSize - offset;
+    return (_useMap ? _window : _buffer.data()) + offset;
+}
+
+
+//----------------------------------------------------------------------------
+// Get the address of the next TS packets in the file.
+//----------------------------------------------------------------------------
+
+int QtsMappedTsFile::mapPackets(const QtsTsPacket*& packets, int maxPacketCount)
+{
+    packets = 0;
+
+    // Filter out empty read or closed file.
+    if (!isOpen()) {
+        return -1;
+    }
+    if (maxPacketCount <= 0) {
+        return 0;
+    }
+
+    qint64 size = 0;
+    const quint8* data = unreadData(size);
+
+    // Perform initial autodetection of packet format.
+    if (_tsFileType == QtsTsFile::AutoDetect) {
+        if (size < QtsTsFile::autoDetectSize()) {
+            if (!loadWindow(QtsTsFile::autoDetectSize())) {
+                return -1;
+            }
+            data = unreadData(size);
+        }
+        _tsFileType = QtsTsFile::detectFileType(data, int(qMin(size, qint64(QtsTsFile::autoDetectSize()))));
+        if (_tsFileType == QtsTsFile::AutoDetect) {
+            // Not a valid TS file.
+            return -1;
+        }
+    }
+
+    // Format of packets to read.
+    const int headerSize = _tsFileType == QtsTsFile::M2tsFile ? QTS_M2TS_HEADER_SIZE : 0;
+    const int packetSize = headerSize + QTS_PKT_SIZE;
+
+    // Load the next window when the current one is exhausted.
+    if (size < packetSize) {
+        if (!loadWindow(qint64(maxPacketCount) * packetSize)) {
+            return -1;
+        }
+        data = unreadData(size);
+    }
+
+    // Number of complete packets in the window.
+    const int packetCount = int(qMin(qint64(maxPacketCount), size / packetSize));
+
+    if (headerSize == 0) {
+        // Plain TS file, return the packets in place.
+        packets = reinterpret_cast<const QtsTsPacket*>(data);
+    }
+    else if (packetCount > 0) {
+        // M2TS file, extract the TS packets in one pass, skipping the M2TS headers.
+        _packets.resize(packetCount * QTS_PKT_SIZE);
+        QtsTsPacket* out = reinterpret_cast<QtsTsPacket*>(_packets.data());
+        data += headerSize;
+        for (int i = 0; i < packetCount; ++i) {
+            ::memcpy(out + i, data, QTS_PKT_SIZE);
+            data += packetSize;
+        }
+        packets = out;
+    }
+
+    _position += qint64(packetCount) * packetSize;
+    return packetCount;
+}
@@ -0,0 +1,198 @@
+//----------------------------------------------------------------------------
+//
+// Copyright (c) 2013-2017, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//!
+//! @file QtsMappedTsFile.h
+//!
+//! Declare the class QtsMappedTsFile.
+//! Qts, the Qt MPEG Transport Stream library.
+//!
+//----------------------------------------------------------------------------
+
+#ifndef QTSMAPPEDTSFILE_H
+#define QTSMAPPEDTSFILE_H
+
+#include <QtCore>
+#include "QtsTsFile.h"
+#include "QtlByteBlock.h"
+
+//!
+//! A subclass of QFile which reads MPEG transport stream packets using memory mapping.
+//!
+//! The file is mapped in memory by successive windows. Only one window is mapped
+//! at a time so that the amount of resident memory remains bounded, even on
+//! very large files. With plain TS files, the TS packets are directly returned
+//! from the mapped memory, without copy.
+//!
+//! If the file cannot be mapped (special device for instance), the packets
+//! are read in an internal buffer.
+//!
+class QtsMappedTsFile : public QFile
+{
+    Q_OBJECT
+
+public:
+    //!
+    //! Constructor.
+    //! @param [in] parent Optional parent object.
+    //!
+    explicit QtsMappedTsFile(QObject* parent = 0);
+
+    //!
+    //! Constructor.
+    //! @param [in] name File name.
+    //! @param [in] type TS packet format.
+    //! @param [in] parent Optional parent object.
+    //!
+    explicit QtsMappedTsFile(const QString& name, QtsTsFile::TsFileType type = QtsTsFile::AutoDetect, QObject* parent = 0);
+
+    //!
+    //! Destructor.
+    //!
+    virtual ~QtsMappedTsFile();
+
+    //!
+    //! Open the file.
+    //! Reimplemented from QIODevice.
+    //! @param [in] mode The mode into which the file shall been open.
+    //! Only read-only mode is supported.
+    //! @return True on success, false on error.
+    //!
+    virtual bool open(OpenMode mode = ReadOnly) Q_DECL_OVERRIDE;
+
+    //!
+    //! Close the file.
+    //! Reimplemented from QIODevice.
+    //!
+    virtual void close() Q_DECL_OVERRIDE;
+
+    //!
+    //! Set the position of the next packet to read in the file.
+    //! Reimplemented from QIODevice.
+    //! @param [in] pos New position in bytes from the beginning of the file.
+    //! @return True on success, false on error.
+    //!
+    virtual bool seek(qint64 pos) Q_DECL_OVERRIDE;
+
+    //!
+    //! Get the address of the next TS packets in the file.
+    //! @param [out] packets Receive the address of the first TS packet. The returned
+    //! memory is valid until the next invocation of mapPackets(), seek() or close().
+    //! @param [in] maxPacketCount Maximum number of TS packets to return.
+    //! @return Number of TS packets at @a packets, zero at end of file, negative on error.
+    //! Note that a window boundary may return less than @a maxPacketCount packets
+    //! before the end of file.
+    //!
+    int mapPackets(const QtsTsPacket*& packets, int maxPacketCount);
+
+    //!
+    //! Get the TS packet format.
+    //! If initially set to AutoDetect, the returned value will be either
+    //! TsFile or M2tsFile after reading the first packets.
+    //! @return The TS packet format.
+    //!
+    QtsTsFile::TsFileType tsFileType() const
+    {
+        return _tsFileType;
+    }
+
+    //!
+    //! Set the TS packet format.
+    //! Must be called before open().
+    //! @param [in] tsFileType The TS packet format.
+    //!
+    void setTsFileType(QtsTsFile::TsFileType tsFileType);
+
+    //!
+    //! Get the maximum size of the mapped windows.
+    //! @return The maximum size in bytes of the mapped windows.
+    //!
+    qint64 windowSize() const
+    {
+        return _windowMaxSize;
+    }
+
+    //!
+    //! Set the maximum size of the mapped windows.
+    //! Must be called before open(). The default is 32 MB.
+    //! @param [in] size The maximum size in bytes of the mapped windows.
+    //!
+    void setWindowSize(qint64 size);
+
+    //!
+    //! Check if the file is actually mapped in memory.
+    //! @return True if the file is mapped, false if it is read in an internal buffer.
+    //!
+    bool isMapped() const
+    {
+        return _useMap;
+    }
+
+private:
+    QtsTsFile::TsFileType _tsFileType;     //!< Packet format.
+    qint64                _windowMaxSize;  //!< Maximum size of mapped windows.
+    bool                  _useMap;         //!< Use memory mapping, false if not supported on the file.
+    qint64                _position;       //!< Offset in file of next packet to read.
+    uchar*                _window;         //!< Address of current mapped window, zero if none.
+    qint64                _windowStart;    //!< Offset in file of current mapped window.
+    qint64                _windowSize;     //!< Size of current mapped window.
+    QtlByteBlock          _buffer;         //!< Raw data buffer when memory mapping is not supported.
+    QtlByteBlock          _packets;        //!< TS packets extracted from M2TS packets.
+
+    //!
+    //! Unmap the current window, if any.
+    //!
+    void unmapWindow();
+
+    //!
+    //! Load a new window, starting at the current position.
+    //! The window is either mapped from the file or read in the internal buffer.
+    //! @param [in] minSize Minimum number of bytes to load when reading in the internal buffer.
+    //! @return False on error. When true, the new window may be shorter or empty at end of file.
+    //!
+    bool loadWindow(qint64 minSize);
+
+    //!
+    //! Read raw data in the internal buffer, when memory mapping is not supported.
+    //! Unread data are kept at the beginning of the buffer.
+    //! @param [in] size Number of bytes to read.
+    //! @return False on read error. When true, the buffer may be shorter at end of file.
+    //!
+    bool readBuffer(qint64 size);
+
+    //!
+    //! Get the address and size of the unread data.
+    //! @param [out] size Number of unread bytes at the returned address.
+    //! @return Address of the unread data.
+    //!
+    const quint8* unreadData(qint64& size) const;
+
+    // Unaccessible operations.
+    Q_DISABLE_COPY(QtsMappedTsFile)
+};
+
+#endif // QTSMAPPEDTSFILE_H
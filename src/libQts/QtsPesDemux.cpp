@@ -33,6 +33,11 @@
 
 #include "QtsPesDemux.h"
 
+namespace {
+    // Maximum number of recycled TS payload buffers.
+    const int QTS_PES_MAX_FREE_BUFFERS = 16;
+}
+
 
 //-----------------------------------------------------------------------------
 // Constructor
@@ -42,6 +47,7 @@ QtsPesDemux::QtsPesDemux(QtsPesHandlerInterface* handler, const QtsPidSet& pidFi
     QtsDemux(pidFilter),
     _pesHandler(handler),
     _pids(),
+    _freeBuffers(),
     _inHandler(false),
     _pidInHandler(QTS_PID_NULL),
     _resetPending(false)
@@ -60,6 +66,7 @@ QtsPesDemux::PidContext::PidContext() :
     firstPkt(0),
     lastPkt(0),
     ts(),
+    bufferSize(0),
     resetPending(false)
 {
 }
@@ -78,6 +85,7 @@ void QtsPesDemux::reset()
     else {
         // Perform the actual reset.
         _pids.clear();
+        _freeBuffers.clear();
         QtsDemux::reset();
     }
 }
@@ -95,7 +103,7 @@ void QtsPesDemux::resetPid(QtsPid pid)
     }
     else {
         // Perform the actual reset.
-        _pids.remove(pid);
+        deletePidContext(pid);
         QtsDemux::resetPid(pid);
     }
 }
@@ -114,28 +122,26 @@ void QtsPesDemux::processTsPacket(const QtsTsPacket& packet)
 
     // Get PID and check if context exists
     const QtsPid pid = packet.getPid();
-    PidContextMap::Iterator pci = _pids.find(pid);
-    bool pcExists = pci != _pids.end();
+    PidContext* pc = _pids.find(pid);
 
     // If no context established and not at a unit start, ignore packet
-    if (!pcExists && !packet.getPusi()) {
+    if (pc == 0 && !packet.getPusi()) {
         return;
     }
 
     // If at a unit start and the context exists, process previous PES packet in context
-    if (pcExists && packet.getPusi() && pci.value().sync) {
+    if (pc != 0 && packet.getPusi() && pc->sync) {
         // Process packet, invoke all handlers.
-        processPesPacket(pid, pci.value());
+        processPesPacket(pid, *pc);
         // Recheck PID context in case it was reset by a handler.
-        pci = _pids.find(pid);
-        pcExists = pci != _pids.end();
+        pc = _pids.find(pid);
     }
 
     // If the packet is scrambled, we cannot get PES content.
     // Usually, if the PID becomes scrambled, it will remain scrambled for a while => release context.
     if (packet.isScrambled()) {
-        if (pcExists) {
-            _pids.remove(pid);
+        if (pc != 0) {
+            deletePidContext(pid);
         }
         return;
     }
@@ -150,17 +156,17 @@ void QtsPesDemux::processTsPacket(const QtsTsPacket& packet)
         // (it is not possible to have 00 00 01 in a PUSI packet containing sections).
         if (plSize >= 3 && pl[0] == 0 && pl[1] == 0 && pl[2] == 1) {
             // We are at the beginning of a PES packet. Create context if non existent.
-            PidContext& pc(_pids[pid]);
-            pc.continuity = packet.getCc();
-            pc.sync = true;
-            pc.ts.copy(pl, plSize);
-            pc.resetPending = false;
-            pc.firstPkt = packetCount();
-            pc.lastPkt = packetCount();
+            PidContext& newPc(_pids[pid]);
+            newPc.continuity = packet.getCc();
+            newPc.sync = true;
+            startPesPacket(newPc, pl, plSize);
+            newPc.resetPending = false;
+            newPc.firstPkt = packetCount();
+            newPc.lastPkt = packetCount();
         }
-        else if (pcExists) {
+        else if (pc != 0) {
             // This PID does not contain PES packet, reset context
-            _pids.remove(pid);
+            deletePidContext(pid);
         }
         // PUSI packet processing done.
         return;
@@ -168,45 +174,84 @@ void QtsPesDemux::processTsPacket(const QtsTsPacket& packet)
 
     // At this point, the TS packet contains part of a PES packet, but not beginning.
     // Check that PID context is valid.
-    if (!pcExists || !pci.value().sync) {
+    if (pc == 0 || !pc->sync) {
         return;
     }
-    PidContext& pc(pci.value());
 
     // Ignore duplicate packets (same CC)
-    if (packet.getCc() == pc.continuity) {
+    if (packet.getCc() == pc->continuity) {
         return;
     }
 
     // Check if we are still synchronized.
-    if (packet.getCc() != (pc.continuity + 1) % QTS_CC_MAX) {
-        pc.syncLost();
+    if (packet.getCc() != (pc->continuity + 1) % QTS_CC_MAX) {
+        pc->syncLost();
         return;
     }
-    pc.continuity = packet.getCc();
+    pc->continuity = packet.getCc();
 
     // Append the TS payload in PID context.
-    int capacity = pc.ts.capacity();
-    if (pc.ts.size() + plSize > capacity) {
+    int capacity = pc->ts.capacity();
+    if (pc->ts.size() + plSize > capacity) {
         // Internal reallocation needed in ts buffer.
         // Do not allow implicit reallocation, do it manually for better performance.
         // Use two predefined thresholds: 64 kB and 512 kB. Above that, double the size.
         // Note that 64 kB is OK for audio PIDs. Video PIDs are usually unbounded. The
         // maximum observed PES rate is 2 PES/s, meaning 512 kB / PES at 8 Mb/s.
         if (capacity < 64 * 1024) {
-            pc.ts.reserve(64 * 1024);
+            pc->ts.reserve(64 * 1024);
         }
         else if (capacity < 512 * 1024) {
-            pc.ts.reserve(512 * 1024);
+            pc->ts.reserve(512 * 1024);
         }
         else {
-            pc.ts.reserve(2 * capacity);
+            pc->ts.reserve(2 * capacity);
         }
     }
-    pc.ts.append(pl, plSize);
+    pc->ts.append(pl, plSize);
 
     // Last TS packet containing actual data for this PES packet
-    pc.lastPkt = packetCount();
+    pc->lastPkt = packetCount();
+}
+
+
+//-----------------------------------------------------------------------------
+// Start the reassembly of a new PES packet.
+//-----------------------------------------------------------------------------
+
+void QtsPesDemux::startPesPacket(PidContext& pc, const quint8* data, int size)
+{
+    // If the TS buffer is still shared with a PES packet which was kept by a handler
+    // (or was never allocated), do not let it detach with a minimal capacity.
+    if (!pc.ts.isDetached()) {
+        if (!_freeBuffers.isEmpty()) {
+            // Use a recycled buffer. The shared one is released with the last list element.
+            pc.ts.swap(_freeBuffers.last());
+            _freeBuffers.removeLast();
+        }
+        else {
+            // Allocate a new buffer with the largest size which was previously used on this PID.
+            pc.ts = QtlByteBlock();
+            pc.ts.reserve(pc.bufferSize);
+        }
+    }
+    pc.ts.copy(data, size);
+}
+
+
+//-----------------------------------------------------------------------------
+// Delete the analysis context of a PID and recycle its TS payload buffer.
+//-----------------------------------------------------------------------------
+
+void QtsPesDemux::deletePidContext(QtsPid pid)
+{
+    PidContext* pc = _pids.find(pid);
+    if (pc != 0) {
+        if (pc->ts.isDetached() && pc->ts.capacity() > 0 && _freeBuffers.size() < QTS_PES_MAX_FREE_BUFFERS) {
+            _freeBuffers.append(pc->ts);
+        }
+        _pids.remove(pid);
+    }
 }
 
 
@@ -216,7 +261,10 @@ void QtsPesDemux::processTsPacket(const QtsTsPacket& packet)
 
 void QtsPesDemux::processPesPacket(QtsPid pid, PidContext& pc)
 {
-    // Build a PES packet object around the TS buffer
+    // Keep track of the largest buffer on this PID.
+    pc.bufferSize = qMax(pc.bufferSize, pc.ts.capacity());
+
+    // Build a PES packet object around the TS buffer, without copy.
     QtsPesPacket pp(pc.ts, pid);
     if (!pp.isValid()) {
         return;
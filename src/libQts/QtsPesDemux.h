@@ -37,12 +37,20 @@
 #define QTSPESDEMUX_H
 
 #include "QtsDemux.h"
+#include "QtsPidContextTable.h"
 #include "QtsPesPacket.h"
 #include "QtsPesHandlerInterface.h"
 
 //!
 //! This class extracts PES packets from TS packets.
 //!
+//! The PES packets which are passed to the handlers share the reassembly buffer
+//! of their PID without copy. When the handler returns, the buffer is reused for
+//! the next PES packet on the PID. A handler which keeps a copy of a PES packet
+//! should call QtsPesPacket::detach() on its copy to release the reassembly buffer.
+//! Otherwise, a new reassembly buffer is allocated. Buffers from the PID's which
+//! are no longer demuxed are recycled.
+//!
 class QtsPesDemux : public QtsDemux
 {
 public:
@@ -95,6 +103,7 @@ private:
         QtsPacketCounter firstPkt;     //!< Index of first TS packet for current PES packet.
         QtsPacketCounter lastPkt;      //!< Index of last TS packet for current PES packet.
         QtlByteBlock     ts;           //!< TS payload buffer
+        int              bufferSize;   //!< Largest TS payload buffer capacity on this PID.
         bool             resetPending; //!< Delayed reset on this PID
         //!
         //! Default constructor:
@@ -110,9 +119,9 @@ private:
     };
 
     //!
-    //! Map of PID analysis contexts, indexed by PID value.
+    //! Table of PID analysis contexts, indexed by PID value.
     //!
-    typedef QMap<QtsPid,PidContext> PidContextMap;
+    typedef QtsPidContextTable<PidContext> PidContextTable;
 
     //!
     //! Feed the demux with a TS packet (PID already filtered).
@@ -127,9 +136,26 @@ private:
     //!
     void processPesPacket(QtsPid pid, PidContext& pc);
 
+    //!
+    //! Start the reassembly of a new PES packet in the TS payload buffer of a PID.
+    //! If the previous buffer is still referenced by a PES packet which was kept by
+    //! a handler, a recycled buffer is used instead.
+    //! @param [in,out] pc The PID analysis context.
+    //! @param [in] data Address of the first part of the PES packet.
+    //! @param [in] size Size in bytes of the first part of the PES packet.
+    //!
+    void startPesPacket(PidContext& pc, const quint8* data, int size);
+
+    //!
+    //! Delete the analysis context of a PID and recycle its TS payload buffer.
+    //! @param [in] pid The PID to delete.
+    //!
+    void deletePidContext(QtsPid pid);
+
     // Private members:
     QtsPesHandlerInterface* _pesHandler;    //!< User handler.
-    PidContextMap           _pids;          //!< Map of PID analysis contexts.
+    PidContextTable         _pids;          //!< Table of PID analysis contexts.
+    QList<QtlByteBlock>     _freeBuffers;   //!< Recycled TS payload buffers.
     bool                    _inHandler;     //!< True when in the context of a handler
     QtsPid                  _pidInHandler;  //!< PID which is currently processed by handler
     bool                    _resetPending;  //!< Delayed reset().
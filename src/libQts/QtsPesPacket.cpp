@@ -106,6 +106,18 @@ void QtsPesPacket::clear()
 }
 
 
+//-----------------------------------------------------------------------------
+// Make the binary content of the packet independent from its source.
+//-----------------------------------------------------------------------------
+
+void QtsPesPacket::detach()
+{
+    if (!_data.isDetached() || _data.capacity() > _data.size()) {
+        _data = QtlByteBlock(_data.constData(), _data.size());
+    }
+}
+
+
 //-----------------------------------------------------------------------------
 // Comparison.
 // The source PID are ignored, only the packet contents are compared.
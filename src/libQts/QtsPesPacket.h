@@ -68,9 +68,10 @@ public:
 
     //!
     //! Constructor from full binary content.
-    //! The content is copied into the packet only if valid.
+    //! The content is shared with the packet only if valid, without copy.
     //! @param [in] content Binary content.
     //! @param [in] pid PID from which the PES packet was extracted (informational only).
+    //! @see detach()
     //!
     QtsPesPacket(const QtlByteBlock& content, QtsPid pid = QTS_PID_NULL)
     {
@@ -91,7 +92,7 @@ public:
 
     //!
     //! Reload full binary content.
-    //! The content is copied into the packet only if valid.
+    //! The content is shared with the packet only if valid, without copy.
     //! @param [in] content Binary content.
     //! @param [in] pid PID from which the PES packet was extracted (informational only).
     //!
@@ -105,6 +106,15 @@ public:
     //!
     void clear();
 
+    //!
+    //! Make the binary content of the packet independent from its source.
+    //! A PES packet which is passed to a handler by a QtsPesDemux shares the reassembly
+    //! buffer of the demux. A handler which keeps a copy of the packet should detach
+    //! this copy. The content is then copied into a buffer of the exact packet size
+    //! and the demux can reuse its reassembly buffer.
+    //!
+    void detach();
+
     //!
     //! Check if a packet has valid content.
     //! @return True if the packet content is valid, false otherwise.
@@ -0,0 +1,154 @@
+//----------------------------------------------------------------------------
+//
+// Copyright (c) 2013-2017, Thierry Lelegard
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+// 2. Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+// THE POSSIBILITY OF SUCH DAMAGE.
+//
+//----------------------------------------------------------------------------
+//!
+//! @file QtsPidContextTable.h
+//!
+//! Declare the template class QtsPidContextTable.
+//! Qts, the Qt MPEG Transport Stream library.
+//!
+//----------------------------------------------------------------------------
+
+#ifndef QTSPIDCONTEXTTABLE_H
+#define QTSPIDCONTEXTTABLE_H
+
+#include "QtsCore.h"
+
+//!
+//! A table of analysis contexts, directly indexed by PID value.
+//!
+//! Demuxes need to locate a per-PID context for each TS packet. Since there are
+//! only 8192 possible PID values, a flat array of context pointers replaces the
+//! search in a map by one single indexed load. The contexts are allocated on demand.
+//!
+//! @tparam T The class of the PID contexts. Must be default-constructible.
+//!
+template<typename T>
+class QtsPidContextTable
+{
+public:
+    //!
+    //! Constructor.
+    //!
+    QtsPidContextTable() :
+        _contexts(new T*[QTS_PID_MAX]),
+        _count(0)
+    {
+        ::memset(_contexts, 0, QTS_PID_MAX * sizeof(T*));
+    }
+
+    //!
+    //! Destructor.
+    //! All contexts are deleted.
+    //!
+    ~QtsPidContextTable()
+    {
+        clear();
+        delete[] _contexts;
+    }
+
+    //!
+    //! Get the context of a PID if it exists.
+    //! @param [in] pid The PID to search.
+    //! @return The address of the context or zero if there is no context for this PID.
+    //!
+    T* find(QtsPid pid) const
+    {
+        Q_ASSERT(pid < QTS_PID_MAX);
+        return _contexts[pid];
+    }
+
+    //!
+    //! Check if a context exists for a PID.
+    //! @param [in] pid The PID to search.
+    //! @return True if a context exists for this PID.
+    //!
+    bool contains(QtsPid pid) const
+    {
+        Q_ASSERT(pid < QTS_PID_MAX);
+        return _contexts[pid] != 0;
+    }
+
+    //!
+    //! Get the context of a PID, create it if it does not exist.
+    //! @param [in] pid The PID to search.
+    //! @return A reference to the context of @a pid.
+    //!
+    T& operator[](QtsPid pid)
+    {
+        Q_ASSERT(pid < QTS_PID_MAX);
+        T*& context(_contexts[pid]);
+        if (context == 0) {
+            context = new T();
+            _count++;
+        }
+        return *context;
+    }
+
+    //!
+    //! Delete the context of a PID.
+    //! @param [in] pid The PID to remove.
+    //!
+    void remove(QtsPid pid)
+    {
+        Q_ASSERT(pid < QTS_PID_MAX);
+        T*& context(_contexts[pid]);
+        if (context != 0) {
+            delete context;
+            context = 0;
+            _count--;
+        }
+    }
+
+    //!
+    //! Delete all contexts.
+    //!
+    void clear()
+    {
+        for (QtsPid pid = 0; _count > 0 && pid < QTS_PID_MAX; ++pid) {
+            remove(pid);
+        }
+    }
+
+    //!
+    //! Get the number of allocated contexts.
+    //! @return The number of allocated contexts.
+    //!
+    int count() const
+    {
+        return _count;
+    }
+
+private:
+    T** _contexts; //!< Array of QTS_PID_MAX context pointers, indexed by PID.
+    int _count;    //!< Number of allocated contexts.
+
+    // Unaccessible operations.
+    Q_DISABLE_COPY(QtsPidContextTable)
+};
+
+#endif // QTSPIDCONTEXTTABLE_H
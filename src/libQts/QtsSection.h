@@ -561,7 +561,7 @@ typedef QVector<QtsSectionPtr> QtsSectionPtrVector;
 //!
 //! Smart pointer to a QtsSection (thread-safe).
 //!
-typedef QtlSmartPointer<QtsSection,QtlMutexLocker> QtsSectionSafePtr;
+typedef QtlSmartPointer<QtsSection,QtlAtomicLocker> QtsSectionSafePtr;
 
 //!
 //! Vector of smart pointers to QtsSection (thread-safe).
@@ -128,7 +128,8 @@ QtsSectionDemux::QtsSectionDemux(QtsTableHandlerInterface* tableHandler,
     _status(),
     _inHandler(false),
     _pidInHandler(QTS_PID_NULL),
-    _resetPending(false)
+    _resetPending(false),
+    _reuseRepeatedSections(false)
 {
 }
 
@@ -173,6 +174,20 @@ void QtsSectionDemux::resetPid(QtsPid pid)
 }
 
 
+//-----------------------------------------------------------------------------
+// Check if a section is a repetition of a previously received one.
+//-----------------------------------------------------------------------------
+
+bool QtsSectionDemux::isRepeatedSection(const QtsSectionPtr& previous, const quint8* data, int size)
+{
+    // The CRC32 field at the end of the long section is used as a hash of its content.
+    return !previous.isNull() &&
+        previous->size() == size &&
+        size >= 4 &&
+        ::memcmp(previous->content() + size - 4, data + size - 4, 4) == 0;
+}
+
+
 //-----------------------------------------------------------------------------
 // Private method: Feed the depacketizer with a TS packet.
 // The PID has already been filtered in an inlined public method.
@@ -393,7 +408,11 @@ void QtsSectionDemux::processTsPacket(const QtsTsPacket& pkt)
             // hendler is registered or if this is a new section).
             QtsSectionPtr sectPtr;
 
-            if (sectionOk && (_sectionHandler != 0 || tc.sects[sectionNumber].isNull())) {
+            if (sectionOk && _reuseRepeatedSections && longHeader && isRepeatedSection(tc.sects[sectionNumber], tsStart, sectionLength)) {
+                // Same section as previously received one, reuse it without copy or CRC32 check.
+                sectPtr = tc.sects[sectionNumber];
+            }
+            else if (sectionOk && (_sectionHandler != 0 || tc.sects[sectionNumber].isNull())) {
                 sectPtr = new QtsSection(tsStart, sectionLength, pid, QtsCrc32::Check);
                 sectPtr->setFirstTsPacketIndex(pusiPktIndex);
                 sectPtr->setLastTsPacketIndex(packetCount());
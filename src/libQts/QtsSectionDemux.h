@@ -38,6 +38,7 @@
 
 #include "QtsCore.h"
 #include "QtsDemux.h"
+#include "QtsPidContextTable.h"
 #include "QtsTable.h"
 #include "QtsSection.h"
 #include "QtsExtTableId.h"
@@ -54,6 +55,8 @@
 //!   Only sections with the 'current' indicator are reported.
 //! - Tables with long sections are reported only when a new
 //!   version is available.
+//! - Optionally, repeated long sections are recognized without copy
+//!   or CRC32 check (see setReuseRepeatedSections()).
 //!
 class QtsSectionDemux : public QtsDemux
 {
@@ -86,6 +89,35 @@ public:
         _sectionHandler = handler;
     }
 
+    //!
+    //! Specify if repeated sections are reused.
+    //!
+    //! By default, when a section handler is set, a new QtsSection object is built
+    //! and its CRC32 is checked for each occurrence of a section in the stream.
+    //! When repeated sections are reused, a long section with the same PID, table id,
+    //! table id extension, version and section number as a previously received one
+    //! is recognized using its length and CRC32 field. The section handler then
+    //! receives the previous QtsSection object, without copy or CRC32 check. This
+    //! makes the repetition of PSI/SI tables almost free during long analyses.
+    //! The packet indexes in the reused section are those of its first occurrence.
+    //!
+    //! @param [in] reuse If true, repeated sections are reused.
+    //!
+    void setReuseRepeatedSections(bool reuse)
+    {
+        _reuseRepeatedSections = reuse;
+    }
+
+    //!
+    //! Check if repeated sections are reused.
+    //! @return True if repeated sections are reused.
+    //! @see setReuseRepeatedSections()
+    //!
+    bool reuseRepeatedSections() const
+    {
+        return _reuseRepeatedSections;
+    }
+
     //!
     //! Reset the analysis context (partially built sections and tables).
     //! Useful when the transport stream changes.
@@ -195,9 +227,9 @@ private:
     };
 
     //!
-    //! Map of PidContext index by PID.
+    //! Table of PidContext indexed by PID.
     //!
-    typedef QMap<QtsPid,PidContext> PidContextMap;
+    typedef QtsPidContextTable<PidContext> PidContextTable;
 
     //!
     //! Feed the demux with a TS packet (PID already filtered).
@@ -205,14 +237,24 @@ private:
     //!
     void processTsPacket(const QtsTsPacket& packet) Q_DECL_OVERRIDE;
 
+    //!
+    //! Check if a section is a repetition of a previously received one.
+    //! @param [in] previous The previously received section with the same PID, ETID, version and number.
+    //! @param [in] data Address of the new section.
+    //! @param [in] size Size in bytes of the new section.
+    //! @return True if the new section has the same size and CRC32 as @a previous.
+    //!
+    static bool isRepeatedSection(const QtsSectionPtr& previous, const quint8* data, int size);
+
     // Private members:
     QtsTableHandlerInterface*   _tableHandler;   //!< Handler to invoke for each new table.
     QtsSectionHandlerInterface* _sectionHandler; //!< Handler to invoke for each section.
-    PidContextMap               _pids;           //!< State of the PID's analysis.
+    PidContextTable             _pids;           //!< State of the PID's analysis.
     Status                      _status;         //!< State of the demux.
     bool                        _inHandler;      //!< True when in the context of a table/section handler.
     QtsPid                      _pidInHandler;   //!< PID which is currently processed by handler.
     bool                        _resetPending;   //!< Delayed reset().
+    bool                        _reuseRepeatedSections; //!< Reuse repeated sections without copy or CRC32 check.
 
     // Unaccessible operations.
     Q_DISABLE_COPY(QtsSectionDemux)
@@ -262,7 +262,7 @@ typedef QVector<QtsTablePtr> QtsTablePtrVector;
 //!
 //! Smart pointer to a QtsTable (thread-safe).
 //!
-typedef QtlSmartPointer<QtsTable,QtlMutexLocker> QtsTableSafePtr;
+typedef QtlSmartPointer<QtsTable,QtlAtomicLocker> QtsTableSafePtr;
 
 //!
 //! Vector of smart pointers to QtsTable (thread-safe).
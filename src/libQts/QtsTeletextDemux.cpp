@@ -116,6 +116,18 @@ namespace {
         //0=black, 1=red,     2=green,   3=yellow,  4=blue,    5=magenta, 6=cyan,    7=white
         "#000000", "#ff0000", "#00ff00", "#ffff00", "#0000ff", "#ff00ff", "#00ffff", "#ffffff"
     };
+
+    // Maximum size in UTF-16 characters of a line of text. With color tags, each
+    // of the 40 columns can produce a closing tag, an opening tag and an entity.
+    const int TELETEXT_LINE_MAX = 40 * 36;
+
+    // Append an ASCII string in a buffer of UTF-16 characters.
+    inline void appendAscii(ushort*& out, const char* str)
+    {
+        while (*str != 0) {
+            *out++ = ushort(quint8(*str++));
+        }
+    }
 }
 
 
@@ -179,6 +191,8 @@ QtsTeletextDemux::QtsTeletextDemux(QtsTeletextHandlerInterface* handler, const Q
     _txtHandler(handler),
     _pids(),
     _addColors(),
+    _filterPages(false),
+    _pageFilter(),
     _inHandler(false),
     _pidInHandler(QTS_PID_NULL),
     _resetPending(false)
@@ -219,6 +233,39 @@ QtsTeletextDemux::PidContext::PidContext() :
 }
 
 
+//-----------------------------------------------------------------------------
+// Select the Teletext pages to decode.
+//-----------------------------------------------------------------------------
+
+void QtsTeletextDemux::addPage(int page)
+{
+    const int bcdPage = pageBinaryToBcd(page);
+    if (page >= 100 && page <= 899) {
+        _pageFilter.set(bcdPage);
+    }
+    _filterPages = true;
+}
+
+void QtsTeletextDemux::removePage(int page)
+{
+    const int bcdPage = pageBinaryToBcd(page);
+    if (page >= 100 && page <= 899) {
+        _pageFilter.reset(bcdPage);
+    }
+}
+
+void QtsTeletextDemux::clearPageFilter()
+{
+    _pageFilter.reset();
+    _filterPages = false;
+}
+
+bool QtsTeletextDemux::isPageDecoded(int page) const
+{
+    return page >= 100 && page <= 899 && pageSelected(pageBinaryToBcd(page));
+}
+
+
 //-----------------------------------------------------------------------------
 // Reset the analysis context (partially built TELETEXT packets).
 //-----------------------------------------------------------------------------
@@ -371,6 +418,12 @@ void QtsTeletextDemux::processTeletextPacket(QtsPid pid, QtsTeletextDemux::PidCo
             pc.receivingData = false;
         }
 
+        // Drop pages which are not decoded before buffering anything.
+        // If the current page was terminated, its rows are ignored until the next decoded page header.
+        if (!pageSelected(pageNumber)) {
+            return;
+        }
+
         // A new frame starts on a page. If this page had a non-empty frame in progress, flush it now.
         TeletextPage& page(pc.pages[pageNumber]);
         if (page.tainted) {
@@ -495,6 +548,11 @@ void QtsTeletextDemux::processTeletextPacket(QtsPid pid, QtsTeletextDemux::PidCo
 
 void QtsTeletextDemux::processTeletextPage(QtsPid pid, QtsTeletextDemux::PidContext& pc, int pageNumber)
 {
+    // Ignore pages which were removed from the page filter while being buffered.
+    if (!pageSelected(pageNumber)) {
+        return;
+    }
+
     // Reference to the page content.
     QtsTeletextDemux::TeletextPage& page(pc.pages[pageNumber]);
 
@@ -520,9 +578,13 @@ void QtsTeletextDemux::processTeletextPage(QtsPid pid, QtsTeletextDemux::PidCont
     // Prepare the Teletext frame.
     QtsTeletextFrame frame(pid, pageBcdToBinary(pageNumber), page.frameCount, page.showTimestamp, page.hideTimestamp);
 
+    // Each line is built in a preallocated buffer of UTF-16 characters.
+    // The final QString is allocated only once per line, with the exact size.
+    ushort buffer[TELETEXT_LINE_MAX];
+
     // Process page data.
     for (quint8 row = 1; row < 25; row++) {
-        QString line;
+        ushort* line = buffer;
 
         // Anchors for string trimming purpose
         quint8 colStart = 40;
@@ -574,9 +636,9 @@ void QtsTeletextDemux::processTeletextPage(QtsPid pid, QtsTeletextDemux::PidCont
 
             if (col == colStart) {
                 if (foregroundColor != 0x7 && _addColors) {
-                    line.append("<font color=\"");
-                    line.append(TELETEXT_COLORS[foregroundColor]);
-                    line.append("\">");
+                    appendAscii(line, "<font color=\"");
+                    appendAscii(line, TELETEXT_COLORS[foregroundColor]);
+                    appendAscii(line, "\">");
                     fontTagOpened = true;
                 }
             }
@@ -587,16 +649,16 @@ void QtsTeletextDemux::processTeletextPage(QtsPid pid, QtsTeletextDemux::PidCont
                     // each character space occupied by a spacing attribute is displayed as a SPACE.
                     if (_addColors) {
                         if (fontTagOpened) {
-                            line.append("</font> ");
+                            appendAscii(line, "</font> ");
                             fontTagOpened = false;
                         }
 
                         // black is considered as white for telxcc purpose
                         // telxcc writes <font/> tags only when needed
                         if (v > 0x00 && v < 0x07) {
-                            line.append("<font color=\"");
-                            line.append(TELETEXT_COLORS[v]);
-                            line.append("\">");
+                            appendAscii(line, "<font color=\"");
+                            appendAscii(line, TELETEXT_COLORS[v]);
+                            appendAscii(line, "\">");
                             fontTagOpened = true;
                         }
                     }
@@ -619,7 +681,7 @@ void QtsTeletextDemux::processTeletextPage(QtsPid pid, QtsTeletextDemux::PidCont
                     };
                     for (const HtmlEntity* p = entities; p->entity != 0; ++p) {
                         if (v == p->character) {
-                            line.append(p->entity);
+                            appendAscii(line, p->entity);
                             v = 0;  // v < 0x20 won't be printed in next block
                             break;
                         }
@@ -627,19 +689,20 @@ void QtsTeletextDemux::processTeletextPage(QtsPid pid, QtsTeletextDemux::PidCont
                 }
 
                 if (v >= 0x20) {
-                    line.append(QChar(ushort(v)));
+                    *line++ = ushort(v);
                 }
             }
         }
 
         // No tag will be left opened!
         if (_addColors && fontTagOpened) {
-            line.append("</font>");
+            appendAscii(line, "</font>");
             fontTagOpened = false;
         }
 
         // Line is now complete.
-        frame.addLine(line);
+        Q_ASSERT(line - buffer <= TELETEXT_LINE_MAX);
+        frame.addLine(QString::fromUtf16(buffer, int(line - buffer)));
     }
 
     // Now call the user-specified handler.
@@ -93,11 +93,39 @@ public:
         _txtHandler = handler;
     }
 
+    //!
+    //! Add a Teletext page to decode.
+    //! By default, all pages are decoded. As soon as one page is added, only the
+    //! added pages are decoded. The packets from all other pages are dropped as
+    //! soon as their page header is found, without buffering or charset conversion.
+    //! @param [in] page Teletext page number, from 100 to 899.
+    //!
+    void addPage(int page);
+
+    //!
+    //! Remove a Teletext page to decode.
+    //! If all added pages are removed, no page is decoded until clearPageFilter() is invoked.
+    //! @param [in] page Teletext page number, from 100 to 899.
+    //!
+    void removePage(int page);
+
+    //!
+    //! Clear the page filter, all Teletext pages are decoded.
+    //!
+    void clearPageFilter();
+
+    //!
+    //! Check if a Teletext page is decoded.
+    //! @param [in] page Teletext page number, from 100 to 899.
+    //! @return True if @a page is decoded.
+    //!
+    bool isPageDecoded(int page) const;
+
     //!
     //! Get the number of Teletext frames found in a given page.
     //! @param [in] page Teletext page number.
     //! @param [in] pid Teletext PID. If omitted, use the first PID containing frames from the specified @a page.
-    //! @return Number of Teletext frames found so far on @a page.
+    //! @return Number of Teletext frames found so far on @a page. Always zero if the page is not decoded.
     //!
     int frameCount(int page, QtsPid pid = QTS_PID_NULL) const;
 
@@ -155,6 +183,11 @@ private:
         void reset(quint64 timestamp);
     };
 
+    //!
+    //! Set of Teletext pages, indexed by BCD page number (magazine 1 to 8).
+    //!
+    typedef std::bitset<0x900> TeletextPageSet;
+
     //!
     //! Map of TeletextPage, indexed by page number.
     //!
@@ -200,6 +233,16 @@ private:
     //!
     void processTeletextPage(QtsPid pid, PidContext& pc, int pageNumber);
 
+    //!
+    //! Check if a Teletext page is selected by the page filter.
+    //! @param [in] bcdPage BCD page number.
+    //! @return True if @a bcdPage shall be decoded.
+    //!
+    bool pageSelected(int bcdPage) const
+    {
+        return !_filterPages || (bcdPage >= 0 && bcdPage < int(_pageFilter.size()) && _pageFilter.test(bcdPage));
+    }
+
     //!
     //! Remove 8/4 Hamming code.
     //! @param [in] a Hamming-encoded byte.
@@ -256,6 +299,8 @@ private:
     QtsTeletextHandlerInterface* _txtHandler;    //!< User handler.
     PidContextMap                _pids;          //!< Map of PID analysis contexts.
     bool                         _addColors;     //!< Add font color tags.
+    bool                         _filterPages;   //!< Decode only the pages in _pageFilter.
+    TeletextPageSet              _pageFilter;    //!< BCD numbers of pages to decode.
     bool                         _inHandler;     //!< True when in the context of a handler
     QtsPid                       _pidInHandler;  //!< PID which is currently processed by handler
     bool                         _resetPending;  //!< Delayed reset().
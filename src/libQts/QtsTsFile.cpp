@@ -52,14 +52,16 @@ namespace {
 QtsTsFile::QtsTsFile(QObject* parent) :
     QFile(parent),
     _tsFileType(AutoDetect),
-    _inBuffer()
+    _inBuffer(),
+    _inStart(0)
 {
 }
 
 QtsTsFile::QtsTsFile(const QString& name, TsFileType type, QObject* parent) :
     QFile(name, parent),
     _tsFileType(type),
-    _inBuffer()
+    _inBuffer(),
+    _inStart(0)
 {
 }
 
@@ -91,12 +93,27 @@ bool QtsTsFile::open(QIODevice::OpenMode mode)
     // Reset internal state.
     if (success) {
         _inBuffer.clear();
+        _inStart = 0;
     }
 
     return success;
 }
 
 
+//----------------------------------------------------------------------------
+// Set the current position in the file. Reimplemented from QIODevice.
+//----------------------------------------------------------------------------
+
+bool QtsTsFile::seek(qint64 pos)
+{
+    // Drop read-ahead data, they no longer apply at the new position.
+    _inBuffer.clear();
+    _inStart = 0;
+
+    return QFile::seek(pos);
+}
+
+
 //----------------------------------------------------------------------------
 // Make sure that the internal input buffer contains at least a given number
 // of bytes.
@@ -105,10 +122,19 @@ bool QtsTsFile::open(QIODevice::OpenMode mode)
 bool QtsTsFile::fillBuffer(int size)
 {
     // If the buffer needs more data from the file.
-    if (_inBuffer.size() < size) {
+    const int initialSize = bufferedSize();
+    if (initialSize < size) {
+
+        // Move the unread data at the beginning of the buffer.
+        // This is typically a partial packet, when not empty.
+        if (_inStart > 0) {
+            if (initialSize > 0) {
+                ::memmove(_inBuffer.data(), _inBuffer.data() + _inStart, initialSize);
+            }
+            _inStart = 0;
+        }
 
         // Resize the buffer to accept all requested bytes.
-        const int initialSize = _inBuffer.size();
         _inBuffer.resize(size);
 
         // Read data from the file.
@@ -127,25 +153,34 @@ bool QtsTsFile::fillBuffer(int size)
 
 
 //----------------------------------------------------------------------------
-// Read enough packets in _inBuffer to determine the packet size.
+// Recommended number of bytes for file format auto-detection.
 //----------------------------------------------------------------------------
 
-bool QtsTsFile::autoDetectFileFormat()
+int QtsTsFile::autoDetectSize()
 {
-    // Fill the buffer for auto-detection.
-    // Make sure we can read the requested number of largest packets (M2TS).
-    fillBuffer(QTS_AUTODETECT_PACKETS * QTS_PKT_M2TS_SIZE);
+    // Make sure we can analyze the requested number of largest packets (M2TS).
+    return QTS_AUTODETECT_PACKETS * QTS_PKT_M2TS_SIZE;
+}
+
+
+//----------------------------------------------------------------------------
+// Determine the packet format from the initial content of a file.
+//----------------------------------------------------------------------------
+
+QtsTsFile::TsFileType QtsTsFile::detectFileType(const void* data, int size)
+{
+    const quint8* const bytes = reinterpret_cast<const quint8*>(data);
 
     // Count matching synchronization bytes for TS and M2TS formats.
     int tsMatch = 0;
     int m2tsMatch = 0;
-    for (int i = 0; i < _inBuffer.size(); i += QTS_PKT_SIZE) {
-        if (_inBuffer[i] == QTS_SYNC_BYTE) {
+    for (int i = 0; i < size; i += QTS_PKT_SIZE) {
+        if (bytes[i] == QTS_SYNC_BYTE) {
             tsMatch++;
         }
     }
-    for (int i = QTS_M2TS_HEADER_SIZE; i < _inBuffer.size(); i += QTS_PKT_M2TS_SIZE) {
-        if (_inBuffer[i] == QTS_SYNC_BYTE) {
+    for (int i = QTS_M2TS_HEADER_SIZE; i < size; i += QTS_PKT_M2TS_SIZE) {
+        if (bytes[i] == QTS_SYNC_BYTE) {
             m2tsMatch++;
         }
     }
@@ -153,20 +188,33 @@ bool QtsTsFile::autoDetectFileFormat()
     // Guess the format from accumulated values.
     // Get the format with the highest matches and at least the required number of packets.
     if (tsMatch > m2tsMatch && tsMatch >= QTS_AUTODETECT_MIN_PACKETS) {
-        _tsFileType = TsFile;
-        return true;
+        return TsFile;
     }
     else if (m2tsMatch > tsMatch && m2tsMatch >= QTS_AUTODETECT_MIN_PACKETS) {
-        _tsFileType = M2tsFile;
-        return true;
+        return M2tsFile;
     }
     else {
         // Cannot guess, not enough bytes or not a valid TS file.
-        return false;
+        return AutoDetect;
     }
 }
 
 
+//----------------------------------------------------------------------------
+// Read enough packets in _inBuffer to determine the packet size.
+//----------------------------------------------------------------------------
+
+bool QtsTsFile::autoDetectFileFormat()
+{
+    // Fill the buffer for auto-detection.
+    fillBuffer(autoDetectSize());
+
+    // Analyze the unread data.
+    _tsFileType = detectFileType(_inBuffer.data() + _inStart, bufferedSize());
+    return _tsFileType != AutoDetect;
+}
+
+
 //----------------------------------------------------------------------------
 // Read as many TS packets as possible from the file.
 //----------------------------------------------------------------------------
@@ -184,32 +232,78 @@ int QtsTsFile::read(QtsTsPacket* buffer, int maxPacketCount)
         return -1;
     }
 
-    // Format of packets to read.
-    int headerSize = _tsFileType == M2tsFile ? QTS_M2TS_HEADER_SIZE : 0;
-    int packetSize = headerSize + QTS_PKT_SIZE;
-    int packetCount = 0;
+    // Use the specific read method for the packet format.
+    return _tsFileType == M2tsFile ? readM2tsPackets(buffer, maxPacketCount) : readTsPackets(buffer, maxPacketCount);
+}
 
-    // Read packets one by one, using the internal buffer as intermediate.
-    // Not optimal, especially in the case of plain TS files, but the code is simpler.
-    while (packetCount < maxPacketCount) {
 
-        // Make sure at least one packet is in the buffer.
-        const bool readOk = fillBuffer(packetSize);
+//----------------------------------------------------------------------------
+// Read packets from a plain TS file, directly into the user's buffer.
+//----------------------------------------------------------------------------
+
+int QtsTsFile::readTsPackets(QtsTsPacket* buffer, int maxPacketCount)
+{
+    char* const data = reinterpret_cast<char*>(buffer);
+    const qint64 requested = qint64(maxPacketCount) * QTS_PKT_SIZE;
+
+    // First, get the unread data from the internal buffer, if any
+    // (initial auto-detection or partial packet from the previous read).
+    qint64 size = qMin(qint64(bufferedSize()), requested);
+    if (size > 0) {
+        ::memcpy(data, _inBuffer.data() + _inStart, size_t(size));
+        _inStart += int(size);
+    }
 
-        // If not enough data in the buffer, stop there. Report an error only
-        // if an I/O error was detected and no previous packet could be read.
-        if (_inBuffer.size() < packetSize) {
-            return readOk || packetCount > 0 ? packetCount : -1;
+    // Then read all remaining packets in one operation, directly into the user's buffer.
+    bool readOk = true;
+    if (size < requested) {
+        const qint64 received = QIODevice::read(data + size, requested - size);
+        if (received < 0) {
+            readOk = false;
+        }
+        else {
+            size += received;
         }
+    }
+
+    // Number of complete packets.
+    const int packetCount = int(size / QTS_PKT_SIZE);
+
+    // Keep a trailing partial packet in the internal buffer for the next read.
+    // When this happens, the internal buffer was necessarily fully consumed.
+    const int partialSize = int(size % QTS_PKT_SIZE);
+    if (partialSize > 0) {
+        _inBuffer.copy(data + size - partialSize, partialSize);
+        _inStart = 0;
+    }
+
+    // Report an error only if an I/O error was detected and no packet could be read.
+    return readOk || packetCount > 0 ? packetCount : -1;
+}
 
-        // Read the TS packet into the user buffer. Skip the optional header.
-        ::memcpy(buffer++, _inBuffer.data() + headerSize, QTS_PKT_SIZE);
-        packetCount++;
 
-        // Remove the packet from the internal buffer.
-        _inBuffer.remove(0, packetSize);
+//----------------------------------------------------------------------------
+// Read packets from an M2TS file, through the internal buffer.
+//----------------------------------------------------------------------------
+
+int QtsTsFile::readM2tsPackets(QtsTsPacket* buffer, int maxPacketCount)
+{
+    // Read all raw data in the internal buffer in one operation.
+    const bool readOk = fillBuffer(maxPacketCount * QTS_PKT_M2TS_SIZE);
+
+    // Extract the TS packets in one pass, skipping the M2TS headers.
+    const int packetCount = qMin(maxPacketCount, bufferedSize() / QTS_PKT_M2TS_SIZE);
+    const quint8* data = _inBuffer.data() + _inStart + QTS_M2TS_HEADER_SIZE;
+    for (int i = 0; i < packetCount; ++i) {
+        ::memcpy(buffer + i, data, QTS_PKT_SIZE);
+        data += QTS_PKT_M2TS_SIZE;
     }
-    return packetCount;
+
+    // Move the read cursor, the buffer is compacted on the next fill.
+    _inStart += packetCount * QTS_PKT_M2TS_SIZE;
+
+    // Report an error only if an I/O error was detected and no packet could be read.
+    return readOk || packetCount > 0 ? packetCount : -1;
 }
 
 
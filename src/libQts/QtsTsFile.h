@@ -79,8 +79,24 @@ public:
     //!
     virtual bool open(OpenMode mode = ReadOnly) Q_DECL_OVERRIDE;
 
+    //!
+    //! Set the current position in the file.
+    //! Reimplemented from QIODevice.
+    //! Any data which were read ahead in the internal buffer are discarded.
+    //! @param [in] pos New position in bytes from the beginning of the file.
+    //! @return True on success, false on error.
+    //!
+    virtual bool seek(qint64 pos) Q_DECL_OVERRIDE;
+
     //!
     //! Read as many TS packets as possible from the file.
+    //!
+    //! With plain TS files, the packets are directly read from the file into @a buffer.
+    //! With M2TS files, the raw data are read in one single operation in an internal
+    //! buffer and the TS packets are extracted in one pass. Reading a large number
+    //! of packets at a time is consequently much more efficient than reading them
+    //! one by one.
+    //!
     //! @param [out] buffer Buffer receiving the TS packets.
     //! @param [in] maxPacketCount Size in @a buffer in number of TS packets.
     //! @return Number of TS packets actually read or negative on error.
@@ -123,9 +139,49 @@ public:
     //!
     void setTsFileType(const TsFileType& tsFileType);
 
+    //!
+    //! Determine the packet format from the initial content of a file.
+    //! @param [in] data Address of the initial content of the file.
+    //! @param [in] size Size in bytes of @a data. Should be at least autoDetectSize().
+    //! @return Either TsFile or M2tsFile. Return AutoDetect if the format cannot be determined.
+    //!
+    static TsFileType detectFileType(const void* data, int size);
+
+    //!
+    //! Get the recommended number of bytes for the file format auto-detection.
+    //! @return The recommended size of the initial content to pass to detectFileType().
+    //!
+    static int autoDetectSize();
+
 private:
     TsFileType   _tsFileType; //!< Packet format.
-    QtlByteBlock _inBuffer;   //!< Buffer for partially read packets or initial auto-detection.
+    QtlByteBlock _inBuffer;   //!< Buffer for partially read packets, M2TS input or initial auto-detection.
+    int          _inStart;    //!< Index of first unread byte in _inBuffer.
+
+    //!
+    //! Get the number of unread bytes in the internal input buffer.
+    //! @return The number of unread bytes in _inBuffer.
+    //!
+    int bufferedSize() const
+    {
+        return _inBuffer.size() - _inStart;
+    }
+
+    //!
+    //! Read packets from a plain TS file, directly into the user's buffer.
+    //! @param [out] buffer Buffer receiving the TS packets.
+    //! @param [in] maxPacketCount Size in @a buffer in number of TS packets.
+    //! @return Number of TS packets actually read or negative on error.
+    //!
+    int readTsPackets(QtsTsPacket* buffer, int maxPacketCount);
+
+    //!
+    //! Read packets from an M2TS file, through the internal buffer.
+    //! @param [out] buffer Buffer receiving the TS packets.
+    //! @param [in] maxPacketCount Size in @a buffer in number of TS packets.
+    //! @return Number of TS packets actually read or negative on error.
+    //!
+    int readM2tsPackets(QtsTsPacket* buffer, int maxPacketCount);
 
     //!
     //! Read enough packets in _inBuffer to determine the packet size.
@@ -135,9 +191,9 @@ private:
     bool autoDetectFileFormat();
 
     //!
-    //! Make sure that the internal input buffer contains at least a given number of bytes.
-    //! Read input file if necessary.
-    //! @param size Requested byte count in buffer.
+    //! Make sure that the internal input buffer contains at least a given number of unread bytes.
+    //! Read input file if necessary. Unread bytes are moved at the beginning of the buffer first.
+    //! @param size Requested unread byte count in buffer.
     //! @return False on read error. When true, the target number of bytes may not be
     //! reached if no data is currently available from the file.
     //!
@@ -50,8 +50,10 @@ SOURCES += \
     QtsTable.cpp \
     QtsTsPacket.cpp \
     QtsTsFile.cpp \
+    QtsMappedTsFile.cpp \
     QtsSectionDemux.cpp \
     QtsDemux.cpp \
+    QtsDemuxHub.cpp \
     QtsTeletextDescriptor.cpp \
     QtsAbstractDescriptor.cpp \
     QtsPsiUtils.cpp \
@@ -68,6 +70,8 @@ SOURCES += \
     QtsTeletextCharset.cpp \
     QtsDvdTitleSet.cpp \
     QtsDvdDataPull.cpp \
+    QtsDvdReadAhead.cpp \
+    QtsDvdStreamScanner.cpp \
     QtsDvdMedia.cpp \
     QtsDvdDirectory.cpp \
     QtsDvdFile.cpp \
@@ -91,10 +95,13 @@ HEADERS += \
     QtsTableHandlerInterface.h \
     QtsTsPacket.h \
     QtsTsFile.h \
+    QtsMappedTsFile.h \
     QtsAbstractTable.h \
     QtsAbstractLongTable.h \
     QtsSectionDemux.h \
     QtsDemux.h \
+    QtsDemuxHub.h \
+    QtsPidContextTable.h \
     QtsAbstractDescriptor.h \
     QtsTeletextDescriptor.h \
     QtsPsiUtils.h \
@@ -118,6 +125,8 @@ HEADERS += \
     QtsDvdBandwidthReport.h \
     QtsDvdTitleSet.h \
     QtsDvdDataPull.h \
+    QtsDvdReadAhead.h \
+    QtsDvdStreamScanner.h \
     QtsDvdDirectory.h \
     QtsDvdFile.h \
     QtsDvdProgramChapter.h